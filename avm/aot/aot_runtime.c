@@ -0,0 +1,64 @@
+#include "aot_runtime.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/*
+ * Entry point of ahead-of-time compiled programs. The program's binary is
+ * embedded in it and loaded as the interpreter would load a .abc file, so
+ * the executors, constants and instruction operands are all the same; only
+ * dispatch is replaced, by one C function per user function and one for
+ * the top-level code.
+ */
+
+static aot_function* aotFunctions = NULL;
+static avm_vm* mainVm = NULL;
+
+static void
+aot_flushmain(void) {
+    if (mainVm) {
+        avm_flush(mainVm);
+    }
+}
+
+int main(int argc, char** argv) {
+    FILE* image = fmemopen((void*) aotImage, aotImageSize, "r");
+    if (!image) {
+        printf("Error opening the embedded binary.\n");
+        exit(1);
+    }
+
+    // the code runs as loaded, it is not dispatched
+    avm_vm* vm = avm_create(AVM_OPTION_NOFUSE | AVM_OPTION_NOJIT);
+    mainVm = vm;
+    atexit(aot_flushmain);
+    avm_loadimage(vm, image);
+    fclose(image);
+
+    aotFunctions = calloc(vm->codeSize, sizeof(aot_function));
+    if (!aotFunctions) {
+        printf("Error allocating memory for the compiled functions.\n");
+        exit(1);
+    }
+
+    aot_registerfunctions(aotFunctions);
+    aot_main(vm);
+    vm->executionFinished = 1;
+
+    mainVm = NULL;
+    avm_destroy(vm);
+    return 0;
+}
+
+// runs the user function that execute_call has just set pc to
+void
+aot_call(avm_vm* vm) {
+    aot_function f = aotFunctions[vm->pc];
+
+    if (!f) {
+        printf("AVM Error: No compiled function at %u.\n", vm->pc);
+        exit(1);
+    }
+
+    (*f)(vm);
+}
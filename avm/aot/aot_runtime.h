@@ -0,0 +1,58 @@
+#ifndef AOT_RUNTIME_H
+#define AOT_RUNTIME_H
+
+#include "../avm.h"
+#include "../executors/arithmetic.h"
+#include "../executors/assign.h"
+#include "../executors/equal.h"
+#include "../executors/relational.h"
+#include "../executors/function.h"
+#include "../tables/tables.h"
+
+/*
+ * Interface between the runtime library (libavmrt.a) and the C code that
+ * `acc --aot` generates for a program. The generated code keeps all VM
+ * state in the vm it is passed and calls the executors for anything its
+ * inline fast paths do not cover.
+ */
+
+typedef void (*aot_function)(avm_vm* vm);
+
+// defined by the generated program
+extern const char aotImage[];
+extern const unsigned aotImageSize;
+
+void
+aot_registerfunctions(aot_function* functions);
+
+void
+aot_main(avm_vm* vm);
+
+// defined by the runtime
+void
+aot_call(avm_vm* vm);
+
+#define AOT_ISPLAIN(m)          ((m)->type != string_m && (m)->type != table_m)
+#define AOT_ISNUMBER(m)         ((m)->type == number_m)
+#define AOT_ISCOPYABLE(m)       ((m)->type != string_m && (m)->type != undef_m)
+
+#define AOT_SETNUMBER(m, v)     ((m)->data.numVal = (v), (m)->type = number_m)
+#define AOT_SETBOOL(m, v)       ((m)->data.boolVal = (v), (m)->type = bool_m)
+#define AOT_SETNIL(m)           ((m)->type = nil_m)
+
+// these expect the vm in scope as vm
+#define AOT_CODE(i)             (&vm->code[i])
+#define AOT_GLOBAL(i)           (&vm->stack[AVM_STACKSIZE - 1 - (i)])
+#define AOT_LOCAL(i)            (&vm->stack[vm->topsp - (i)])
+#define AOT_FORMAL(i)           (&vm->stack[vm->topsp + AVM_STACKENV_SIZE + 1 + (i)])
+#define AOT_RETVAL              (&vm->retval)
+
+// library functions return at once, user functions with their funcexit
+#define AOT_CALL(i)                                                             \
+    vm->pc = (i);                                                               \
+    execute_call(vm, AOT_CODE(i));                                              \
+    if (vm->pc != (i) + 1) {                                                    \
+        aot_call(vm);                                                           \
+    }
+
+#endif
@@ -8,71 +8,287 @@
 #include "loader/loader.h"
 #include "memory/memory.h"
 #include "dispatcher/dispatcher.h"
+#include "superinstr/superinstr.h"
+#include "tables/shapes.h"
+#include "executors/function.h"
+#include "runner/runner.h"
+#include "coroutine/coroutine.h"
+#include "io/io.h"
+#include "output/output.h"
+#include "avm.h"
 
-#define consts_number(index)    loader_consts_getnumber(consts, index)
-#define consts_userfunc(index)  loader_consts_getuserfunc(consts, index)
-#define consts_libfunc(index)   loader_consts_getlibfunc(consts, index);
-#define consts_string(index)    loader_consts_getstring(consts, index)
-#define total_globals()         loader_getTotalGlobals(consts)
-static avm_constants* consts;
+#define consts_number(vm, index)    loader_consts_getnumber((vm)->consts, index)
+#define consts_userfunc(vm, index)  loader_consts_getuserfunc((vm)->consts, index)
+#define consts_libfunc(vm, index)   loader_consts_getlibfunc((vm)->consts, index);
+#define consts_string(vm, index)    loader_consts_getstring((vm)->consts, index)
+#define total_globals(vm)           loader_getTotalGlobals((vm)->consts)
 
-unsigned codeSize = 0;
-instruction* code = NULL;
+static void
+avm_prepare(avm_vm* vm);
+
+// the runtime library of ahead-of-time compiled programs has its own main
+#ifndef AVM_NO_MAIN
+static avm_vm* mainVm = NULL;
 
+// errors exit from anywhere, without losing what was printed before them
 static void
-loader_init(char* binFilename);
+avm_flushmain(void) {
+    if (mainVm) {
+        avm_flush(mainVm);
+    }
+}
 
 int main(int argc, char** argv) {
 
-    char* binFilename;
+    char* binFilename = NULL;
+    char* entry = NULL;
+    unsigned workers = 0;
+    unsigned options = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--profile") == 0) {
+            options |= AVM_OPTION_PROFILE;
+        }
+        else if (strcmp(argv[i], "--nojit") == 0) {
+            options |= AVM_OPTION_NOJIT;
+        }
+        else if (strcmp(argv[i], "--output") == 0 && i + 1 < argc) {
+            char* policy = argv[++i];
+            if (strcmp(policy, "line") == 0) {
+                options |= AVM_OPTION_OUTPUTLINE;
+            }
+            else if (strcmp(policy, "block") == 0) {
+                options |= AVM_OPTION_OUTPUTBLOCK;
+            }
+            else if (strcmp(policy, "explicit") == 0) {
+                options |= AVM_OPTION_OUTPUTEXPLICIT;
+            }
+            else {
+                printf("Unknown output policy '%s', expected line, block or explicit.\n", policy);
+                exit(1);
+            }
+        }
+        else if (strcmp(argv[i], "--writev") == 0) {
+            options |= AVM_OPTION_WRITEV;
+        }
+        else if (strcmp(argv[i], "--workers") == 0 && i + 1 < argc) {
+            workers = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--entry") == 0 && i + 1 < argc) {
+            entry = argv[++i];
+        }
+        else {
+            binFilename = argv[i];
+        }
+    }
 
-    if (argc <= 1) {
+    if (!binFilename) {
         printf("You must provide the path of the binary file.\n");
         exit(1);
     }
 
-    binFilename = argv[1];
-    
-    loader_init(binFilename);
-    memory_initstack(total_globals());
-    
-    while (!isExecutionFinished()) {
-        execute_cycle();
+    if (entry) {
+        runner_run(binFilename, entry, workers ? workers : 1, options, stdin, stdout);
+        return 0;
     }
 
+    avm_vm* vm = avm_create(options);
+    mainVm = vm;
+    atexit(avm_flushmain);
+    avm_load(vm, binFilename);
+    avm_run(vm);
+
+    if (options & AVM_OPTION_PROFILE) {
+        dispatcher_printProfile(vm, stderr);
+    }
+
+    mainVm = NULL;
+    avm_destroy(vm);
     return 0;
 }
+#endif
 
-static void
-loader_init(char* binFilename) {
-    consts   = loader_load_avm_constants(binFilename);
-    code     = loader_getcode(consts);
-    codeSize = loader_getcodeSize(consts);
+avm_vm*
+avm_create(unsigned options) {
+    avm_vm* vm = calloc(1, sizeof(avm_vm));
+
+    if (!vm) {
+        printf("Error allocating memory for the vm.\n");
+        exit(1);
+    }
+
+    vm->options = options;
+    return vm;
+}
+
+void
+avm_load(avm_vm* vm, char* binFilename) {
+    assert(!vm->consts);
+    vm->consts = loader_load_avm_constants(binFilename);
+    avm_prepare(vm);
+}
+
+void
+avm_loadimage(avm_vm* vm, FILE* image) {
+    assert(!vm->consts);
+    vm->consts = loader_read_avm_constants(image);
+    avm_prepare(vm);
+}
+
+avm_constants*
+avm_loadshared(char* binFilename) {
+    return loader_load_avm_constants(binFilename);
+}
+
+void
+avm_useshared(avm_vm* vm, avm_constants* image) {
+    assert(!vm->consts);
+    vm->consts = image;
+    vm->sharesConsts = 1;
+    avm_prepare(vm);
+}
+
+void
+avm_destroyshared(avm_constants* image) {
+    loader_destroy_avm_constants(image);
+}
+
+void
+avm_run(avm_vm* vm) {
+    while (!isExecutionFinished(vm)) {
+        execute_cycle(vm);
+    }
+}
+
+void
+avm_flush(avm_vm* vm) {
+    output_flush(vm);
+}
+
+void
+avm_destroy(avm_vm* vm) {
+    output_destroy(vm);
+    dispatcher_destroy(vm);
+    coroutine_destroy(vm);
+    io_destroy(vm);
+    memory_clearstack(vm);
+    shapes_destroy(vm);
+    free(vm->inlineCaches);
+
+    if (vm->sharesConsts) {
+        free(vm->code);
+    }
+    else if (vm->consts) {
+        loader_destroy_avm_constants(vm->consts);
+    }
+    free(vm);
+}
+
+unsigned
+avm_findfunction(avm_vm* vm, char* id) {
+    unsigned total = loader_getTotalUserFuncs(vm->consts);
+
+    for (unsigned i = 0; i < total; i++) {
+        userfunc f = consts_userfunc(vm, i);
+        if (strcmp(f.id, id) == 0) {
+            return f.address;
+        }
+    }
+    return AVM_NOFUNCTION;
+}
+
+void
+avm_pusharg(avm_vm* vm, avm_memcell* arg) {
+    function_pusharg(vm, arg);
+}
+
+void
+avm_pushnumber(avm_vm* vm, double num) {
+    avm_memcell arg;
+    arg.type = number_m;
+    arg.data.numVal = num;
+    function_pusharg(vm, &arg);
+}
+
+void
+avm_pushstring(avm_vm* vm, char* str) {
+    avm_memcell arg;
+    arg.type = string_m;
+    arg.data.strVal = str;
+    function_pusharg(vm, &arg);
+}
+
+// the function returns to codeSize, where the dispatcher stops
+void
+avm_call(avm_vm* vm, unsigned function) {
+    assert(function < vm->codeSize);
+
+    function_calluser(vm, function, vm->codeSize);
+    vm->executionFinished = 0;
+    avm_run(vm);
+}
+
+avm_memcell*
+avm_result(avm_vm* vm) {
+    return &vm->retval;
 }
 
-avm_memcell* avm_translate_operand(vmarg* arg, avm_memcell* reg) {
+unsigned
+avm_newcoroutine(avm_vm* vm, unsigned function) {
+    assert(function < vm->codeSize);
+    return coroutine_create(vm, function);
+}
+
+// back in the main context, the dispatcher stops at codeSize
+void
+avm_resume(avm_vm* vm, unsigned co, avm_memcell* value) {
+    assert(coroutine_getstatus(vm, COROUTINE_MAIN) == COROUTINE_RUNNING);
+
+    vm->pc = vm->codeSize;
+    coroutine_resume(vm, co, value);
+    coroutine_switch(vm);
+    vm->executionFinished = 0;
+    avm_run(vm);
+}
+
+unsigned char
+avm_isdead(avm_vm* vm, unsigned co) {
+    return coroutine_getstatus(vm, co) == COROUTINE_DEAD;
+}
+
+void
+avm_freecoroutine(avm_vm* vm, unsigned co) {
+    coroutine_release(vm, co);
+}
+
+avm_memcell* avm_translate_operand(avm_vm* vm, vmarg* arg, avm_memcell* reg) {
     switch (arg->type) {
         case global_a: {
-            return &stack[AVM_STACKSIZE - 1 - arg->val];
+            return &vm->stack[AVM_STACKSIZE - 1 - arg->val];
         }
         case local_a: {
-            return &stack[topsp - arg->val];
+            return &vm->stack[vm->topsp - arg->val];
         }
         case formal_a:  {
-            return &stack[topsp + AVM_STACKENV_SIZE + 1 + arg->val];
+            return &vm->stack[vm->topsp + AVM_STACKENV_SIZE + 1 + arg->val];
         }
         case retval_a: {
-            return &retval;
+            return &vm->retval;
         }
         case number_a: {
             reg->type = number_m;
-            reg->data.numVal = consts_number(arg->val);
+            reg->data.numVal = consts_number(vm, arg->val);
+            return reg;
+        }
+        case immnumber_a: {
+            reg->type = number_m;
+            reg->data.numVal = (double) (int) arg->val;
             return reg;
         }
         case string_a: {
             reg->type = string_m;
-            reg->data.strVal = strdup(consts_string(arg->val));
-            break;
+            reg->data.strVal = strdup(consts_string(vm, arg->val));
+            return reg;
         }
         case bool_a: {
             reg->type = bool_m;
@@ -84,26 +300,34 @@ avm_memcell* avm_translate_operand(vmarg* arg, avm_memcell* reg) {
             return reg;
         }
         case userfunc_a: {
-            userfunc f = consts_userfunc(arg->val);
+            userfunc f = consts_userfunc(vm, arg->val);
             reg->type = userfunc_m;
             reg->data.funcVal = f.address;
-            break;
+            return reg;
         }
         case libfunc_a: {
             reg->type = libfunc_m;
-            reg->data.libfuncVal = consts_libfunc(arg->val);
+            reg->data.libfuncVal = consts_libfunc(vm, arg->val);
             return reg;
         }
         default: assert(0);
     }
 }
 
-userfunc avm_getfuncinfo(unsigned i) {
-    return consts_userfunc(i);
+userfunc avm_getfuncinfo(avm_vm* vm, unsigned i) {
+    return consts_userfunc(vm, i);
+}
+
+double avm_getnumber(avm_vm* vm, unsigned i) {
+    return consts_number(vm, i);
+}
+
+char* avm_getstring(avm_vm* vm, unsigned i) {
+    return consts_string(vm, i);
 }
 
 void
-avm_assign(avm_memcell* lv, avm_memcell* rv) {
+avm_assign(avm_vm* vm, avm_memcell* lv, avm_memcell* rv) {
     if (lv == rv) {
         return;
     }
@@ -111,7 +335,7 @@ avm_assign(avm_memcell* lv, avm_memcell* rv) {
     // table checks
 
     if (rv->type == undef_m) {
-        avm_warning("Assigning from undef content!");
+        avm_warning(vm, "Assigning from undef content!");
     }
 
     avm_memcellclear(lv);
@@ -126,6 +350,42 @@ avm_assign(avm_memcell* lv, avm_memcell* rv) {
     }
 }
 
-void avm_warning(char* str) {
+// print's buffered output comes before the warning, which is written out at once
+void avm_warning(avm_vm* vm, char* str) {
+    output_flush(vm);
     printf("AVM Warining: %s\n", str);
-}
\ No newline at end of file
+    fflush(stdout);
+}
+
+/* ------------------------------------------- Static Definitions ------------------------------------------- */
+
+// the code is only rewritten when not profiling, the pair counts are what fusion is based on
+static void
+avm_prepare(avm_vm* vm) {
+    vm->code = loader_getcode(vm->consts);
+    vm->codeSize = loader_getcodeSize(vm->consts);
+
+    // fusion, quickening and deopts write to the code
+    if (vm->sharesConsts) {
+        instruction* code = malloc(vm->codeSize * sizeof(instruction));
+        if (!code) {
+            printf("Error allocating memory for the code.\n");
+            exit(1);
+        }
+        vm->code = memcpy(code, vm->code, vm->codeSize * sizeof(instruction));
+    }
+    memory_initstack(vm, total_globals(vm));
+
+    if (vm->options & AVM_OPTION_PROFILE) {
+        dispatcher_enableProfiling(vm);
+    }
+    else {
+        if (!(vm->options & AVM_OPTION_NOFUSE)) {
+            superinstr_fuse(vm->code, vm->codeSize);
+        }
+
+        if (!(vm->options & AVM_OPTION_NOJIT)) {
+            dispatcher_enableJit(vm);
+        }
+    }
+}
@@ -0,0 +1,99 @@
+#ifndef AVM_H
+#define AVM_H
+
+#include "avm_types.h"
+
+#include <stdio.h>
+
+#define AVM_OPTION_PROFILE  1   // count opcode pairs, and leave the code unfused
+#define AVM_OPTION_NOJIT    2
+#define AVM_OPTION_NOFUSE   4   // run the code as loaded, without superinstructions
+
+// flush policy of print, see output/output.h, chosen by the terminal without one
+#define AVM_OPTION_OUTPUTLINE       8
+#define AVM_OPTION_OUTPUTBLOCK      16
+#define AVM_OPTION_OUTPUTEXPLICIT   32
+#define AVM_OPTION_WRITEV           64
+
+/*
+ * Lifetime of a vm: create it, load one program into it, run it, destroy
+ * it. Vms share nothing, so each can run on its own thread.
+ */
+avm_vm*
+avm_create(unsigned options);
+
+void
+avm_load(avm_vm* vm, char* binFilename);
+
+void
+avm_loadimage(avm_vm* vm, FILE* image);
+
+/*
+ * A program loaded once for several vms. The image is only read; each vm
+ * rewrites its own copy of the code, and the image must outlive them.
+ */
+struct avm_constants*
+avm_loadshared(char* binFilename);
+
+void
+avm_useshared(avm_vm* vm, struct avm_constants* image);
+
+void
+avm_destroyshared(struct avm_constants* image);
+
+void
+avm_run(avm_vm* vm);
+
+// writes out what print has buffered
+void
+avm_flush(avm_vm* vm);
+
+void
+avm_destroy(avm_vm* vm);
+
+/*
+ * Calling into a loaded program. Run it first when its functions use
+ * globals the top-level code sets. A call pushes its arguments, last to
+ * first as compiled calls do, then runs the function to its funcexit and
+ * leaves what it returned in avm_result until the next call.
+ */
+#define AVM_NOFUNCTION  ((unsigned) -1)
+
+// address of the first user function named id, or AVM_NOFUNCTION
+unsigned
+avm_findfunction(avm_vm* vm, char* id);
+
+void
+avm_pusharg(avm_vm* vm, avm_memcell* arg);
+
+void
+avm_pushnumber(avm_vm* vm, double num);
+
+void
+avm_pushstring(avm_vm* vm, char* str);
+
+void
+avm_call(avm_vm* vm, unsigned function);
+
+avm_memcell*
+avm_result(avm_vm* vm);
+
+/*
+ * Coroutines, which the program itself makes with coroutine(f). The host
+ * resumes them from the main context only: a resume runs the coroutine
+ * until it yields or returns, leaving the value in avm_result.
+ */
+unsigned
+avm_newcoroutine(avm_vm* vm, unsigned function);
+
+void
+avm_resume(avm_vm* vm, unsigned co, avm_memcell* value);
+
+unsigned char
+avm_isdead(avm_vm* vm, unsigned co);
+
+// lets a dead coroutine's handle be reused
+void
+avm_freecoroutine(avm_vm* vm, unsigned co);
+
+#endif
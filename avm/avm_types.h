@@ -10,6 +10,18 @@ typedef enum {
     jgt_v,          call_v,         pusharg_v,
     funcenter_v,    funcexit_v,     newtable_v,
     tablegetelem_v, tablesetelem_v, nop_v,
+
+    // superinstructions, only created by the load-time fusion pass
+    arithassign_v,  assignarith_v,  assignassign_v,
+    assignjump_v,   jcondjump_v,    pushargcall_v,
+    tablegetelemcall_v,
+
+    // quickened instructions, rewritten in place the first time they run
+    add_nn_v,       sub_nn_v,       mul_nn_v,
+    div_nn_v,       mod_nn_v,       jle_nn_v,
+    jge_nn_v,       jlt_nn_v,       jgt_nn_v,
+    jeq_nn_v,       jne_nn_v,       jeq_ss_v,
+    jne_ss_v,
 } vmopcode;
 
 typedef enum {
@@ -24,6 +36,7 @@ typedef enum {
     userfunc_a,
     libfunc_a,
     retval_a,
+    immnumber_a,
     notype_a,
 } vmarg_t;
 
@@ -38,6 +51,8 @@ typedef struct instruction {
     vmarg arg1;
     vmarg arg2;
     unsigned srcLine;
+    vmopcode origOpcode;    // opcode as loaded, before any rewriting
+    unsigned char deopts;   // times a quickened opcode fell back to origOpcode
 } instruction;
 
 typedef struct userfunc {
@@ -73,35 +88,61 @@ typedef struct avm_memcell {
 
 
 
-// avm
-extern unsigned         codeSize;
-extern instruction*     code;
-
-extern avm_memcell* avm_translate_operand(vmarg* arg, avm_memcell* reg);
-
-extern void avm_warning(char* str);
-extern userfunc avm_getfuncinfo(unsigned i);
-extern void avm_assign(avm_memcell* lv, avm_memcell* rv);
-
 // memory
 #define AVM_STACKENV_SIZE   4
 #define AVM_STACKSIZE       4094
 #define N                   AVM_STACKSIZE
 
-extern avm_memcell stack[AVM_STACKSIZE];
-extern avm_memcell   ax, bx, cx;
-extern avm_memcell   retval;
-extern unsigned top, topsp;
+/*
+ * Everything a running program owns. The loader, the dispatcher, the
+ * executors, the libfuncs and the tables get the vm they work on, so any
+ * number of vms can run in one process, each on one thread at a time.
+ * Subsystem state is opaque here and NULL until that subsystem is used.
+ */
+typedef struct avm_vm {
+    unsigned options;
+    struct avm_constants* consts;
+    unsigned char sharesConsts; // consts belong to a shared image, code is the vm's own copy
+    instruction* code;
+    unsigned codeSize;
+
+    avm_memcell stack[AVM_STACKSIZE];
+    avm_memcell ax, bx, cx;
+    avm_memcell retval;
+    unsigned top, topsp;
+    unsigned totalActuals;
+
+    unsigned pc;
+    unsigned char branched;     // a jump set pc, which may be to the instruction that ran
+    unsigned char executionFinished;
+
+    struct avm_table_cache* inlineCaches;
+    struct avm_shape* shapeRoot;
+    unsigned nextLayoutId;
+
+    struct dispatcher_profile* profile;
+    unsigned char jitEnabled;
+    void** jitEntries;          // native code of each compiled instruction, indexed by pc
+    struct jit_state* jit;
+    struct trace_state* trace;
+
+    struct coroutine_state* coroutines;
+    struct io_state* io;
+    struct output_state* output;
+} avm_vm;
 
-extern void avm_memcellclear(avm_memcell* m);
+// avm
+extern avm_memcell* avm_translate_operand(avm_vm* vm, vmarg* arg, avm_memcell* reg);
 
-// dispatcher
-#define AVM_ENDING_PC           codeSize
-#define AVM_MAX_INSTRUCTIONS    (unsigned) nop_v
+extern void avm_warning(avm_vm* vm, char* str);
+extern userfunc avm_getfuncinfo(avm_vm* vm, unsigned i);
+extern double avm_getnumber(avm_vm* vm, unsigned i);
+extern char* avm_getstring(avm_vm* vm, unsigned i);
+extern void avm_assign(avm_vm* vm, avm_memcell* lv, avm_memcell* rv);
 
-extern void registerlibfuncs();
+extern void avm_memcellclear(avm_memcell* m);
 
-extern unsigned char    executionFinished;
-extern unsigned         pc;
+// dispatcher
+#define AVM_MAX_INSTRUCTIONS    (unsigned) jne_ss_v
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,296 @@
+#include "coroutine.h"
+#include "../loader/loader.h"
+#include "../executors/function.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * Coroutines are execution contexts of a vm: a pc, top, topsp and the part
+ * of the stack below the globals. All of them run on the vm's one stack,
+ * so globals, operand addresses and JIT code stay the same; a switch saves
+ * the running context's cells, from top up to the globals, and copies the
+ * resumed one's back in. Switches cost a copy of the live frames, and the
+ * dispatcher and the JIT, which both read pc, top and topsp from the vm,
+ * see nothing but a call returning somewhere else.
+ *
+ * Context 0 is the main one, that the top-level code and host calls run
+ * in. A coroutine starts as a call to its function with the first value it
+ * is resumed with, and the function returns to codeSize, where the
+ * dispatcher hands control back to its resumer.
+ */
+
+typedef struct coroutine {
+    coroutine_status status;
+    unsigned function;
+    unsigned char started;
+    unsigned resumer;
+    unsigned nextReleased;
+
+    unsigned pc, top, topsp, totalActuals;
+    avm_memcell* stack;         // saved cells, from top + 1 up to the globals
+    unsigned stackSize, stackCapacity;
+} coroutine;
+
+typedef struct coroutine_state {
+    coroutine* all;
+    unsigned total, size;
+    unsigned released;          // first reusable handle, 0 for none
+
+    unsigned base;              // the cell right below the globals
+    unsigned current;
+    unsigned pending;
+    unsigned char switching;
+} coroutine_state;
+
+/* ------------------------------------------- Static Declarations ------------------------------------------- */
+static coroutine_state*
+coroutine_state_get(avm_vm* vm);
+
+static unsigned char
+coroutine_isvalid(coroutine_state* state, unsigned co);
+
+static void
+coroutine_save(avm_vm* vm, coroutine* co);
+
+static void
+coroutine_restore(avm_vm* vm, coroutine* co);
+
+static void
+coroutine_freestack(coroutine* co);
+
+/* ------------------------------------------- Implementation ------------------------------------------- */
+unsigned
+coroutine_create(avm_vm* vm, unsigned function) {
+    coroutine_state* state = coroutine_state_get(vm);
+    unsigned co = state->released;
+
+    if (co) {
+        state->released = state->all[co].nextReleased;
+    }
+    else {
+        if (state->total == state->size) {
+            state->size *= 2;
+            state->all = realloc(state->all, state->size * sizeof(coroutine));
+            if (!state->all) {
+                printf("Error allocating memory for the coroutines.\n");
+                exit(1);
+            }
+        }
+        co = state->total++;
+    }
+
+    memset(&state->all[co], 0, sizeof(coroutine));
+    state->all[co].status = COROUTINE_SUSPENDED;
+    state->all[co].function = function;
+    return co;
+}
+
+void
+coroutine_release(avm_vm* vm, unsigned co) {
+    coroutine_state* state = vm->coroutines;
+
+    if (coroutine_isvalid(state, co) && state->all[co].status == COROUTINE_DEAD) {
+        coroutine_freestack(&state->all[co]);
+        state->all[co].nextReleased = state->released;
+        state->released = co;
+    }
+}
+
+coroutine_status
+coroutine_getstatus(avm_vm* vm, unsigned co) {
+    coroutine_state* state = vm->coroutines;
+
+    if (co == COROUTINE_MAIN) {
+        return state ? state->all[co].status : COROUTINE_RUNNING;
+    }
+    return coroutine_isvalid(state, co) ? state->all[co].status : COROUTINE_DEAD;
+}
+
+unsigned
+coroutine_current(avm_vm* vm) {
+    return vm->coroutines ? vm->coroutines->current : COROUTINE_MAIN;
+}
+
+unsigned
+coroutine_getresumer(avm_vm* vm, unsigned co) {
+    return coroutine_isvalid(vm->coroutines, co) ? vm->coroutines->all[co].resumer : COROUTINE_MAIN;
+}
+
+void
+coroutine_resume(avm_vm* vm, unsigned co, avm_memcell* value) {
+    coroutine_state* state = vm->coroutines;
+
+    if (!coroutine_isvalid(state, co) || state->all[co].status != COROUTINE_SUSPENDED || state->switching) {
+        avm_warning(vm, "Resuming a coroutine that is not suspended!");
+        avm_memcellclear(&vm->retval);
+        vm->retval.type = nil_m;
+        return;
+    }
+
+    avm_assign(vm, &vm->retval, value);
+    state->all[co].resumer = state->current;
+    state->all[state->current].status = COROUTINE_NORMAL;
+    state->all[co].status = COROUTINE_RUNNING;
+    state->pending = co;
+    state->switching = 1;
+}
+
+void
+coroutine_yield(avm_vm* vm, avm_memcell* value) {
+    coroutine_state* state = vm->coroutines;
+
+    if (!state || state->current == COROUTINE_MAIN || state->switching) {
+        avm_warning(vm, "Yielding outside of a coroutine!");
+        avm_memcellclear(&vm->retval);
+        vm->retval.type = nil_m;
+        return;
+    }
+
+    coroutine* current = &state->all[state->current];
+    avm_assign(vm, &vm->retval, value);
+    current->status = COROUTINE_SUSPENDED;
+    state->all[current->resumer].status = COROUTINE_RUNNING;
+    state->pending = current->resumer;
+    state->switching = 1;
+}
+
+void
+coroutine_switch(avm_vm* vm) {
+    coroutine_state* state = vm->coroutines;
+
+    if (!state || !state->switching) {
+        return;
+    }
+
+    coroutine* from = &state->all[state->current];
+    coroutine* to = &state->all[state->pending];
+    state->switching = 0;
+
+    coroutine_save(vm, from);
+    if (from->status == COROUTINE_DEAD) {
+        coroutine_freestack(from);
+    }
+
+    state->current = state->pending;
+    coroutine_restore(vm, to);
+}
+
+unsigned char
+coroutine_returned(avm_vm* vm) {
+    coroutine_state* state = vm->coroutines;
+
+    if (!state || state->current == COROUTINE_MAIN) {
+        return 0;
+    }
+
+    // retval still holds what the function returned
+    coroutine* current = &state->all[state->current];
+    current->status = COROUTINE_DEAD;
+    state->all[current->resumer].status = COROUTINE_RUNNING;
+    state->pending = current->resumer;
+    state->switching = 1;
+    coroutine_switch(vm);
+    return 1;
+}
+
+void
+coroutine_destroy(avm_vm* vm) {
+    coroutine_state* state = vm->coroutines;
+
+    if (!state) {
+        return;
+    }
+    for (unsigned i = 0; i < state->total; i++) {
+        coroutine_freestack(&state->all[i]);
+    }
+    free(state->all);
+    free(state);
+    vm->coroutines = NULL;
+}
+
+/* ------------------------------------------- Static Definitions ------------------------------------------- */
+static coroutine_state*
+coroutine_state_get(avm_vm* vm) {
+    if (!vm->coroutines) {
+        coroutine_state* state = calloc(1, sizeof(coroutine_state));
+
+        if (!state || !(state->all = calloc(16, sizeof(coroutine)))) {
+            printf("Error allocating memory for the coroutines.\n");
+            exit(1);
+        }
+
+        state->size = 16;
+        state->total = 1;
+        state->all[COROUTINE_MAIN].status = COROUTINE_RUNNING;
+        state->all[COROUTINE_MAIN].started = 1;
+        state->base = AVM_STACKSIZE - 1 - loader_getTotalGlobals(vm->consts);
+        state->current = COROUTINE_MAIN;
+        vm->coroutines = state;
+    }
+    return vm->coroutines;
+}
+
+static unsigned char
+coroutine_isvalid(coroutine_state* state, unsigned co) {
+    return state && co != COROUTINE_MAIN && co < state->total;
+}
+
+// moves the live cells out, leaving undef behind without freeing what they hold
+static void
+coroutine_save(avm_vm* vm, coroutine* co) {
+    unsigned size = vm->coroutines->base - vm->top;
+
+    co->pc = vm->pc;
+    co->top = vm->top;
+    co->topsp = vm->topsp;
+    co->totalActuals = vm->totalActuals;
+
+    if (size > co->stackCapacity) {
+        co->stack = realloc(co->stack, size * sizeof(avm_memcell));
+        if (!co->stack) {
+            printf("Error allocating memory for a coroutine stack.\n");
+            exit(1);
+        }
+        co->stackCapacity = size;
+    }
+    memcpy(co->stack, &vm->stack[vm->top + 1], size * sizeof(avm_memcell));
+    co->stackSize = size;
+
+    for (unsigned i = vm->top + 1; i <= vm->coroutines->base; i++) {
+        vm->stack[i].type = undef_m;
+    }
+}
+
+static void
+coroutine_restore(avm_vm* vm, coroutine* co) {
+    if (!co->started) {
+        // the first value it is resumed with is in retval
+        co->started = 1;
+        vm->top = vm->coroutines->base;
+        vm->topsp = 0;
+        vm->totalActuals = 0;
+        function_pusharg(vm, &vm->retval);
+        function_calluser(vm, co->function, vm->codeSize);
+        return;
+    }
+
+    memcpy(&vm->stack[co->top + 1], co->stack, co->stackSize * sizeof(avm_memcell));
+    co->stackSize = 0;
+
+    vm->pc = co->pc;
+    vm->top = co->top;
+    vm->topsp = co->topsp;
+    vm->totalActuals = co->totalActuals;
+}
+
+static void
+coroutine_freestack(coroutine* co) {
+    for (unsigned i = 0; i < co->stackSize; i++) {
+        avm_memcellclear(&co->stack[i]);
+    }
+    free(co->stack);
+    co->stack = NULL;
+    co->stackSize = co->stackCapacity = 0;
+}
@@ -0,0 +1,51 @@
+#ifndef COROUTINE_H
+#define COROUTINE_H
+
+#include "../avm_types.h"
+
+#define COROUTINE_MAIN  0   // the context the program and host calls run in
+
+typedef enum coroutine_status {
+    COROUTINE_SUSPENDED,
+    COROUTINE_RUNNING,
+    COROUTINE_NORMAL,       // resumed another coroutine and waits for it
+    COROUTINE_DEAD
+} coroutine_status;
+
+unsigned
+coroutine_create(avm_vm* vm, unsigned function);
+
+// drops a dead coroutine, whose handle can then be reused
+void
+coroutine_release(avm_vm* vm, unsigned co);
+
+coroutine_status
+coroutine_getstatus(avm_vm* vm, unsigned co);
+
+unsigned
+coroutine_current(avm_vm* vm);
+
+unsigned
+coroutine_getresumer(avm_vm* vm, unsigned co);
+
+/*
+ * Resuming and yielding only set up a switch, with value in retval; the
+ * switch itself happens once the calling libfunc has returned.
+ */
+void
+coroutine_resume(avm_vm* vm, unsigned co, avm_memcell* value);
+
+void
+coroutine_yield(avm_vm* vm, avm_memcell* value);
+
+void
+coroutine_switch(avm_vm* vm);
+
+// a coroutine's function returned to codeSize, to its resumer
+unsigned char
+coroutine_returned(avm_vm* vm);
+
+void
+coroutine_destroy(avm_vm* vm);
+
+#endif
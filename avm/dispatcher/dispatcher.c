@@ -6,6 +6,10 @@
 #include "../executors/assign.h"
 #include "../executors/equal.h"
 #include "../executors/function.h"
+#include "../executors/fused.h"
+#include "../loader/loader.h"
+#include "../jit/jit.h"
+#include "../coroutine/coroutine.h"
 
 #include "../tables/tables.h"
 
@@ -14,15 +18,30 @@
 #include <assert.h>
 
 static void
-execute_nop(instruction* instr);
+execute_nop(avm_vm* vm, instruction* instr);
 
 static void
-execute_jump(instruction* instr);
+execute_jump(avm_vm* vm, instruction* instr);
 
-typedef void (*execute_func_t)(instruction*);
+static int
+compare_pairs(const void* a, const void* b);
 
-unsigned char executionFinished = 0;
-unsigned pc = 0;
+typedef void (*execute_func_t)(avm_vm*, instruction*);
+
+#define TOTAL_OPCODES   (AVM_MAX_INSTRUCTIONS + 1)
+#define PROFILE_TOP     20
+
+typedef struct opcode_pair {
+    vmopcode first;
+    vmopcode second;
+    unsigned long count;
+} opcode_pair;
+
+typedef struct dispatcher_profile {
+    unsigned long pairCounts[TOTAL_OPCODES][TOTAL_OPCODES];
+    unsigned long totalDispatches;
+    vmopcode prevOpcode;
+} dispatcher_profile;
 
 #define execute_add execute_arithmetic
 #define execute_sub execute_arithmetic
@@ -59,42 +78,168 @@ execute_func_t executeFuncs[] = {
     execute_funcexit,
     execute_newtable,
     execute_tablegetelem,
-    execute_tablesetelem
+    execute_tablesetelem,
+    execute_nop,
+    execute_arithassign,
+    execute_assignarith,
+    execute_assignassign,
+    execute_assignjump,
+    execute_jcondjump,
+    execute_pushargcall,
+    execute_tablegetelemcall,
+    execute_add_nn,
+    execute_sub_nn,
+    execute_mul_nn,
+    execute_div_nn,
+    execute_mod_nn,
+    execute_jle_nn,
+    execute_jge_nn,
+    execute_jlt_nn,
+    execute_jgt_nn,
+    execute_jeq_nn,
+    execute_jne_nn,
+    execute_jeq_ss,
+    execute_jne_ss
 };
 
 void
-execute_cycle() {
-    if (executionFinished) {
+execute_cycle(avm_vm* vm) {
+    if (vm->executionFinished) {
         return;
     }
-    else if (pc == AVM_ENDING_PC) {
-        executionFinished = 1;
+    else if (vm->pc == vm->codeSize) {
+        // a coroutine returning ends itself, not the program
+        if (!coroutine_returned(vm)) {
+            vm->executionFinished = 1;
+        }
         return;
     }
     else {
-        assert(pc < AVM_ENDING_PC);
-        instruction* instr = code + pc;
+        assert(vm->pc < vm->codeSize);
+        instruction* instr = vm->code + vm->pc;
         assert(instr->opcode >= 0 && instr->opcode <= AVM_MAX_INSTRUCTIONS);
-        unsigned oldPc = pc;
-        (*executeFuncs[instr->opcode])(instr);
-        if (pc == oldPc) {
-            ++pc;
+        unsigned char recording = 0;
+        if (vm->jitEnabled) {
+            recording = trace_isrecording(vm);
+            if (recording) {
+                trace_record(vm, vm->pc);
+            }
+            else if (vm->jitEntries[vm->pc]) {
+                jit_run(vm, vm->jitEntries[vm->pc]);
+                return;
+            }
+            if (instr->origOpcode == funcenter_v) {
+                jit_countcall(vm, vm->pc);
+            }
+        }
+        unsigned oldPc = vm->pc;
+        if (vm->profile) {
+            dispatcher_profile* profile = vm->profile;
+            profile->pairCounts[profile->prevOpcode][instr->origOpcode]++;
+            profile->prevOpcode = instr->origOpcode;
+            profile->totalDispatches++;
+        }
+        // a trace records the loaded instructions one at a time
+        (*executeFuncs[recording ? instr->origOpcode : instr->opcode])(vm, instr);
+        // a jump to the instruction itself leaves pc as it was, but is not a fall through
+        if (vm->pc == oldPc && !vm->branched) {
+            ++vm->pc;
+        }
+        vm->branched = 0;
+        if (recording) {
+            trace_recorded(vm, vm->pc);
+        }
+        else if (vm->jitEnabled && vm->pc < oldPc) {
+            trace_countloop(vm, oldPc, vm->pc);
         }
     }
 }
 
 unsigned char
-isExecutionFinished() {
-    return executionFinished;
+isExecutionFinished(avm_vm* vm) {
+    return vm->executionFinished;
+}
+
+void
+dispatcher_enableProfiling(avm_vm* vm) {
+    vm->profile = calloc(1, sizeof(dispatcher_profile));
+
+    if (!vm->profile) {
+        printf("Error allocating memory for the profile.\n");
+        exit(1);
+    }
+    vm->profile->prevOpcode = nop_v;
+}
+
+void
+dispatcher_enableJit(avm_vm* vm) {
+    vm->jitEnabled = jit_init(vm);
+
+    if (vm->jitEnabled) {
+        trace_init(vm);
+    }
+}
+
+void
+dispatcher_destroy(avm_vm* vm) {
+    free(vm->profile);
+    vm->profile = NULL;
+
+    if (vm->jitEnabled) {
+        trace_destroy(vm);
+        jit_destroy(vm);
+        vm->jitEnabled = 0;
+    }
+}
+
+void
+dispatcher_printProfile(avm_vm* vm, FILE* out) {
+    opcode_pair pairs[TOTAL_OPCODES * TOTAL_OPCODES];
+    unsigned totalPairs = 0;
+
+    for (unsigned i = 0; i < TOTAL_OPCODES; i++) {
+        for (unsigned j = 0; j < TOTAL_OPCODES; j++) {
+            if (vm->profile->pairCounts[i][j]) {
+                pairs[totalPairs].first = i;
+                pairs[totalPairs].second = j;
+                pairs[totalPairs].count = vm->profile->pairCounts[i][j];
+                totalPairs++;
+            }
+        }
+    }
+
+    qsort(pairs, totalPairs, sizeof(opcode_pair), compare_pairs);
+
+    fprintf(out, "---------------------------------------------OPCODE PAIRS---------------------------------------------\n");
+    fprintf(out, "%-20s %-20s %-15s %-10s\n", "first", "second", "count", "%");
+    fprintf(out, "---------------------------------------------------------------------------------------------------------\n");
+
+    for (unsigned i = 0; i < totalPairs && i < PROFILE_TOP; i++) {
+        fprintf(out, "%-20s %-20s %-15lu %-10.2f\n",
+            loader_vmopcodeToString(pairs[i].first),
+            loader_vmopcodeToString(pairs[i].second),
+            pairs[i].count,
+            100.0 * pairs[i].count / vm->profile->totalDispatches
+        );
+    }
+    fprintf(out, "\nTotal dispatches: %lu\n", vm->profile->totalDispatches);
+}
+
+static int
+compare_pairs(const void* a, const void* b) {
+    unsigned long c1 = ((const opcode_pair*) a)->count;
+    unsigned long c2 = ((const opcode_pair*) b)->count;
+    return (c1 < c2) - (c1 > c2);
 }
 
 static void
-execute_nop(instruction* instr) {
+execute_nop(avm_vm* vm, instruction* instr) {
     return;
 }
 
 static void
-execute_jump(instruction* instr) {
+execute_jump(avm_vm* vm, instruction* instr) {
     assert(instr->result.type == label_a);
-    pc = instr->result.val;
+    vm->pc = instr->result.val;
+    vm->branched = 1;
 }
\ No newline at end of file
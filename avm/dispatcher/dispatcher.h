@@ -1,10 +1,26 @@
 #ifndef DISPATCHER_H
 #define DISPATCHER_H
 
+#include "../avm_types.h"
+
+#include <stdio.h>
+
 void
-execute_cycle();
+execute_cycle(avm_vm* vm);
 
 unsigned char
-isExecutionFinished();
+isExecutionFinished(avm_vm* vm);
+
+void
+dispatcher_enableProfiling(avm_vm* vm);
+
+void
+dispatcher_enableJit(avm_vm* vm);
+
+void
+dispatcher_printProfile(avm_vm* vm, FILE* out);
+
+void
+dispatcher_destroy(avm_vm* vm);
 
 #endif
\ No newline at end of file
@@ -1,5 +1,7 @@
 #include "arithmetic.h"
 
+#include "../quicken/quicken.h"
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <assert.h>
@@ -20,13 +22,55 @@ arithmetic_func_t arithmeticFuncs[] = {
     mod_impl
 };
 
+vmopcode arithmeticQuickOpcodes[] = {
+    add_nn_v,
+    sub_nn_v,
+    mul_nn_v,
+    div_nn_v,
+    mod_nn_v
+};
+
+/*
+ * Quickened arithmetic: both operands were numbers the last time the
+ * instruction ran. The impl call is direct, so it is inlined.
+ */
+#define DEFINE_QUICK_ARITHMETIC(name)                                           \
+void                                                                            \
+execute_##name##_nn(avm_vm* vm, instruction* instr) {                           \
+    avm_memcell* lv = avm_translate_operand(vm, &instr->result, NULL);          \
+    avm_memcell* rv1 = avm_translate_operand(vm, &instr->arg1, &vm->ax);        \
+    avm_memcell* rv2 = avm_translate_operand(vm, &instr->arg2, &vm->bx);        \
+                                                                                \
+    if (rv1->type != number_m || rv2->type != number_m) {                       \
+        quicken_deoptimize(instr);                                              \
+        execute_arithmetic(vm, instr);                                          \
+        return;                                                                 \
+    }                                                                           \
+                                                                                \
+    double result = name##_impl(rv1->data.numVal, rv2->data.numVal);            \
+    avm_memcellclear(lv);                                                       \
+    lv->type = number_m;                                                        \
+    lv->data.numVal = result;                                                   \
+}
+
+DEFINE_QUICK_ARITHMETIC(add)
+DEFINE_QUICK_ARITHMETIC(sub)
+DEFINE_QUICK_ARITHMETIC(mul)
+DEFINE_QUICK_ARITHMETIC(div)
+DEFINE_QUICK_ARITHMETIC(mod)
+
+void
+execute_arithmetic(avm_vm* vm, instruction* instr) {
+    arithmetic_eval(vm, instr, instr->origOpcode);
+}
+
 void
-execute_arithmetic(instruction* instr) {
-    avm_memcell* lv = avm_translate_operand(&instr->result, NULL);
-    avm_memcell* rv1 = avm_translate_operand(&instr->arg1, &ax);
-    avm_memcell* rv2 = avm_translate_operand(&instr->arg2, &bx);
+arithmetic_eval(avm_vm* vm, instruction* instr, vmopcode opcode) {
+    avm_memcell* lv = avm_translate_operand(vm, &instr->result, NULL);
+    avm_memcell* rv1 = avm_translate_operand(vm, &instr->arg1, &vm->ax);
+    avm_memcell* rv2 = avm_translate_operand(vm, &instr->arg2, &vm->bx);
 
-    assert(lv && (&stack[N - 1] >= lv && lv > &stack[top]) || lv == &retval);
+    assert(lv && (&vm->stack[N - 1] >= lv && lv > &vm->stack[vm->top]) || lv == &vm->retval);
     assert(rv1 && rv2);
 
     if (rv1->type != number_m || rv2->type != number_m) {
@@ -34,8 +78,11 @@ execute_arithmetic(instruction* instr) {
         exit(1);
     }
 
-    arithmetic_func_t op = arithmeticFuncs[instr->opcode - add_v];
+    arithmetic_func_t op = arithmeticFuncs[opcode - add_v];
+    double result = (*op)(rv1->data.numVal, rv2->data.numVal);
     avm_memcellclear(lv);
     lv->type = number_m;
-    lv->data.numVal = (*op)(rv1->data.numVal, rv2->data.numVal);
-}
\ No newline at end of file
+    lv->data.numVal = result;
+
+    quicken_rewrite(instr, arithmeticQuickOpcodes[opcode - add_v]);
+}
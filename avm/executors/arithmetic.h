@@ -4,6 +4,24 @@
 #include "../avm_types.h"
 
 void
-execute_arithmetic(instruction* instr);
+execute_arithmetic(avm_vm* vm, instruction* instr);
+
+void
+arithmetic_eval(avm_vm* vm, instruction* instr, vmopcode opcode);
+
+void
+execute_add_nn(avm_vm* vm, instruction* instr);
+
+void
+execute_sub_nn(avm_vm* vm, instruction* instr);
+
+void
+execute_mul_nn(avm_vm* vm, instruction* instr);
+
+void
+execute_div_nn(avm_vm* vm, instruction* instr);
+
+void
+execute_mod_nn(avm_vm* vm, instruction* instr);
 
 #endif
\ No newline at end of file
@@ -5,12 +5,12 @@
 #include <string.h>
 
 void
-execute_assign(instruction* instr) {
-    avm_memcell* lv = avm_translate_operand(&instr->result, NULL);
-    avm_memcell* rv = avm_translate_operand(&instr->arg1, &ax);
+execute_assign(avm_vm* vm, instruction* instr) {
+    avm_memcell* lv = avm_translate_operand(vm, &instr->result, NULL);
+    avm_memcell* rv = avm_translate_operand(vm, &instr->arg1, &vm->ax);
     
-    assert(lv && (&stack[N - 1] >= lv && lv > &stack[top] || lv == &retval));
+    assert(lv && (&vm->stack[N - 1] >= lv && lv > &vm->stack[vm->top] || lv == &vm->retval));
     assert(rv);
 
-    avm_assign(lv, rv);   
+    avm_assign(vm, lv, rv);   
 }
\ No newline at end of file
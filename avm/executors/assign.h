@@ -4,6 +4,6 @@
 #include "../avm_types.h"
 
 void
-execute_assign(instruction* instr);
+execute_assign(avm_vm* vm, instruction* instr);
 
 #endif
\ No newline at end of file
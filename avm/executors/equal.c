@@ -1,10 +1,15 @@
 #include "equal.h"
 
+#include "../quicken/quicken.h"
+
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
 #include <assert.h>
 
+static void
+quicken_equal(instruction* instr, avm_memcell_t type);
+
 typedef unsigned char (*tobool_func_t)(avm_memcell*);
 typedef unsigned char (*equal_func_t)(avm_memcell* m1, avm_memcell* m2);
 
@@ -66,46 +71,57 @@ unsigned char avm_tobool(avm_memcell* m) {
     return (*toboolFuncs[m->type])(m);
 }
 
-void
-execute_jeq(instruction* instr) {
-    assert(instr->result.type == label_a);
-
-    avm_memcell* rv1 = avm_translate_operand(&instr->arg1, &ax);
-    avm_memcell* rv2 = avm_translate_operand(&instr->arg2, &bx);
-
-    unsigned char result = 0;
+/*
+ * Quickened equality: both operands were numbers (_nn) or both strings (_ss)
+ * the last time the instruction ran. Any other pair of types deoptimizes.
+ */
+#define DEFINE_QUICK_EQUAL(name, suffix, memtype, equalExpr, branchIf)          \
+void                                                                            \
+execute_##name##_##suffix(avm_vm* vm, instruction* instr) {                     \
+    avm_memcell* rv1 = avm_translate_operand(vm, &instr->arg1, &vm->ax);        \
+    avm_memcell* rv2 = avm_translate_operand(vm, &instr->arg2, &vm->bx);        \
+                                                                                \
+    if (rv1->type != memtype || rv2->type != memtype) {                         \
+        quicken_deoptimize(instr);                                              \
+        execute_##name(vm, instr);                                              \
+        return;                                                                 \
+    }                                                                           \
+                                                                                \
+    if ((equalExpr) == branchIf) {                                              \
+        vm->pc = instr->result.val;                                             \
+        vm->branched = 1;                                                       \
+    }                                                                           \
+}
 
-    if (rv1->type == undef_m || rv2->type == undef_m) {
-        printf("Undef involved in equality!");
-        exit(1);
-    }
+DEFINE_QUICK_EQUAL(jeq, nn, number_m, rv1->data.numVal == rv2->data.numVal, 1)
+DEFINE_QUICK_EQUAL(jne, nn, number_m, rv1->data.numVal == rv2->data.numVal, 0)
+DEFINE_QUICK_EQUAL(jeq, ss, string_m, strcmp(rv1->data.strVal, rv2->data.strVal) == 0, 1)
+DEFINE_QUICK_EQUAL(jne, ss, string_m, strcmp(rv1->data.strVal, rv2->data.strVal) == 0, 0)
 
-    if (rv1->type == bool_m || rv2->type == bool_m) {
-        result = (avm_tobool(rv1) == avm_tobool(rv2));
-    }
-    else if (rv1->type == nil_m || rv2->type == nil_m) {
-        result = rv1->type == nil_m && rv2->type == nil_m;
-    }
-    else if (rv1->type != rv2->type) {
-        printf("Mismatch in equality.\n");
-        exit(1);
-    }
-    else {
-      equal_func_t eqFunc = equalFuncs[rv1->type];
-      result = (*eqFunc)(rv1, rv2); 
-    }
+void
+execute_jeq(avm_vm* vm, instruction* instr) {
+    assert(instr->result.type == label_a);
 
-    if (result) {
-        pc = instr->result.val;
+    if (equal_eval(vm, instr)) {
+        vm->pc = instr->result.val;
+        vm->branched = 1;
     }
 }
 
 void
-execute_jne(instruction* instr) {
+execute_jne(avm_vm* vm, instruction* instr) {
     assert(instr->result.type == label_a);
 
-    avm_memcell* rv1 = avm_translate_operand(&instr->arg1, &ax);
-    avm_memcell* rv2 = avm_translate_operand(&instr->arg2, &bx);
+    if (!equal_eval(vm, instr)) {
+        vm->pc = instr->result.val;
+        vm->branched = 1;
+    }
+}
+
+unsigned char
+equal_eval(avm_vm* vm, instruction* instr) {
+    avm_memcell* rv1 = avm_translate_operand(vm, &instr->arg1, &vm->ax);
+    avm_memcell* rv2 = avm_translate_operand(vm, &instr->arg2, &vm->bx);
 
     unsigned char result = 0;
 
@@ -129,7 +145,19 @@ execute_jne(instruction* instr) {
       result = (*eqFunc)(rv1, rv2); 
     }
 
-    if (!result) {
-        pc = instr->result.val;
+    if (rv1->type == rv2->type && (rv1->type == number_m || rv1->type == string_m)) {
+        quicken_equal(instr, rv1->type);
+    }
+
+    return result;
+}
+
+/* ------------------------------------------- Static Definitions ------------------------------------------- */
+static void
+quicken_equal(instruction* instr, avm_memcell_t type) {
+    switch (instr->origOpcode) {
+        case jeq_v: quicken_rewrite(instr, type == number_m ? jeq_nn_v : jeq_ss_v); break;
+        case jne_v: quicken_rewrite(instr, type == number_m ? jne_nn_v : jne_ss_v); break;
+        default:    break;
     }
 }
\ No newline at end of file
@@ -4,9 +4,24 @@
 #include "../avm_types.h"
 
 void
-execute_jeq(instruction* instr);
+execute_jeq(avm_vm* vm, instruction* instr);
 
 void
-execute_jne(instruction* instr);
+execute_jne(avm_vm* vm, instruction* instr);
+
+unsigned char
+equal_eval(avm_vm* vm, instruction* instr);
+
+void
+execute_jeq_nn(avm_vm* vm, instruction* instr);
+
+void
+execute_jne_nn(avm_vm* vm, instruction* instr);
+
+void
+execute_jeq_ss(avm_vm* vm, instruction* instr);
+
+void
+execute_jne_ss(avm_vm* vm, instruction* instr);
 
 #endif
\ No newline at end of file
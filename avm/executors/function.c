@@ -1,12 +1,14 @@
 #include "function.h"
+#include "../coroutine/coroutine.h"
+#include "../io/io.h"
+#include "../output/output.h"
+#include "../../common/dtoa/dtoa.h"
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <assert.h>
 
-static unsigned totalActuals = 0;
-
 #define AVM_NUMACTUALS_OFFSET   4
 #define AVM_SAVEDPC_OFFSET      3
 #define AVM_SAVEDTOP_OFFSET     2
@@ -14,28 +16,28 @@ static unsigned totalActuals = 0;
 
 /* ------------------------------------------- Static Declarations ------------------------------------------- */
 static void
-avm_calllibfunc(char* id);
+avm_calllibfunc(avm_vm* vm, char* id);
 
 static void
-avm_dec_top();
+avm_dec_top(avm_vm* vm);
 
 static void
-avm_push_envvalue(unsigned val);
+avm_push_envvalue(avm_vm* vm, unsigned val);
 
 static unsigned
-avm_get_envnvalue(unsigned i);
+avm_get_envnvalue(avm_vm* vm, unsigned i);
+
+static void
+avm_callsaveenvironment(avm_vm* vm);
 
 static void
-avm_callsaveenvironment();
+avm_saveenvironment(avm_vm* vm, unsigned returnPc);
 
 static unsigned
-avm_totalactuals();
+avm_totalactuals(avm_vm* vm);
 
 static avm_memcell*
-avm_getactual(unsigned i);
-
-static char*
-avm_tostring(avm_memcell* m);
+avm_getactual(avm_vm* vm, unsigned i);
 
 static char*
 number_tostring(avm_memcell* m);
@@ -44,42 +46,75 @@ static char*
 string_tostring(avm_memcell* m);
 
 static void
-libfunc_print();
+libfunc_print(avm_vm* vm);
+
+static void
+libfunc_flush(avm_vm* vm);
+
+static void
+libfunc_input(avm_vm* vm);
+
+static void
+libfunc_objectmemberkeys(avm_vm* vm);
+
+static void
+libfunc_objecttotalmembers(avm_vm* vm);
+
+static void
+libfunc_objectcopy(avm_vm* vm);
+
+static void
+libfunc_totalarguments(avm_vm* vm);
+
+static void
+libfunc_argument(avm_vm* vm);
+
+static void
+libfunc_typeof(avm_vm* vm);
+
+static void
+libfunc_strtonum(avm_vm* vm);
+
+static void
+libfunc_sqrt(avm_vm* vm);
 
 static void
-libfunc_input();
+libfunc_cos(avm_vm* vm);
 
 static void
-libfunc_objectmemberkeys();
+libfunc_sin(avm_vm* vm);
 
 static void
-libfunc_objecttotalmembers();
+libfunc_coroutine(avm_vm* vm);
 
 static void
-libfunc_objectcopy();
+libfunc_resume(avm_vm* vm);
 
 static void
-libfunc_totalarguments();
+libfunc_yield(avm_vm* vm);
 
 static void
-libfunc_argument();
+libfunc_coroutinestatus(avm_vm* vm);
 
 static void
-libfunc_typeof();
+libfunc_open(avm_vm* vm);
 
 static void
-libfunc_strtonum();
+libfunc_close(avm_vm* vm);
 
 static void
-libfunc_sqrt();
+libfunc_readline(avm_vm* vm);
 
 static void
-libfunc_cos();
+libfunc_read(avm_vm* vm);
 
 static void
-libfunc_sin();
+libfunc_write(avm_vm* vm);
+
+static avm_memcell*
+libfunc_getfile(avm_vm* vm);
 
-typedef void (*library_func_t)(void);
+typedef void (*library_func_t)(avm_vm*);
 typedef char* (*tostring_func_t)(avm_memcell*);
 
 typedef struct {
@@ -89,6 +124,7 @@ typedef struct {
 
 libfunc_entry libfuncMap[] = {
     { "print",              libfunc_print },
+    { "flush",              libfunc_flush },
     { "input",              libfunc_input },
     { "objectmemberkeys",   libfunc_objectmemberkeys },
     { "objecttotalmembers", libfunc_objecttotalmembers },
@@ -100,6 +136,15 @@ libfunc_entry libfuncMap[] = {
     { "sqrt",               libfunc_sqrt },
     { "cos",                libfunc_cos },
     { "sin",                libfunc_sin },
+    { "coroutine",          libfunc_coroutine },
+    { "resume",             libfunc_resume },
+    { "yield",              libfunc_yield },
+    { "coroutinestatus",    libfunc_coroutinestatus },
+    { "open",               libfunc_open },
+    { "close",              libfunc_close },
+    { "readline",           libfunc_readline },
+    { "read",               libfunc_read },
+    { "write",              libfunc_write },
 };
 
 #define LIBFUNC_COUNT (sizeof(libfuncMap) / sizeof(libfuncMap[0]))
@@ -114,22 +159,22 @@ get_libfunc(char* name);
 
 /* ------------------------------------------- Implementation ------------------------------------------- */
 void
-execute_call(instruction* instr) {
-    avm_memcell* func = avm_translate_operand(&instr->arg1, &ax);
+execute_call(avm_vm* vm, instruction* instr) {
+    avm_memcell* func = avm_translate_operand(vm, &instr->arg1, &vm->ax);
     assert(func);
     switch (func->type) {
         case userfunc_m: {
-            avm_callsaveenvironment();
-            pc = func->data.funcVal;
-            assert(code[pc].opcode == funcenter_v);
+            avm_callsaveenvironment(vm);
+            vm->pc = func->data.funcVal;
+            assert(vm->code[vm->pc].opcode == funcenter_v);
             break;
         }
         case string_m: {
-            avm_calllibfunc(func->data.strVal);
+            avm_calllibfunc(vm, func->data.strVal);
             break;
         }
         case libfunc_m: {
-            avm_calllibfunc(func->data.strVal);
+            avm_calllibfunc(vm, func->data.strVal);
             break;
         }
         default: {
@@ -140,41 +185,58 @@ execute_call(instruction* instr) {
 }
 
 void
-execute_pusharg(instruction* instr) {
-    avm_memcell* arg = avm_translate_operand(&instr->arg1, &ax);
+execute_pusharg(avm_vm* vm, instruction* instr) {
+    avm_memcell* arg = avm_translate_operand(vm, &instr->arg1, &vm->ax);
     assert(arg);
 
-    avm_assign(&stack[top], arg);
-    ++totalActuals;
-    avm_dec_top();
+    function_pusharg(vm, arg);
 }
 
 void
-execute_funcenter(instruction* instr) {
-    avm_memcell* func = avm_translate_operand(&instr->arg1, &ax);
+execute_funcenter(avm_vm* vm, instruction* instr) {
+    avm_memcell* func = avm_translate_operand(vm, &instr->arg1, &vm->ax);
     assert(func);
-    assert(pc == func->data.funcVal);
+    assert(vm->pc == func->data.funcVal);
 
-    totalActuals = 0;
-    userfunc funcInfo = avm_getfuncinfo(instr->arg1.val);
-    topsp = top;
-    top = top - funcInfo.localSize;
+    vm->totalActuals = 0;
+    userfunc funcInfo = avm_getfuncinfo(vm, instr->arg1.val);
+    vm->topsp = vm->top;
+    vm->top = vm->top - funcInfo.localSize;
 }
 
 void
-execute_funcexit(instruction* instr) {
-    unsigned oldTop = top;
+execute_funcexit(avm_vm* vm, instruction* instr) {
+    unsigned oldTop = vm->top;
 
-    top = avm_get_envnvalue(topsp + AVM_SAVEDTOP_OFFSET);
-    pc = avm_get_envnvalue(topsp + AVM_SAVEDPC_OFFSET);
-    topsp = avm_get_envnvalue(topsp + AVM_SAVEDTOPSP_OFFSET);
+    vm->top = avm_get_envnvalue(vm, vm->topsp + AVM_SAVEDTOP_OFFSET);
+    vm->pc = avm_get_envnvalue(vm, vm->topsp + AVM_SAVEDPC_OFFSET);
+    vm->topsp = avm_get_envnvalue(vm, vm->topsp + AVM_SAVEDTOPSP_OFFSET);
 
-    while (++oldTop <= top) {
-        avm_memcellclear(&stack[oldTop]);
+    while (++oldTop <= vm->top) {
+        avm_memcellclear(&vm->stack[oldTop]);
     }
 }
 
 /* ------------------------------------------- Extern Definition ------------------------------------------- */
+void
+function_pusharg(avm_vm* vm, avm_memcell* arg) {
+    avm_assign(vm, &vm->stack[vm->top], arg);
+    ++vm->totalActuals;
+    avm_dec_top(vm);
+}
+
+void
+function_calluser(avm_vm* vm, unsigned address, unsigned returnPc) {
+    avm_saveenvironment(vm, returnPc);
+    vm->pc = address;
+    assert(vm->code[vm->pc].opcode == funcenter_v);
+}
+
+char*
+avm_tostring(avm_memcell* m) {
+    assert(m->type >= 0 && m->type <= undef_m);
+    return (*tostringFuncs[m->type])(m);
+}
 
 /* ------------------------------------------- Static Definitions ------------------------------------------- */
 static library_func_t
@@ -187,7 +249,7 @@ get_libfunc(char* name) {
     return NULL;
 }
 
-static void avm_calllibfunc(char* id) {
+static void avm_calllibfunc(avm_vm* vm, char* id) {
     library_func_t f = get_libfunc(id);
 
     if (!f) {
@@ -195,58 +257,60 @@ static void avm_calllibfunc(char* id) {
         exit(1);
     }
 
-    avm_callsaveenvironment();
-    topsp = top;
-    totalActuals = 0;
-    (*f)();
-    execute_funcexit(NULL);
+    avm_callsaveenvironment(vm);
+    vm->topsp = vm->top;
+    vm->totalActuals = 0;
+    (*f)(vm);
+    execute_funcexit(vm, NULL);
+
+    // resume and yield switch once their frame is gone
+    coroutine_switch(vm);
 }
 
 static void
-avm_dec_top() {
-    if (!top) { // stack overflow
+avm_dec_top(avm_vm* vm) {
+    if (!vm->top) { // stack overflow
         printf("Stack overflow.\n");
         exit(1);
     }
     else {
-        top--;
+        vm->top--;
     }
 }
 
 static void
-avm_push_envvalue(unsigned val) {
-    stack[top].type = number_m;
-    stack[top].data.numVal = val;
-    avm_dec_top();
+avm_push_envvalue(avm_vm* vm, unsigned val) {
+    vm->stack[vm->top].type = number_m;
+    vm->stack[vm->top].data.numVal = val;
+    avm_dec_top(vm);
 }
 
 static unsigned
-avm_get_envnvalue(unsigned i) {
-    assert(stack[i].type == number_m);
-    unsigned val = (unsigned) stack[i].data.numVal;
-    assert(stack[i].data.numVal == ((double) val));
+avm_get_envnvalue(avm_vm* vm, unsigned i) {
+    assert(vm->stack[i].type == number_m);
+    unsigned val = (unsigned) vm->stack[i].data.numVal;
+    assert(vm->stack[i].data.numVal == ((double) val));
     return val;
 }
 
 static void
-avm_callsaveenvironment() {
-    avm_push_envvalue(totalActuals);
-    assert(code[pc].opcode == call_v);
-    avm_push_envvalue(pc + 1);
-    avm_push_envvalue(top + totalActuals + 2);
-    avm_push_envvalue(topsp);
+avm_callsaveenvironment(avm_vm* vm) {
+    assert(vm->code[vm->pc].opcode == call_v);
+    avm_saveenvironment(vm, vm->pc + 1);
 }
 
-static char*
-avm_tostring(avm_memcell* m) {
-    assert(m->type >= 0 && m->type <= undef_m);
-    return (*tostringFuncs[m->type])(m);
+static void
+avm_saveenvironment(avm_vm* vm, unsigned returnPc) {
+    avm_push_envvalue(vm, vm->totalActuals);
+    avm_push_envvalue(vm, returnPc);
+    avm_push_envvalue(vm, vm->top + vm->totalActuals + 2);
+    avm_push_envvalue(vm, vm->topsp);
 }
 
 static char*
 number_tostring(avm_memcell* m) {
-    char str[100];
-    sprintf(str, "%f", m->data.numVal);
+    char str[DTOA_BUFFER_SIZE];
+    dtoa_format(str, m->data.numVal);
     return strdup(str);
 }
 
@@ -256,77 +320,216 @@ string_tostring(avm_memcell* m) {
 }
 
 static unsigned
-avm_totalactuals() {
-    return avm_get_envnvalue(top + AVM_NUMACTUALS_OFFSET);
+avm_totalactuals(avm_vm* vm) {
+    return avm_get_envnvalue(vm, vm->top + AVM_NUMACTUALS_OFFSET);
 }
 
 static avm_memcell*
-avm_getactual(unsigned i) {
-    assert(i < avm_totalactuals());
-    return &stack[top + AVM_STACKENV_SIZE + 1 + i];
+avm_getactual(avm_vm* vm, unsigned i) {
+    assert(i < avm_totalactuals(vm));
+    return &vm->stack[vm->top + AVM_STACKENV_SIZE + 1 + i];
 }
 
 static void
-libfunc_print() {
-    unsigned n = avm_totalactuals();
+libfunc_print(avm_vm* vm) {
+    unsigned n = avm_totalactuals(vm);
     for (unsigned i = 0; i < n; i++) {
-        char* s = avm_tostring(avm_getactual(i));
-        puts(s);
-        free(s);
+        output_value(vm, avm_getactual(vm, i));
+        output_char(vm, '\n');
     }
+    output_printed(vm);
+}
+
+static void
+libfunc_flush(avm_vm* vm) {
+    output_flush(vm);
+}
+
+static void
+libfunc_input(avm_vm* vm) {
+    io_readline(vm, IO_STDIN);
+}
+
+static void
+libfunc_objectmemberkeys(avm_vm* vm) {
+
+}
+
+static void
+libfunc_objecttotalmembers(avm_vm* vm) {
+
+}
+
+static void
+libfunc_objectcopy(avm_vm* vm) {
+
+}
+
+static void
+libfunc_totalarguments(avm_vm* vm) {
+
+}
+
+static void
+libfunc_argument(avm_vm* vm) {
+
+}
+
+static void
+libfunc_typeof(avm_vm* vm) {
+
+}
+
+static void
+libfunc_strtonum(avm_vm* vm) {
+
+}
+
+static void
+libfunc_sqrt(avm_vm* vm) {
+
 }
 
 static void
-libfunc_input() {
+libfunc_cos(avm_vm* vm) {
 
 }
 
 static void
-libfunc_objectmemberkeys() {
+libfunc_sin(avm_vm* vm) {
 
 }
 
 static void
-libfunc_objecttotalmembers() {
+libfunc_coroutine(avm_vm* vm) {
+    avm_memcell* func = avm_totalactuals(vm) ? avm_getactual(vm, 0) : NULL;
+
+    avm_memcellclear(&vm->retval);
+    if (!func || func->type != userfunc_m) {
+        avm_warning(vm, "coroutine expects a user function!");
+        vm->retval.type = nil_m;
+        return;
+    }
 
+    vm->retval.type = number_m;
+    vm->retval.data.numVal = coroutine_create(vm, func->data.funcVal);
 }
 
 static void
-libfunc_objectcopy() {
+libfunc_resume(avm_vm* vm) {
+    unsigned n = avm_totalactuals(vm);
+    avm_memcell* co = n ? avm_getactual(vm, 0) : NULL;
+    avm_memcell nil;
+    nil.type = nil_m;
+
+    if (!co || co->type != number_m) {
+        avm_warning(vm, "resume expects a coroutine!");
+        avm_memcellclear(&vm->retval);
+        vm->retval.type = nil_m;
+        return;
+    }
 
+    coroutine_resume(vm, (unsigned) co->data.numVal, n > 1 ? avm_getactual(vm, 1) : &nil);
 }
 
 static void
-libfunc_totalarguments() {
+libfunc_yield(avm_vm* vm) {
+    avm_memcell nil;
+    nil.type = nil_m;
 
+    coroutine_yield(vm, avm_totalactuals(vm) ? avm_getactual(vm, 0) : &nil);
 }
 
 static void
-libfunc_argument() {
+libfunc_coroutinestatus(avm_vm* vm) {
+    static const char* names[] = { "suspended", "running", "normal", "dead" };
+    avm_memcell* co = avm_totalactuals(vm) ? avm_getactual(vm, 0) : NULL;
+
+    avm_memcellclear(&vm->retval);
+    if (!co || co->type != number_m) {
+        avm_warning(vm, "coroutinestatus expects a coroutine!");
+        vm->retval.type = nil_m;
+        return;
+    }
 
+    vm->retval.type = string_m;
+    vm->retval.data.strVal = strdup(names[coroutine_getstatus(vm, (unsigned) co->data.numVal)]);
 }
 
 static void
-libfunc_typeof() {
+libfunc_open(avm_vm* vm) {
+    unsigned n = avm_totalactuals(vm);
+    avm_memcell* path = n ? avm_getactual(vm, 0) : NULL;
+    avm_memcell* mode = n > 1 ? avm_getactual(vm, 1) : NULL;
+
+    if (!path || path->type != string_m || (mode && mode->type != string_m)) {
+        avm_warning(vm, "open expects a path and a mode!");
+        avm_memcellclear(&vm->retval);
+        vm->retval.type = nil_m;
+        return;
+    }
 
+    io_open(vm, path->data.strVal, mode ? mode->data.strVal : "r");
 }
 
 static void
-libfunc_strtonum() {
+libfunc_close(avm_vm* vm) {
+    avm_memcell* file = libfunc_getfile(vm);
 
+    if (file) {
+        io_close(vm, (unsigned) file->data.numVal);
+    }
 }
 
 static void
-libfunc_sqrt() {
+libfunc_readline(avm_vm* vm) {
+    avm_memcell* file = libfunc_getfile(vm);
 
+    if (file) {
+        io_readline(vm, (unsigned) file->data.numVal);
+    }
 }
 
 static void
-libfunc_cos() {
+libfunc_read(avm_vm* vm) {
+    avm_memcell* file = libfunc_getfile(vm);
+    avm_memcell* size = avm_totalactuals(vm) > 1 ? avm_getactual(vm, 1) : NULL;
 
+    if (file) {
+        io_read(vm, (unsigned) file->data.numVal, size && size->type == number_m ? (unsigned) size->data.numVal : 0);
+    }
 }
 
 static void
-libfunc_sin() {
+libfunc_write(avm_vm* vm) {
+    avm_memcell* file = libfunc_getfile(vm);
+    avm_memcell* data = avm_totalactuals(vm) > 1 ? avm_getactual(vm, 1) : NULL;
+
+    if (!file) {
+        return;
+    }
+    if (!data || (data->type != number_m && data->type != string_m)) {
+        avm_warning(vm, "write expects a number or a string!");
+        avm_memcellclear(&vm->retval);
+        vm->retval.type = nil_m;
+        return;
+    }
+
+    char* str = avm_tostring(data);
+    io_write(vm, (unsigned) file->data.numVal, str);
+    free(str);
+}
 
-}
\ No newline at end of file
+// the file argument of the I/O libfuncs, retval is nil without one
+static avm_memcell*
+libfunc_getfile(avm_vm* vm) {
+    avm_memcell* file = avm_totalactuals(vm) ? avm_getactual(vm, 0) : NULL;
+
+    if (!file || file->type != number_m) {
+        avm_warning(vm, "Expected a file!");
+        avm_memcellclear(&vm->retval);
+        vm->retval.type = nil_m;
+        return NULL;
+    }
+    return file;
+}
@@ -4,15 +4,27 @@
 #include "../avm_types.h"
 
 void
-execute_call(instruction* instr);
+execute_call(avm_vm* vm, instruction* instr);
 
 void
-execute_pusharg(instruction* instr);
+execute_pusharg(avm_vm* vm, instruction* instr);
 
 void
-execute_funcenter(instruction* instr);
+execute_funcenter(avm_vm* vm, instruction* instr);
 
 void
-execute_funcexit(instruction* instr);
+execute_funcexit(avm_vm* vm, instruction* instr);
+
+// pushes the next argument of a call, the arguments go last to first
+void
+function_pusharg(avm_vm* vm, avm_memcell* arg);
+
+// enters the user function at `address` as a call made at returnPc - 1 would
+void
+function_calluser(avm_vm* vm, unsigned address, unsigned returnPc);
+
+// printed form of numbers and strings, to be freed
+char*
+avm_tostring(avm_memcell* m);
 
 #endif
\ No newline at end of file
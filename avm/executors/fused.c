@@ -0,0 +1,108 @@
+#include "fused.h"
+#include "arithmetic.h"
+#include "relational.h"
+#include "assign.h"
+#include "equal.h"
+#include "function.h"
+
+#include "../tables/tables.h"
+
+#include <stdio.h>
+#include <assert.h>
+
+/*
+ * A superinstruction executes the instruction it replaced together with
+ * the one(s) that follow it in the code array. Followers may themselves
+ * have been rewritten into superinstructions, so their work is always
+ * selected by origOpcode and never by opcode.
+ */
+
+/* ------------------------------------------- Static Declarations ------------------------------------------- */
+static void
+call_at(avm_vm* vm, unsigned callPc);
+
+/* ------------------------------------------- Implementation ------------------------------------------- */
+void
+execute_arithassign(avm_vm* vm, instruction* instr) {
+    assert((instr + 1)->origOpcode == assign_v);
+
+    arithmetic_eval(vm, instr, instr->origOpcode);
+    execute_assign(vm, instr + 1);
+    vm->pc += 2;
+}
+
+void
+execute_assignarith(avm_vm* vm, instruction* instr) {
+    assert((instr + 1)->origOpcode >= add_v && (instr + 1)->origOpcode <= mod_v);
+
+    execute_assign(vm, instr);
+    arithmetic_eval(vm, instr + 1, (instr + 1)->origOpcode);
+    vm->pc += 2;
+}
+
+void
+execute_assignassign(avm_vm* vm, instruction* instr) {
+    assert((instr + 1)->origOpcode == assign_v);
+
+    execute_assign(vm, instr);
+    execute_assign(vm, instr + 1);
+    vm->pc += 2;
+}
+
+void
+execute_assignjump(avm_vm* vm, instruction* instr) {
+    assert((instr + 1)->origOpcode == jump_v);
+    assert((instr + 1)->result.type == label_a);
+
+    execute_assign(vm, instr);
+    vm->pc = (instr + 1)->result.val;
+    vm->branched = 1;
+}
+
+void
+execute_jcondjump(avm_vm* vm, instruction* instr) {
+    assert(instr->result.type == label_a);
+    assert((instr + 1)->origOpcode == jump_v);
+
+    unsigned char taken;
+
+    switch (instr->origOpcode) {
+        case jeq_v: taken = equal_eval(vm, instr);  break;
+        case jne_v: taken = !equal_eval(vm, instr); break;
+        default:    taken = relational_eval(vm, instr, instr->origOpcode);
+    }
+
+    vm->pc = taken ? instr->result.val : (instr + 1)->result.val;
+    vm->branched = 1;
+}
+
+void
+execute_pushargcall(avm_vm* vm, instruction* instr) {
+    unsigned totalPushargs = instr->arg2.val;
+
+    for (unsigned i = 0; i < totalPushargs; i++) {
+        execute_pusharg(vm, instr + i);
+    }
+
+    call_at(vm, vm->pc + totalPushargs);
+}
+
+void
+execute_tablegetelemcall(avm_vm* vm, instruction* instr) {
+    execute_tablegetelem(vm, instr);
+    call_at(vm, vm->pc + 1);
+}
+
+/* ------------------------------------------- Static Definitions ------------------------------------------- */
+static void
+call_at(avm_vm* vm, unsigned callPc) {
+    assert(vm->code[callPc].origOpcode == call_v);
+
+    vm->pc = callPc;
+    execute_call(vm, vm->code + callPc);
+
+    // library functions return to the instruction after the call
+    if (vm->pc == callPc) {
+        ++vm->pc;
+    }
+}
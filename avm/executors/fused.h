@@ -0,0 +1,27 @@
+#ifndef FUSED_H
+#define FUSED_H
+
+#include "../avm_types.h"
+
+void
+execute_arithassign(avm_vm* vm, instruction* instr);
+
+void
+execute_assignarith(avm_vm* vm, instruction* instr);
+
+void
+execute_assignassign(avm_vm* vm, instruction* instr);
+
+void
+execute_assignjump(avm_vm* vm, instruction* instr);
+
+void
+execute_jcondjump(avm_vm* vm, instruction* instr);
+
+void
+execute_pushargcall(avm_vm* vm, instruction* instr);
+
+void
+execute_tablegetelemcall(avm_vm* vm, instruction* instr);
+
+#endif
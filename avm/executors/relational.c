@@ -1,5 +1,7 @@
 #include "relational.h"
 
+#include "../quicken/quicken.h"
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <assert.h>
@@ -18,26 +20,60 @@ relational_func_t relationalFuncs[] = {
     jgt_impl
 };
 
-void
-execute_relational(instruction* instr) {
+vmopcode relationalQuickOpcodes[] = {
+    jle_nn_v,
+    jge_nn_v,
+    jlt_nn_v,
+    jgt_nn_v
+};
+
+#define DEFINE_QUICK_RELATIONAL(name)                                           \
+void                                                                            \
+execute_##name##_nn(avm_vm* vm, instruction* instr) {                           \
+    avm_memcell* rv1 = avm_translate_operand(vm, &instr->arg1, &vm->ax);        \
+    avm_memcell* rv2 = avm_translate_operand(vm, &instr->arg2, &vm->bx);        \
+                                                                                \
+    if (rv1->type != number_m || rv2->type != number_m) {                       \
+        quicken_deoptimize(instr);                                              \
+        execute_relational(vm, instr);                                          \
+        return;                                                                 \
+    }                                                                           \
+                                                                                \
+    if (name##_impl(rv1->data.numVal, rv2->data.numVal)) {                      \
+        vm->pc = instr->result.val;                                             \
+        vm->branched = 1;                                                       \
+    }                                                                           \
+}
+
+DEFINE_QUICK_RELATIONAL(jle)
+DEFINE_QUICK_RELATIONAL(jge)
+DEFINE_QUICK_RELATIONAL(jlt)
+DEFINE_QUICK_RELATIONAL(jgt)
 
+void
+execute_relational(avm_vm* vm, instruction* instr) {
     assert(instr->result.type == label_a);
 
-    avm_memcell* rv1 = avm_translate_operand(&instr->arg1, &ax);
-    avm_memcell* rv2 = avm_translate_operand(&instr->arg2, &bx);
+    if (relational_eval(vm, instr, instr->origOpcode)) {
+        vm->pc = instr->result.val;
+        vm->branched = 1;
+    }
+}
+
+unsigned char
+relational_eval(avm_vm* vm, instruction* instr, vmopcode opcode) {
+    avm_memcell* rv1 = avm_translate_operand(vm, &instr->arg1, &vm->ax);
+    avm_memcell* rv2 = avm_translate_operand(vm, &instr->arg2, &vm->bx);
 
     if (rv1->type != number_m || rv2->type != number_m) {
         printf("AVM Error: Not a number in relational.\n");
         exit(1);
     }
 
-    unsigned char result;
-    relational_func_t op;
+    relational_func_t op = relationalFuncs[opcode - jle_v];
+    unsigned char result = (*op)(rv1->data.numVal, rv2->data.numVal);
 
-    op = relationalFuncs[instr->opcode - jle_v];
-    result = (*op)(rv1->data.numVal, rv2->data.numVal);
+    quicken_rewrite(instr, relationalQuickOpcodes[opcode - jle_v]);
 
-    if (result) {
-        pc = instr->result.val;
-    }
-}
\ No newline at end of file
+    return result;
+}
@@ -4,6 +4,21 @@
 #include "../avm_types.h"
 
 void
-execute_relational(instruction* instr);
+execute_relational(avm_vm* vm, instruction* instr);
+
+unsigned char
+relational_eval(avm_vm* vm, instruction* instr, vmopcode opcode);
+
+void
+execute_jle_nn(avm_vm* vm, instruction* instr);
+
+void
+execute_jge_nn(avm_vm* vm, instruction* instr);
+
+void
+execute_jlt_nn(avm_vm* vm, instruction* instr);
+
+void
+execute_jgt_nn(avm_vm* vm, instruction* instr);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,609 @@
+#include "io.h"
+#include "../output/output.h"
+#include "../coroutine/coroutine.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+
+/*
+ * Files are raw descriptors with a read buffer, and are never switched to
+ * non-blocking mode, since stdin and stdout are shared with the parent: a
+ * read or write only goes to the descriptor after poll says it is ready,
+ * so it cannot block. Regular files are always ready.
+ *
+ * An operation that cannot go on queues a waiter on its file. With
+ * scheduling on, a coroutine that the host resumed parks there, yielding
+ * to the host, and the file is watched by the vm's epoll instance; io_wait
+ * retries the queued operations of the files that got ready, in order,
+ * and each one done completes its coroutine with the result. Otherwise
+ * the thread polls the file until the operation is done.
+ */
+
+#define IO_CHUNK_SIZE   4096
+#define IO_MAX_EVENTS   64
+
+typedef enum io_op {
+    IO_READLINE,
+    IO_READ,
+    IO_WRITE
+} io_op;
+
+typedef struct io_waiter {
+    unsigned co;
+    io_op op;
+    unsigned size;              // of a read
+    char* data;                 // what is left to write
+    size_t length, written;
+    struct io_waiter* next;
+} io_waiter;
+
+typedef struct io_file {
+    int fd;
+    unsigned char eof;
+    char* buffer;
+    size_t length, capacity;
+
+    io_waiter* first;
+    io_waiter* last;
+    unsigned events;            // watched for, 0 if not
+} io_file;
+
+typedef struct io_completion {
+    unsigned co;
+    avm_memcell value;
+} io_completion;
+
+typedef struct io_state {
+    int epollFd;
+    unsigned char scheduling;
+
+    io_file** files;
+    unsigned totalFiles, size;
+
+    unsigned char* waiting;     // by coroutine
+    unsigned waitingSize;
+    unsigned totalWaiting;
+
+    io_completion* completed;   // handed out in order, [firstCompleted, totalCompleted)
+    unsigned firstCompleted, totalCompleted, completedSize;
+} io_state;
+
+/* ------------------------------------------- Static Declarations ------------------------------------------- */
+static io_state*
+io_state_get(avm_vm* vm);
+
+static io_file*
+io_getfile(avm_vm* vm, unsigned file);
+
+static io_file*
+io_newfile(int fd);
+
+static void
+io_run(avm_vm* vm, io_file* file, io_waiter* waiter);
+
+static unsigned char
+io_try(io_file* file, io_waiter* waiter, avm_memcell* result);
+
+static unsigned char
+io_fill(io_file* file);
+
+static unsigned char
+io_ready(int fd, short events);
+
+static short
+io_events(io_waiter* waiter);
+
+static void
+io_park(avm_vm* vm, io_file* file, io_waiter* waiter);
+
+static void
+io_watch(io_state* state, io_file* file);
+
+static void
+io_complete(io_state* state, unsigned co, avm_memcell* value);
+
+static void
+io_setstring(avm_memcell* m, char* str, size_t length);
+
+static void
+io_setnil(avm_memcell* m);
+
+/* ------------------------------------------- Implementation ------------------------------------------- */
+void
+io_open(avm_vm* vm, char* path, char* mode) {
+    io_state* state = io_state_get(vm);
+    int flags;
+
+    if (strcmp(mode, "r") == 0) {
+        flags = O_RDONLY;
+    }
+    else if (strcmp(mode, "w") == 0) {
+        flags = O_WRONLY | O_CREAT | O_TRUNC;
+    }
+    else if (strcmp(mode, "a") == 0) {
+        flags = O_WRONLY | O_CREAT | O_APPEND;
+    }
+    else {
+        avm_warning(vm, "open expects the mode \"r\", \"w\" or \"a\"!");
+        io_setnil(&vm->retval);
+        return;
+    }
+
+    int fd = open(path, flags, 0644);
+    if (fd < 0) {
+        io_setnil(&vm->retval);
+        return;
+    }
+
+    unsigned file = IO_STDERR + 1;
+    while (file < state->totalFiles && state->files[file]) {
+        file++;
+    }
+    if (file == state->totalFiles) {
+        if (state->totalFiles == state->size) {
+            state->size *= 2;
+            state->files = realloc(state->files, state->size * sizeof(io_file*));
+            if (!state->files) {
+                printf("Error allocating memory for the files.\n");
+                exit(1);
+            }
+        }
+        state->totalFiles++;
+    }
+    state->files[file] = io_newfile(fd);
+
+    avm_memcellclear(&vm->retval);
+    vm->retval.type = number_m;
+    vm->retval.data.numVal = file;
+}
+
+void
+io_close(avm_vm* vm, unsigned file) {
+    io_file* f = io_getfile(vm, file);
+
+    io_setnil(&vm->retval);
+    if (!f || file <= IO_STDERR) {
+        return;
+    }
+    if (f->first) {
+        avm_warning(vm, "Closing a file that a coroutine waits on!");
+        return;
+    }
+
+    close(f->fd);
+    free(f->buffer);
+    free(f);
+    vm->io->files[file] = NULL;
+}
+
+void
+io_readline(avm_vm* vm, unsigned file) {
+    io_waiter waiter = { 0 };
+    waiter.op = IO_READLINE;
+    io_run(vm, io_getfile(vm, file), &waiter);
+}
+
+void
+io_read(avm_vm* vm, unsigned file, unsigned size) {
+    io_waiter waiter = { 0 };
+    waiter.op = IO_READ;
+    waiter.size = size ? size : IO_CHUNK_SIZE;
+    io_run(vm, io_getfile(vm, file), &waiter);
+}
+
+void
+io_write(avm_vm* vm, unsigned file, char* data) {
+    io_waiter waiter = { 0 };
+    waiter.op = IO_WRITE;
+    waiter.data = data;
+    waiter.length = strlen(data);
+
+    // what print has buffered goes first
+    if (file == IO_STDOUT || file == IO_STDERR) {
+        output_flush(vm);
+        fflush(stdout);
+    }
+    io_run(vm, io_getfile(vm, file), &waiter);
+}
+
+void
+io_enablescheduling(avm_vm* vm) {
+    io_state* state = io_state_get(vm);
+
+    state->epollFd = epoll_create1(0);
+    if (state->epollFd < 0) {
+        printf("Error creating the event loop.\n");
+        exit(1);
+    }
+    state->scheduling = 1;
+}
+
+unsigned
+io_totalwaiting(avm_vm* vm) {
+    return vm->io ? vm->io->totalWaiting : 0;
+}
+
+unsigned char
+io_iswaiting(avm_vm* vm, unsigned co) {
+    io_state* state = vm->io;
+    return state && co < state->waitingSize && state->waiting[co];
+}
+
+void
+io_wait(avm_vm* vm, int timeoutMs) {
+    io_state* state = vm->io;
+    struct epoll_event events[IO_MAX_EVENTS];
+
+    if (!state || !state->totalWaiting) {
+        return;
+    }
+
+    int total = epoll_wait(state->epollFd, events, IO_MAX_EVENTS, timeoutMs);
+    for (int i = 0; i < total; i++) {
+        io_file* file = state->files[events[i].data.u32];
+        avm_memcell result;
+
+        while (file->first && io_try(file, file->first, &result)) {
+            io_waiter* done = file->first;
+            file->first = done->next;
+            io_complete(state, done->co, &result);
+            free(done->data);
+            free(done);
+        }
+        if (!file->first) {
+            file->last = NULL;
+        }
+        io_watch(state, file);
+    }
+}
+
+unsigned
+io_completed(avm_vm* vm, avm_memcell* value) {
+    io_state* state = vm->io;
+
+    if (!state || state->firstCompleted == state->totalCompleted) {
+        return COROUTINE_MAIN;
+    }
+
+    io_completion* completion = &state->completed[state->firstCompleted++];
+    *value = completion->value;
+    if (state->firstCompleted == state->totalCompleted) {
+        state->firstCompleted = state->totalCompleted = 0;
+    }
+    return completion->co;
+}
+
+void
+io_destroy(avm_vm* vm) {
+    io_state* state = vm->io;
+
+    if (!state) {
+        return;
+    }
+
+    for (unsigned i = 0; i < state->totalFiles; i++) {
+        io_file* file = state->files[i];
+        if (!file) {
+            continue;
+        }
+        while (file->first) {
+            io_waiter* waiter = file->first;
+            file->first = waiter->next;
+            free(waiter->data);
+            free(waiter);
+        }
+        if (i > IO_STDERR) {
+            close(file->fd);
+        }
+        free(file->buffer);
+        free(file);
+    }
+    for (unsigned i = state->firstCompleted; i < state->totalCompleted; i++) {
+        avm_memcellclear(&state->completed[i].value);
+    }
+    if (state->scheduling) {
+        close(state->epollFd);
+    }
+
+    free(state->files);
+    free(state->waiting);
+    free(state->completed);
+    free(state);
+    vm->io = NULL;
+}
+
+/* ------------------------------------------- Static Definitions ------------------------------------------- */
+static io_state*
+io_state_get(avm_vm* vm) {
+    if (!vm->io) {
+        io_state* state = calloc(1, sizeof(io_state));
+
+        if (!state || !(state->files = calloc(8, sizeof(io_file*)))) {
+            printf("Error allocating memory for the files.\n");
+            exit(1);
+        }
+
+        state->size = 8;
+        state->totalFiles = IO_STDERR + 1;
+        state->files[IO_STDIN] = io_newfile(STDIN_FILENO);
+        state->files[IO_STDOUT] = io_newfile(STDOUT_FILENO);
+        state->files[IO_STDERR] = io_newfile(STDERR_FILENO);
+        vm->io = state;
+    }
+    return vm->io;
+}
+
+static io_file*
+io_getfile(avm_vm* vm, unsigned file) {
+    io_state* state = io_state_get(vm);
+    return file < state->totalFiles ? state->files[file] : NULL;
+}
+
+static io_file*
+io_newfile(int fd) {
+    io_file* file = calloc(1, sizeof(io_file));
+
+    if (!file) {
+        printf("Error allocating memory for a file.\n");
+        exit(1);
+    }
+    file->fd = fd;
+    return file;
+}
+
+// done at once, parked, or waited for
+static void
+io_run(avm_vm* vm, io_file* file, io_waiter* waiter) {
+    io_state* state = vm->io;
+    avm_memcell result;
+
+    if (!file) {
+        avm_warning(vm, "No such open file!");
+        io_setnil(&vm->retval);
+        return;
+    }
+
+    unsigned co = coroutine_current(vm);
+    unsigned char canPark = state->scheduling && co != COROUTINE_MAIN &&
+                            coroutine_getresumer(vm, co) == COROUTINE_MAIN;
+
+    if (canPark && file->first) {
+        io_park(vm, file, waiter);
+        return;
+    }
+
+    while (!io_try(file, waiter, &result)) {
+        if (canPark) {
+            io_park(vm, file, waiter);
+            return;
+        }
+        struct pollfd p = { file->fd, io_events(waiter), 0 };
+        poll(&p, 1, -1);
+    }
+
+    avm_memcellclear(&vm->retval);
+    vm->retval = result;
+}
+
+static unsigned char
+io_try(io_file* file, io_waiter* waiter, avm_memcell* result) {
+    switch (waiter->op) {
+        case IO_READLINE: {
+            while (1) {
+                char* newline = memchr(file->buffer, '\n', file->length);
+                if (newline) {
+                    size_t length = newline - file->buffer;
+                    io_setstring(result, file->buffer, length);
+                    file->length -= length + 1;
+                    memmove(file->buffer, newline + 1, file->length);
+                    return 1;
+                }
+                if (file->eof) {
+                    if (file->length) {
+                        io_setstring(result, file->buffer, file->length);
+                        file->length = 0;
+                    }
+                    else {
+                        result->type = nil_m;
+                    }
+                    return 1;
+                }
+                if (!io_fill(file)) {
+                    return 0;
+                }
+            }
+        }
+        case IO_READ: {
+            if (!file->length && !file->eof && !io_fill(file)) {
+                return 0;
+            }
+            if (!file->length) {
+                result->type = nil_m;
+                return 1;
+            }
+
+            size_t length = file->length < waiter->size ? file->length : waiter->size;
+            io_setstring(result, file->buffer, length);
+            file->length -= length;
+            memmove(file->buffer, file->buffer + length, file->length);
+            return 1;
+        }
+        case IO_WRITE: {
+            while (waiter->written < waiter->length) {
+                if (!io_ready(file->fd, POLLOUT)) {
+                    return 0;
+                }
+
+                ssize_t written = write(file->fd, waiter->data + waiter->written, waiter->length - waiter->written);
+                if (written < 0 && errno == EINTR) {
+                    continue;
+                }
+                if (written < 0) {
+                    break;
+                }
+                waiter->written += written;
+            }
+            result->type = number_m;
+            result->data.numVal = waiter->written;
+            return 1;
+        }
+        default: return 1;
+    }
+}
+
+// one read into the buffer if the file is ready, an error counts as its end
+static unsigned char
+io_fill(io_file* file) {
+    if (!io_ready(file->fd, POLLIN)) {
+        return 0;
+    }
+
+    if (file->capacity - file->length < IO_CHUNK_SIZE) {
+        file->capacity = file->length + IO_CHUNK_SIZE;
+        file->buffer = realloc(file->buffer, file->capacity);
+        if (!file->buffer) {
+            printf("Error allocating memory for a file buffer.\n");
+            exit(1);
+        }
+    }
+
+    ssize_t total;
+    do {
+        total = read(file->fd, file->buffer + file->length, IO_CHUNK_SIZE);
+    } while (total < 0 && errno == EINTR);
+
+    if (total <= 0) {
+        file->eof = 1;
+    }
+    else {
+        file->length += total;
+    }
+    return 1;
+}
+
+static unsigned char
+io_ready(int fd, short events) {
+    struct pollfd p = { fd, events, 0 };
+    return poll(&p, 1, 0) > 0;
+}
+
+static short
+io_events(io_waiter* waiter) {
+    return waiter->op == IO_WRITE ? POLLOUT : POLLIN;
+}
+
+// queues a copy of the waiter and yields to the host
+static void
+io_park(avm_vm* vm, io_file* file, io_waiter* waiter) {
+    io_state* state = vm->io;
+    io_waiter* parked = malloc(sizeof(io_waiter));
+    avm_memcell nil;
+
+    if (!parked) {
+        printf("Error allocating memory for an I/O waiter.\n");
+        exit(1);
+    }
+    *parked = *waiter;
+    parked->co = coroutine_current(vm);
+    parked->next = NULL;
+    if (waiter->op == IO_WRITE) {
+        parked->data = strdup(waiter->data);
+    }
+
+    if (file->last) {
+        file->last->next = parked;
+    }
+    else {
+        file->first = parked;
+    }
+    file->last = parked;
+    io_watch(state, file);
+
+    if (parked->co >= state->waitingSize) {
+        unsigned size = state->waitingSize ? state->waitingSize : 64;
+        while (size <= parked->co) {
+            size *= 2;
+        }
+        state->waiting = realloc(state->waiting, size);
+        if (!state->waiting) {
+            printf("Error allocating memory for the I/O waiters.\n");
+            exit(1);
+        }
+        memset(state->waiting + state->waitingSize, 0, size - state->waitingSize);
+        state->waitingSize = size;
+    }
+    state->waiting[parked->co] = 1;
+    state->totalWaiting++;
+
+    nil.type = nil_m;
+    coroutine_yield(vm, &nil);
+}
+
+// watches the file for what its first waiter needs
+static void
+io_watch(io_state* state, io_file* file) {
+    struct epoll_event event;
+    unsigned events = file->first ? (io_events(file->first) == POLLOUT ? EPOLLOUT : EPOLLIN) : 0;
+
+    if (events == file->events) {
+        return;
+    }
+
+    unsigned index = 0;
+    while (state->files[index] != file) {
+        index++;
+    }
+    event.events = events;
+    event.data.u32 = index;
+
+    if (!events) {
+        epoll_ctl(state->epollFd, EPOLL_CTL_DEL, file->fd, &event);
+    }
+    else if (epoll_ctl(state->epollFd, file->events ? EPOLL_CTL_MOD : EPOLL_CTL_ADD, file->fd, &event) < 0) {
+        printf("Error watching file %u.\n", index);
+        exit(1);
+    }
+    file->events = events;
+}
+
+static void
+io_complete(io_state* state, unsigned co, avm_memcell* value) {
+    // the completions handed out make room before the queue grows
+    if (state->totalCompleted == state->completedSize && state->firstCompleted) {
+        state->totalCompleted -= state->firstCompleted;
+        memmove(state->completed, state->completed + state->firstCompleted, state->totalCompleted * sizeof(io_completion));
+        state->firstCompleted = 0;
+    }
+    if (state->totalCompleted == state->completedSize) {
+        state->completedSize = state->completedSize ? state->completedSize * 2 : 16;
+        state->completed = realloc(state->completed, state->completedSize * sizeof(io_completion));
+        if (!state->completed) {
+            printf("Error allocating memory for the I/O completions.\n");
+            exit(1);
+        }
+    }
+
+    state->completed[state->totalCompleted].co = co;
+    state->completed[state->totalCompleted].value = *value;
+    state->totalCompleted++;
+    state->waiting[co] = 0;
+    state->totalWaiting--;
+}
+
+static void
+io_setstring(avm_memcell* m, char* str, size_t length) {
+    m->type = string_m;
+    m->data.strVal = strndup(str, length);
+}
+
+static void
+io_setnil(avm_memcell* m) {
+    avm_memcellclear(m);
+    m->type = nil_m;
+}
@@ -0,0 +1,55 @@
+#ifndef IO_H
+#define IO_H
+
+#include "../avm_types.h"
+
+#define IO_STDIN    0
+#define IO_STDOUT   1
+#define IO_STDERR   2
+
+/*
+ * File and pipe I/O of the libfuncs. Every operation leaves its result in
+ * retval: a line or chunk (nil at the end of input), or the number of bytes
+ * written. One that would block either parks the running coroutine, when
+ * a scheduler resumes it, or waits for its file.
+ */
+void
+io_open(avm_vm* vm, char* path, char* mode);
+
+void
+io_close(avm_vm* vm, unsigned file);
+
+void
+io_readline(avm_vm* vm, unsigned file);
+
+void
+io_read(avm_vm* vm, unsigned file, unsigned size);
+
+void
+io_write(avm_vm* vm, unsigned file, char* data);
+
+/*
+ * The scheduler's side. Coroutines the host resumed park on I/O once it
+ * enables scheduling; io_wait runs the ready operations, and io_completed
+ * hands out each parked coroutine with the value to resume it with, which
+ * the caller clears.
+ */
+void
+io_enablescheduling(avm_vm* vm);
+
+unsigned
+io_totalwaiting(avm_vm* vm);
+
+unsigned char
+io_iswaiting(avm_vm* vm, unsigned co);
+
+void
+io_wait(avm_vm* vm, int timeoutMs);
+
+unsigned
+io_completed(avm_vm* vm, avm_memcell* value);
+
+void
+io_destroy(avm_vm* vm);
+
+#endif
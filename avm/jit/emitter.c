@@ -0,0 +1,268 @@
+#include "emitter.h"
+
+#include <assert.h>
+#include <string.h>
+
+#define REX_W   0x48
+
+/* ------------------------------------------- Static Declarations ------------------------------------------- */
+static void
+emit_modrm(jit_buffer* buf, unsigned char mod, unsigned char reg, unsigned char rm);
+
+static void
+emit_mem(jit_buffer* buf, unsigned char reg, jit_reg base, unsigned char disp);
+
+/* ------------------------------------------- Implementation ------------------------------------------- */
+void
+emit_byte(jit_buffer* buf, unsigned char b) {
+    assert(buf->size < buf->capacity);
+    buf->base[buf->size++] = b;
+}
+
+void
+emit_u32(jit_buffer* buf, unsigned v) {
+    for (unsigned i = 0; i < 4; i++) {
+        emit_byte(buf, (v >> (8 * i)) & 0xFF);
+    }
+}
+
+void
+emit_u64(jit_buffer* buf, unsigned long long v) {
+    for (unsigned i = 0; i < 8; i++) {
+        emit_byte(buf, (v >> (8 * i)) & 0xFF);
+    }
+}
+
+void
+emit_push(jit_buffer* buf, jit_reg reg) {
+    emit_byte(buf, 0x50 + reg);
+}
+
+void
+emit_pop(jit_buffer* buf, jit_reg reg) {
+    emit_byte(buf, 0x58 + reg);
+}
+
+void
+emit_ret(jit_buffer* buf) {
+    emit_byte(buf, 0xC3);
+}
+
+// mov reg, imm64
+void
+emit_mov_imm64(jit_buffer* buf, jit_reg reg, unsigned long long imm) {
+    emit_byte(buf, REX_W);
+    emit_byte(buf, 0xB8 + reg);
+    emit_u64(buf, imm);
+}
+
+// mov reg32, imm32 (zero extends)
+void
+emit_mov_imm32(jit_buffer* buf, jit_reg reg, unsigned imm) {
+    emit_byte(buf, 0xB8 + reg);
+    emit_u32(buf, imm);
+}
+
+// mov dst32, [base + disp]
+void
+emit_load32(jit_buffer* buf, jit_reg dst, jit_reg base, unsigned char disp) {
+    emit_byte(buf, 0x8B);
+    emit_mem(buf, dst, base, disp);
+}
+
+// mov dst, [base + disp]
+void
+emit_load64(jit_buffer* buf, jit_reg dst, jit_reg base, unsigned char disp) {
+    emit_byte(buf, REX_W);
+    emit_byte(buf, 0x8B);
+    emit_mem(buf, dst, base, disp);
+}
+
+// mov [base + disp], src
+void
+emit_store64(jit_buffer* buf, jit_reg base, unsigned char disp, jit_reg src) {
+    emit_byte(buf, REX_W);
+    emit_byte(buf, 0x89);
+    emit_mem(buf, src, base, disp);
+}
+
+// mov [base + disp], src32
+void
+emit_store32(jit_buffer* buf, jit_reg base, unsigned char disp, jit_reg src) {
+    emit_byte(buf, 0x89);
+    emit_mem(buf, src, base, disp);
+}
+
+// mov dword [base + disp], imm32
+void
+emit_store_imm32(jit_buffer* buf, jit_reg base, unsigned char disp, unsigned imm) {
+    emit_byte(buf, 0xC7);
+    emit_mem(buf, 0, base, disp);
+    emit_u32(buf, imm);
+}
+
+// cmp dword [base + disp], imm8
+void
+emit_cmp_mem32_imm8(jit_buffer* buf, jit_reg base, unsigned char disp, unsigned char imm) {
+    emit_byte(buf, 0x83);
+    emit_mem(buf, 7, base, disp);
+    emit_byte(buf, imm);
+}
+
+// cmp byte [base + disp], imm8
+void
+emit_cmp_mem8_imm8(jit_buffer* buf, jit_reg base, unsigned char disp, unsigned char imm) {
+    emit_byte(buf, 0x80);
+    emit_mem(buf, 7, base, disp);
+    emit_byte(buf, imm);
+}
+
+// cmp reg32, imm32
+void
+emit_cmp32_imm(jit_buffer* buf, jit_reg reg, unsigned imm) {
+    emit_byte(buf, 0x81);
+    emit_modrm(buf, 3, 7, reg);
+    emit_u32(buf, imm);
+}
+
+// add reg32, imm32
+void
+emit_add32_imm(jit_buffer* buf, jit_reg reg, unsigned imm) {
+    emit_byte(buf, 0x81);
+    emit_modrm(buf, 3, 0, reg);
+    emit_u32(buf, imm);
+}
+
+// sub reg32, imm32
+void
+emit_sub32_imm(jit_buffer* buf, jit_reg reg, unsigned imm) {
+    emit_byte(buf, 0x81);
+    emit_modrm(buf, 3, 5, reg);
+    emit_u32(buf, imm);
+}
+
+// shl reg, imm8
+void
+emit_shl64_imm(jit_buffer* buf, jit_reg reg, unsigned char imm) {
+    emit_byte(buf, REX_W);
+    emit_byte(buf, 0xC1);
+    emit_modrm(buf, 3, 4, reg);
+    emit_byte(buf, imm);
+}
+
+// add dst, src
+void
+emit_add64(jit_buffer* buf, jit_reg dst, jit_reg src) {
+    emit_byte(buf, REX_W);
+    emit_byte(buf, 0x01);
+    emit_modrm(buf, 3, src, dst);
+}
+
+// test reg8, reg8
+void
+emit_test8(jit_buffer* buf, jit_reg reg) {
+    assert(reg <= JIT_RBX);
+    emit_byte(buf, 0x84);
+    emit_modrm(buf, 3, reg, reg);
+}
+
+// movsd dst, [base + disp]
+void
+emit_movsd_load(jit_buffer* buf, jit_xmm dst, jit_reg base, unsigned char disp) {
+    emit_byte(buf, 0xF2);
+    emit_byte(buf, 0x0F);
+    emit_byte(buf, 0x10);
+    emit_mem(buf, dst, base, disp);
+}
+
+// movsd [base + disp], src
+void
+emit_movsd_store(jit_buffer* buf, jit_reg base, unsigned char disp, jit_xmm src) {
+    emit_byte(buf, 0xF2);
+    emit_byte(buf, 0x0F);
+    emit_byte(buf, 0x11);
+    emit_mem(buf, src, base, disp);
+}
+
+// movq dst, src
+void
+emit_movq_xmm(jit_buffer* buf, jit_xmm dst, jit_reg src) {
+    emit_byte(buf, 0x66);
+    emit_byte(buf, REX_W);
+    emit_byte(buf, 0x0F);
+    emit_byte(buf, 0x6E);
+    emit_modrm(buf, 3, dst, src);
+}
+
+// addsd/subsd/mulsd/divsd dst, src
+void
+emit_sse(jit_buffer* buf, jit_sse_op op, jit_xmm dst, jit_xmm src) {
+    emit_byte(buf, 0xF2);
+    emit_byte(buf, 0x0F);
+    emit_byte(buf, op);
+    emit_modrm(buf, 3, dst, src);
+}
+
+// ucomisd a, b
+void
+emit_ucomisd(jit_buffer* buf, jit_xmm a, jit_xmm b) {
+    emit_byte(buf, 0x66);
+    emit_byte(buf, 0x0F);
+    emit_byte(buf, 0x2E);
+    emit_modrm(buf, 3, a, b);
+}
+
+// call reg
+void
+emit_call_reg(jit_buffer* buf, jit_reg reg) {
+    emit_byte(buf, 0xFF);
+    emit_modrm(buf, 3, 2, reg);
+}
+
+// jmp reg
+void
+emit_jmp_reg(jit_buffer* buf, jit_reg reg) {
+    emit_byte(buf, 0xFF);
+    emit_modrm(buf, 3, 4, reg);
+}
+
+/*
+ * jmp rel32 / jcc rel32 with the displacement left zero. Both return the
+ * offset of the displacement, for emit_patch once the target is known.
+ */
+unsigned long
+emit_jmp(jit_buffer* buf) {
+    emit_byte(buf, 0xE9);
+    unsigned long at = buf->size;
+    emit_u32(buf, 0);
+    return at;
+}
+
+unsigned long
+emit_jcc(jit_buffer* buf, jit_cond cond) {
+    emit_byte(buf, 0x0F);
+    emit_byte(buf, 0x80 + cond);
+    unsigned long at = buf->size;
+    emit_u32(buf, 0);
+    return at;
+}
+
+void
+emit_patch(jit_buffer* buf, unsigned long at, unsigned long target) {
+    int rel = (int) ((long) target - (long) (at + 4));
+    memcpy(buf->base + at, &rel, sizeof(rel));
+}
+
+/* ------------------------------------------- Static Definitions ------------------------------------------- */
+static void
+emit_modrm(jit_buffer* buf, unsigned char mod, unsigned char reg, unsigned char rm) {
+    emit_byte(buf, (mod << 6) | ((reg & 7) << 3) | (rm & 7));
+}
+
+static void
+emit_mem(jit_buffer* buf, unsigned char reg, jit_reg base, unsigned char disp) {
+    // rsp and rbp as a base need a SIB byte or have other meanings
+    assert(base != JIT_RSP && base != JIT_RBP && base <= JIT_RDI);
+    emit_modrm(buf, 1, reg, base);
+    emit_byte(buf, disp);
+}
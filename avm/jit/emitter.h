@@ -0,0 +1,136 @@
+#ifndef EMITTER_H
+#define EMITTER_H
+
+/*
+ * x86-64 machine code emitter. Only the handful of instruction forms the
+ * JIT uses are provided, and memory operands are always [base + disp8]
+ * with base one of rax, rcx, rdx, rsi or rdi.
+ */
+
+typedef enum jit_reg {
+    JIT_RAX, JIT_RCX, JIT_RDX, JIT_RBX,
+    JIT_RSP, JIT_RBP, JIT_RSI, JIT_RDI
+} jit_reg;
+
+typedef enum jit_xmm {
+    JIT_XMM0, JIT_XMM1
+} jit_xmm;
+
+typedef enum jit_cond {
+    JIT_JB  = 0x2,
+    JIT_JAE = 0x3,
+    JIT_JE  = 0x4,
+    JIT_JNE = 0x5,
+    JIT_JBE = 0x6,
+    JIT_JA  = 0x7,
+    JIT_JP  = 0xA,
+    JIT_JNP = 0xB
+} jit_cond;
+
+typedef enum jit_sse_op {
+    JIT_ADDSD = 0x58,
+    JIT_MULSD = 0x59,
+    JIT_SUBSD = 0x5C,
+    JIT_DIVSD = 0x5E
+} jit_sse_op;
+
+typedef struct jit_buffer {
+    unsigned char* base;
+    unsigned long size;
+    unsigned long capacity;
+} jit_buffer;
+
+void
+emit_byte(jit_buffer* buf, unsigned char b);
+
+void
+emit_u32(jit_buffer* buf, unsigned v);
+
+void
+emit_u64(jit_buffer* buf, unsigned long long v);
+
+void
+emit_push(jit_buffer* buf, jit_reg reg);
+
+void
+emit_pop(jit_buffer* buf, jit_reg reg);
+
+void
+emit_ret(jit_buffer* buf);
+
+void
+emit_mov_imm64(jit_buffer* buf, jit_reg reg, unsigned long long imm);
+
+void
+emit_mov_imm32(jit_buffer* buf, jit_reg reg, unsigned imm);
+
+void
+emit_load32(jit_buffer* buf, jit_reg dst, jit_reg base, unsigned char disp);
+
+void
+emit_load64(jit_buffer* buf, jit_reg dst, jit_reg base, unsigned char disp);
+
+void
+emit_store64(jit_buffer* buf, jit_reg base, unsigned char disp, jit_reg src);
+
+void
+emit_store32(jit_buffer* buf, jit_reg base, unsigned char disp, jit_reg src);
+
+void
+emit_store_imm32(jit_buffer* buf, jit_reg base, unsigned char disp, unsigned imm);
+
+void
+emit_cmp_mem32_imm8(jit_buffer* buf, jit_reg base, unsigned char disp, unsigned char imm);
+
+void
+emit_cmp_mem8_imm8(jit_buffer* buf, jit_reg base, unsigned char disp, unsigned char imm);
+
+void
+emit_cmp32_imm(jit_buffer* buf, jit_reg reg, unsigned imm);
+
+void
+emit_add32_imm(jit_buffer* buf, jit_reg reg, unsigned imm);
+
+void
+emit_sub32_imm(jit_buffer* buf, jit_reg reg, unsigned imm);
+
+void
+emit_shl64_imm(jit_buffer* buf, jit_reg reg, unsigned char imm);
+
+void
+emit_add64(jit_buffer* buf, jit_reg dst, jit_reg src);
+
+void
+emit_test8(jit_buffer* buf, jit_reg reg);
+
+void
+emit_movsd_load(jit_buffer* buf, jit_xmm dst, jit_reg base, unsigned char disp);
+
+void
+emit_movsd_store(jit_buffer* buf, jit_reg base, unsigned char disp, jit_xmm src);
+
+void
+emit_movq_xmm(jit_buffer* buf, jit_xmm dst, jit_reg src);
+
+void
+emit_sse(jit_buffer* buf, jit_sse_op op, jit_xmm dst, jit_xmm src);
+
+void
+emit_ucomisd(jit_buffer* buf, jit_xmm a, jit_xmm b);
+
+void
+emit_call_reg(jit_buffer* buf, jit_reg reg);
+
+void
+emit_jmp_reg(jit_buffer* buf, jit_reg reg);
+
+unsigned long
+emit_jmp(jit_buffer* buf);
+
+unsigned long
+emit_jcc(jit_buffer* buf, jit_cond cond);
+
+void
+emit_patch(jit_buffer* buf, unsigned long at, unsigned long target);
+
+#endif
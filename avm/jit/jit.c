@@ -0,0 +1,841 @@
+#include "jit.h"
+#include "emitter.h"
+
+#include "../executors/arithmetic.h"
+#include "../executors/relational.h"
+#include "../executors/assign.h"
+#include "../executors/equal.h"
+#include "../executors/function.h"
+#include "../tables/tables.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <assert.h>
+
+/*
+ * Baseline JIT. Once a user function has been entered JIT_CALL_THRESHOLD
+ * times, its instructions, from the funcenter at its address to the
+ * matching funcexit, are translated to x86-64 code. Functions defined
+ * inside it are left to the interpreter.
+ *
+ * The translation is call-threaded: every instruction calls its executor,
+ * with its loaded opcode, so superinstructions and quickening do not
+ * matter here. Numeric arithmetic, assignments, numeric comparisons and
+ * tests of materialized booleans get an inline fast path behind type
+ * guards, and jumps within the function are native jumps.
+ *
+ * All VM state stays in the vm the code was compiled for, whose address
+ * is built into it, so every compiled instruction is also an entry point. The dispatcher enters native code
+ * whenever pc reaches one, and native code returns to the dispatcher with
+ * pc set when it leaves the function: on calls to user functions, on
+ * funcexit, and on jumps to code that was not compiled.
+ *
+ * Hot loops get traces (see trace.c), compiled by jit_compiletrace. Their
+ * entry is the loop header, so the interpreter switches to a trace in the
+ * middle of a loop the next time it reaches the header.
+ */
+
+#if defined(__x86_64__) && defined(__linux__)
+
+#include <sys/mman.h>
+
+#define JIT_EXIT                ((unsigned) -1)
+#define JIT_NOGUARD             ((unsigned) -1)
+#define JIT_MAX_INSTR_SIZE      256
+#define MEMCELL_TYPE            offsetof(avm_memcell, type)
+#define MEMCELL_DATA            offsetof(avm_memcell, data)
+
+typedef struct jit_fixup {
+    unsigned long at;
+    unsigned target;        // pc, or JIT_EXIT
+} jit_fixup;
+
+typedef struct jit_state {
+    unsigned* callCounts;
+    jit_buffer buffer;
+    unsigned long epilogue;
+} jit_state;
+
+typedef struct jit_function {
+    avm_vm* vm;
+    jit_buffer* buf;
+    unsigned start;
+    unsigned end;
+    unsigned char* own;     // own[i - start]: not part of a nested function
+    unsigned long* labels;  // labels[i - start]: offset of the instruction's code
+    jit_fixup* fixups;
+    unsigned totalFixups;
+    unsigned fixupCapacity;
+} jit_function;
+
+/* ------------------------------------------- Static Declarations ------------------------------------------- */
+static void
+jit_compile(avm_vm* vm, unsigned start);
+
+static unsigned char
+jit_findend(jit_function* f);
+
+static unsigned char
+jit_isown(jit_function* f, unsigned pc);
+
+static void
+jit_protect(jit_state* jit, int prot);
+
+static void
+jit_emit_instruction(jit_function* f, unsigned i);
+
+static void
+jit_emit_traced(jit_function* f, trace_entry* entry, unsigned next);
+
+static void
+jit_emit_arithmetic(jit_function* f, instruction* instr, unsigned guardPc);
+
+static void
+jit_emit_assign(jit_function* f, instruction* instr);
+
+static void
+jit_emit_condjump(jit_function* f, instruction* instr);
+
+static void
+jit_emit_numberbranch(jit_function* f, vmopcode op, unsigned char sense, unsigned target);
+
+static void
+jit_emit_boolbranch(jit_function* f, instruction* instr, unsigned char sense, unsigned target);
+
+static void
+jit_emit_evalbranch(jit_function* f, instruction* instr, unsigned char sense, unsigned target);
+
+static void
+jit_emit_call(jit_function* f, unsigned i);
+
+static void
+jit_emit_executor(jit_function* f, void (*executor)(avm_vm*, instruction*), instruction* instr);
+
+static void
+jit_emit_setpc(jit_function* f, unsigned pc);
+
+static void
+jit_emit_address(jit_function* f, vmarg* arg, jit_reg reg);
+
+static void
+jit_emit_loadnumber(jit_function* f, vmarg* arg, jit_xmm xmm, unsigned long* slow, unsigned* totalSlow);
+
+static unsigned long
+jit_emit_loadbool(jit_function* f, vmarg* arg);
+
+static void
+jit_emit_goto(jit_function* f, unsigned target);
+
+static void
+jit_add_fixup(jit_function* f, unsigned long at, unsigned target);
+
+static void
+jit_resolve_fixups(jit_function* f);
+
+static unsigned char
+is_memory(vmarg* arg);
+
+static unsigned char
+is_constnumber(vmarg* arg);
+
+static unsigned char
+is_constsimple(vmarg* arg);
+
+static unsigned char
+is_numberoperand(vmarg* arg);
+
+static unsigned char
+is_boolcondition(instruction* instr);
+
+static double
+constnumber(jit_function* f, vmarg* arg);
+
+/* ------------------------------------------- Implementation ------------------------------------------- */
+unsigned char
+jit_init(avm_vm* vm) {
+    // the generated code scales stack indices by shifting
+    if (sizeof(avm_memcell) != 16 || MEMCELL_DATA != 8) {
+        return 0;
+    }
+
+    void* mem = mmap(NULL, JIT_CODE_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+    if (mem == MAP_FAILED) {
+        return 0;
+    }
+
+    jit_state* jit = calloc(1, sizeof(jit_state));
+    vm->jitEntries = calloc(vm->codeSize, sizeof(jit_entry));
+
+    if (!jit || !vm->jitEntries || !(jit->callCounts = calloc(vm->codeSize, sizeof(unsigned)))) {
+        printf("Error allocating memory for the jit.\n");
+        exit(1);
+    }
+
+    jit->buffer.base = mem;
+    jit->buffer.size = 0;
+    jit->buffer.capacity = JIT_CODE_SIZE;
+    vm->jit = jit;
+
+    // trampoline: void enter(jit_entry), the push keeps the stack aligned for calls
+    emit_push(&jit->buffer, JIT_RBX);
+    emit_jmp_reg(&jit->buffer, JIT_RDI);
+
+    jit->epilogue = jit->buffer.size;
+    emit_pop(&jit->buffer, JIT_RBX);
+    emit_ret(&jit->buffer);
+
+    jit_protect(jit, PROT_READ | PROT_EXEC);
+    return 1;
+}
+
+void
+jit_destroy(avm_vm* vm) {
+    munmap(vm->jit->buffer.base, vm->jit->buffer.capacity);
+    free(vm->jit->callCounts);
+    free(vm->jit);
+    free(vm->jitEntries);
+    vm->jit = NULL;
+    vm->jitEntries = NULL;
+}
+
+void
+jit_countcall(avm_vm* vm, unsigned funcPc) {
+    if (++vm->jit->callCounts[funcPc] == JIT_CALL_THRESHOLD) {
+        jit_compile(vm, funcPc);
+    }
+}
+
+void
+jit_run(avm_vm* vm, jit_entry entry) {
+    void (*enter)(jit_entry) = (void (*)(jit_entry)) vm->jit->buffer.base;
+    (*enter)(entry);
+}
+
+/*
+ * A trace is one recorded iteration of a hot loop, from its header back to
+ * it, compiled as straight-line code that jumps back to its own start.
+ * Branches become guards that exit to the interpreter at the target the
+ * recording did not take, and instructions recorded with number (or bool)
+ * operands exit at their own pc, before they have done anything, when the
+ * types differ. Everything else calls its executor as in a function.
+ */
+void
+jit_compiletrace(avm_vm* vm, unsigned header, trace_entry* entries, unsigned length) {
+    jit_function f;
+    memset(&f, 0, sizeof(f));
+    f.vm = vm;
+    f.buf = &vm->jit->buffer;
+    f.start = header;
+
+    if (f.buf->capacity - f.buf->size < (unsigned long) length * 2 * JIT_MAX_INSTR_SIZE) {
+        return;
+    }
+
+    jit_protect(vm->jit, PROT_READ | PROT_WRITE);
+
+    unsigned long loop = f.buf->size;
+
+    for (unsigned i = 0; i < length; i++) {
+        jit_emit_traced(&f, &entries[i], i + 1 < length ? entries[i + 1].pc : header);
+    }
+    emit_patch(f.buf, emit_jmp(f.buf), loop);
+
+    jit_resolve_fixups(&f);
+    jit_protect(vm->jit, PROT_READ | PROT_EXEC);
+
+    vm->jitEntries[header] = f.buf->base + loop;
+    free(f.fixups);
+}
+
+/* ------------------------------------------- Static Definitions ------------------------------------------- */
+static void
+jit_compile(avm_vm* vm, unsigned start) {
+    jit_function f;
+    memset(&f, 0, sizeof(f));
+    f.vm = vm;
+    f.buf = &vm->jit->buffer;
+    f.start = start;
+
+    if (!jit_findend(&f)) {
+        return;
+    }
+
+    unsigned total = f.end - f.start + 1;
+
+    // worst case, every instruction also gets an exit stub
+    if (f.buf->capacity - f.buf->size < (unsigned long) total * 2 * JIT_MAX_INSTR_SIZE) {
+        free(f.own);
+        return;
+    }
+
+    f.labels = calloc(total, sizeof(unsigned long));
+
+    if (!f.labels) {
+        printf("Error allocating memory for the jit.\n");
+        exit(1);
+    }
+
+    jit_protect(vm->jit, PROT_READ | PROT_WRITE);
+
+    for (unsigned i = f.start; i <= f.end; i++) {
+        if (!jit_isown(&f, i)) {
+            continue;
+        }
+
+        f.labels[i - f.start] = f.buf->size;
+        jit_emit_instruction(&f, i);
+
+        if (!jit_isown(&f, i + 1)) {
+            jit_emit_goto(&f, i + 1);
+        }
+    }
+
+    jit_resolve_fixups(&f);
+    jit_protect(vm->jit, PROT_READ | PROT_EXEC);
+
+    for (unsigned i = f.start; i <= f.end; i++) {
+        if (jit_isown(&f, i)) {
+            vm->jitEntries[i] = f.buf->base + f.labels[i - f.start];
+        }
+    }
+
+    free(f.own);
+    free(f.labels);
+    free(f.fixups);
+}
+
+static unsigned char
+jit_findend(jit_function* f) {
+    assert(f->vm->code[f->start].origOpcode == funcenter_v);
+
+    unsigned depth = 0;
+
+    for (unsigned i = f->start; i < f->vm->codeSize; i++) {
+        if (f->vm->code[i].origOpcode == funcenter_v) {
+            depth++;
+        }
+        else if (f->vm->code[i].origOpcode == funcexit_v && --depth == 0) {
+            f->end = i;
+            break;
+        }
+    }
+
+    if (depth) {
+        return 0;
+    }
+
+    f->own = calloc(f->end - f->start + 1, sizeof(unsigned char));
+
+    if (!f->own) {
+        printf("Error allocating memory for the jit.\n");
+        exit(1);
+    }
+
+    for (unsigned i = f->start; i <= f->end; i++) {
+        if (f->vm->code[i].origOpcode == funcenter_v) {
+            depth++;
+        }
+
+        f->own[i - f->start] = (depth == 1);
+
+        if (f->vm->code[i].origOpcode == funcexit_v) {
+            depth--;
+        }
+    }
+    return 1;
+}
+
+static unsigned char
+jit_isown(jit_function* f, unsigned pc) {
+    return f->own && pc >= f->start && pc <= f->end && f->own[pc - f->start];
+}
+
+static void
+jit_protect(jit_state* jit, int prot) {
+    if (mprotect(jit->buffer.base, jit->buffer.capacity, prot) != 0) {
+        printf("Error changing the protection of jit code.\n");
+        exit(1);
+    }
+}
+
+static void
+jit_emit_instruction(jit_function* f, unsigned i) {
+    instruction* instr = f->vm->code + i;
+
+    switch (instr->origOpcode) {
+        case assign_v:      jit_emit_assign(f, instr); break;
+        case add_v:
+        case sub_v:
+        case mul_v:
+        case div_v:         jit_emit_arithmetic(f, instr, JIT_NOGUARD); break;
+        case mod_v:         jit_emit_executor(f, execute_arithmetic, instr); break;
+        case jump_v:        jit_emit_goto(f, instr->result.val); break;
+        case jeq_v:
+        case jne_v:
+        case jle_v:
+        case jge_v:
+        case jlt_v:
+        case jgt_v:         jit_emit_condjump(f, instr); break;
+        case call_v:        jit_emit_call(f, i); break;
+        case pusharg_v:     jit_emit_executor(f, execute_pusharg, instr); break;
+        case funcenter_v: {
+            jit_emit_setpc(f, i);
+            jit_emit_executor(f, execute_funcenter, instr);
+            break;
+        }
+        case funcexit_v: {
+            jit_emit_executor(f, execute_funcexit, instr);
+            jit_add_fixup(f, emit_jmp(f->buf), JIT_EXIT);
+            break;
+        }
+        case newtable_v:    jit_emit_executor(f, execute_newtable, instr); break;
+        case tablegetelem_v:jit_emit_executor(f, execute_tablegetelem, instr); break;
+        case tablesetelem_v:jit_emit_executor(f, execute_tablesetelem, instr); break;
+        default:            break; // nop, and the opcodes the compiler never emits
+    }
+}
+
+static void
+jit_emit_traced(jit_function* f, trace_entry* entry, unsigned next) {
+    unsigned i = entry->pc;
+    instruction* instr = f->vm->code + i;
+    vmopcode op = instr->origOpcode;
+
+    switch (op) {
+        case add_v:
+        case sub_v:
+        case mul_v:
+        case div_v: {
+            jit_emit_arithmetic(f, instr, entry->kind == TRACE_NUMBER ? i : JIT_NOGUARD);
+            break;
+        }
+        case jeq_v:
+        case jne_v:
+        case jle_v:
+        case jge_v:
+        case jlt_v:
+        case jgt_v: {
+            unsigned target = instr->result.val;
+
+            if (target == i + 1) {
+                break;
+            }
+
+            // leave the trace on the way the recording did not go
+            unsigned char sense = (next != target);
+            unsigned exit = sense ? target : i + 1;
+
+            if (entry->kind == TRACE_NUMBER) {
+                unsigned long guards[2];
+                unsigned totalGuards = 0;
+
+                jit_emit_loadnumber(f, &instr->arg1, JIT_XMM0, guards, &totalGuards);
+                jit_emit_loadnumber(f, &instr->arg2, JIT_XMM1, guards, &totalGuards);
+
+                for (unsigned g = 0; g < totalGuards; g++) {
+                    jit_add_fixup(f, guards[g], i);
+                }
+                jit_emit_numberbranch(f, op, sense, exit);
+            }
+            else if (entry->kind == TRACE_BOOL) {
+                jit_add_fixup(f, jit_emit_loadbool(f, &instr->arg1), i);
+                jit_emit_boolbranch(f, instr, sense, exit);
+            }
+            else {
+                jit_emit_evalbranch(f, instr, sense, exit);
+            }
+            break;
+        }
+        case jump_v: {
+            assert(next == instr->result.val);
+            break;
+        }
+        default: {
+            // the recording stops at funcenter and funcexit
+            jit_emit_instruction(f, i);
+            break;
+        }
+    }
+}
+
+/*
+ * Both operands numbers and the result not a string (which would need to
+ * be freed): compute in xmm0 and store. Anything else takes the executor,
+ * or with a guardPc exits to the interpreter at it.
+ */
+static void
+jit_emit_arithmetic(jit_function* f, instruction* instr, unsigned guardPc) {
+    static const jit_sse_op ops[] = { JIT_ADDSD, JIT_SUBSD, JIT_MULSD, JIT_DIVSD };
+
+    if (!is_numberoperand(&instr->arg1) || !is_numberoperand(&instr->arg2) || !is_memory(&instr->result)) {
+        jit_emit_executor(f, execute_arithmetic, instr);
+        return;
+    }
+
+    unsigned long slow[3];
+    unsigned totalSlow = 0;
+
+    jit_emit_loadnumber(f, &instr->arg1, JIT_XMM0, slow, &totalSlow);
+    jit_emit_loadnumber(f, &instr->arg2, JIT_XMM1, slow, &totalSlow);
+    emit_sse(f->buf, ops[instr->origOpcode - add_v], JIT_XMM0, JIT_XMM1);
+
+    jit_emit_address(f, &instr->result, JIT_RCX);
+    emit_cmp_mem32_imm8(f->buf, JIT_RCX, MEMCELL_TYPE, string_m);
+    slow[totalSlow++] = emit_jcc(f->buf, JIT_JE);
+    emit_store_imm32(f->buf, JIT_RCX, MEMCELL_TYPE, number_m);
+    emit_movsd_store(f->buf, JIT_RCX, MEMCELL_DATA, JIT_XMM0);
+
+    if (guardPc != JIT_NOGUARD) {
+        for (unsigned i = 0; i < totalSlow; i++) {
+            jit_add_fixup(f, slow[i], guardPc);
+        }
+        return;
+    }
+
+    unsigned long done = emit_jmp(f->buf);
+
+    for (unsigned i = 0; i < totalSlow; i++) {
+        emit_patch(f->buf, slow[i], f->buf->size);
+    }
+    jit_emit_executor(f, execute_arithmetic, instr);
+    emit_patch(f->buf, done, f->buf->size);
+}
+
+/*
+ * Constants other than strings and cells of any type but string and undef
+ * are copied inline, as long as the result is not a string to be freed.
+ * Strings need a copy and undef a warning, so those take the executor.
+ */
+static void
+jit_emit_assign(jit_function* f, instruction* instr) {
+    if (!(is_numberoperand(&instr->arg1) || is_constsimple(&instr->arg1)) ||
+        !is_memory(&instr->result)) {
+        jit_emit_executor(f, execute_assign, instr);
+        return;
+    }
+
+    unsigned long slow[3];
+    unsigned totalSlow = 0;
+
+    if (is_constnumber(&instr->arg1)) {
+        double value = constnumber(f, &instr->arg1);
+        unsigned long long bits;
+        memcpy(&bits, &value, sizeof(bits));
+        emit_mov_imm32(f->buf, JIT_RSI, number_m);
+        emit_mov_imm64(f->buf, JIT_RDX, bits);
+    }
+    else if (instr->arg1.type == bool_a) {
+        emit_mov_imm32(f->buf, JIT_RSI, bool_m);
+        emit_mov_imm64(f->buf, JIT_RDX, instr->arg1.val != 0);
+    }
+    else if (instr->arg1.type == nil_a) {
+        emit_mov_imm32(f->buf, JIT_RSI, nil_m);
+        emit_mov_imm64(f->buf, JIT_RDX, 0);
+    }
+    else {
+        jit_emit_address(f, &instr->arg1, JIT_RCX);
+        emit_load32(f->buf, JIT_RSI, JIT_RCX, MEMCELL_TYPE);
+        emit_cmp32_imm(f->buf, JIT_RSI, string_m);
+        slow[totalSlow++] = emit_jcc(f->buf, JIT_JE);
+        emit_cmp32_imm(f->buf, JIT_RSI, undef_m);
+        slow[totalSlow++] = emit_jcc(f->buf, JIT_JE);
+        emit_load64(f->buf, JIT_RDX, JIT_RCX, MEMCELL_DATA);
+    }
+
+    jit_emit_address(f, &instr->result, JIT_RCX);
+    emit_cmp_mem32_imm8(f->buf, JIT_RCX, MEMCELL_TYPE, string_m);
+    slow[totalSlow++] = emit_jcc(f->buf, JIT_JE);
+    emit_store32(f->buf, JIT_RCX, MEMCELL_TYPE, JIT_RSI);
+    emit_store64(f->buf, JIT_RCX, MEMCELL_DATA, JIT_RDX);
+    unsigned long done = emit_jmp(f->buf);
+
+    for (unsigned i = 0; i < totalSlow; i++) {
+        emit_patch(f->buf, slow[i], f->buf->size);
+    }
+    jit_emit_executor(f, execute_assign, instr);
+    emit_patch(f->buf, done, f->buf->size);
+}
+
+static void
+jit_emit_condjump(jit_function* f, instruction* instr) {
+    vmopcode op = instr->origOpcode;
+    unsigned target = instr->result.val;
+    unsigned long done = 0;
+
+    if (is_numberoperand(&instr->arg1) && is_numberoperand(&instr->arg2)) {
+        unsigned long slow[2];
+        unsigned totalSlow = 0;
+
+        jit_emit_loadnumber(f, &instr->arg1, JIT_XMM0, slow, &totalSlow);
+        jit_emit_loadnumber(f, &instr->arg2, JIT_XMM1, slow, &totalSlow);
+        jit_emit_numberbranch(f, op, 1, target);
+        done = emit_jmp(f->buf);
+
+        for (unsigned i = 0; i < totalSlow; i++) {
+            emit_patch(f->buf, slow[i], f->buf->size);
+        }
+    }
+    else if (is_boolcondition(instr)) {
+        unsigned long slow = jit_emit_loadbool(f, &instr->arg1);
+        jit_emit_boolbranch(f, instr, 1, target);
+        done = emit_jmp(f->buf);
+        emit_patch(f->buf, slow, f->buf->size);
+    }
+
+    jit_emit_evalbranch(f, instr, 1, target);
+
+    if (done) {
+        emit_patch(f->buf, done, f->buf->size);
+    }
+}
+
+/*
+ * Branches to target when the comparison of xmm0 and xmm1 that op makes
+ * equals sense. ucomisd sets ZF, PF and CF on unordered operands, so
+ * ja/jae (CF = 0) are false for NaN as the C comparisons are, jbe/jb are
+ * true, and equality tests PF explicitly.
+ */
+static void
+jit_emit_numberbranch(jit_function* f, vmopcode op, unsigned char sense, unsigned target) {
+    switch (op) {
+        case jlt_v: emit_ucomisd(f->buf, JIT_XMM1, JIT_XMM0); jit_add_fixup(f, emit_jcc(f->buf, sense ? JIT_JA : JIT_JBE), target); break;
+        case jle_v: emit_ucomisd(f->buf, JIT_XMM1, JIT_XMM0); jit_add_fixup(f, emit_jcc(f->buf, sense ? JIT_JAE : JIT_JB), target); break;
+        case jgt_v: emit_ucomisd(f->buf, JIT_XMM0, JIT_XMM1); jit_add_fixup(f, emit_jcc(f->buf, sense ? JIT_JA : JIT_JBE), target); break;
+        case jge_v: emit_ucomisd(f->buf, JIT_XMM0, JIT_XMM1); jit_add_fixup(f, emit_jcc(f->buf, sense ? JIT_JAE : JIT_JB), target); break;
+        case jeq_v:
+        case jne_v: {
+            emit_ucomisd(f->buf, JIT_XMM0, JIT_XMM1);
+
+            if ((op == jeq_v) == sense) {
+                unsigned long unordered = emit_jcc(f->buf, JIT_JP);
+                jit_add_fixup(f, emit_jcc(f->buf, JIT_JE), target);
+                emit_patch(f->buf, unordered, f->buf->size);
+            }
+            else {
+                jit_add_fixup(f, emit_jcc(f->buf, JIT_JP), target);
+                jit_add_fixup(f, emit_jcc(f->buf, JIT_JNE), target);
+            }
+            break;
+        }
+        default: assert(0);
+    }
+}
+
+// materialized conditions, jeq/jne t, true, with t in rcx and known to be a bool
+static void
+jit_emit_boolbranch(jit_function* f, instruction* instr, unsigned char sense, unsigned target) {
+    emit_cmp_mem8_imm8(f->buf, JIT_RCX, MEMCELL_DATA, instr->arg2.val != 0);
+    jit_add_fixup(f, emit_jcc(f->buf, (instr->origOpcode == jeq_v) == sense ? JIT_JE : JIT_JNE), target);
+}
+
+static void
+jit_emit_evalbranch(jit_function* f, instruction* instr, unsigned char sense, unsigned target) {
+    vmopcode op = instr->origOpcode;
+
+    emit_mov_imm64(f->buf, JIT_RDI, (unsigned long long) f->vm);
+    emit_mov_imm64(f->buf, JIT_RSI, (unsigned long long) instr);
+
+    if (op == jeq_v || op == jne_v) {
+        emit_mov_imm64(f->buf, JIT_RAX, (unsigned long long) equal_eval);
+    }
+    else {
+        emit_mov_imm32(f->buf, JIT_RDX, op);
+        emit_mov_imm64(f->buf, JIT_RAX, (unsigned long long) relational_eval);
+    }
+    emit_call_reg(f->buf, JIT_RAX);
+    emit_test8(f->buf, JIT_RAX);
+    jit_add_fixup(f, emit_jcc(f->buf, (op != jne_v) == sense ? JIT_JNE : JIT_JE), target);
+}
+
+/*
+ * A library function returns with pc at the next instruction. A user
+ * function call leaves pc at its funcenter, for the dispatcher to run.
+ */
+static void
+jit_emit_call(jit_function* f, unsigned i) {
+    jit_emit_setpc(f, i);
+    jit_emit_executor(f, execute_call, f->vm->code + i);
+
+    emit_mov_imm64(f->buf, JIT_RAX, (unsigned long long) &f->vm->pc);
+    emit_load32(f->buf, JIT_RAX, JIT_RAX, 0);
+    emit_cmp32_imm(f->buf, JIT_RAX, i + 1);
+    jit_add_fixup(f, emit_jcc(f->buf, JIT_JNE), JIT_EXIT);
+}
+
+static void
+jit_emit_executor(jit_function* f, void (*executor)(avm_vm*, instruction*), instruction* instr) {
+    emit_mov_imm64(f->buf, JIT_RDI, (unsigned long long) f->vm);
+    emit_mov_imm64(f->buf, JIT_RSI, (unsigned long long) instr);
+    emit_mov_imm64(f->buf, JIT_RAX, (unsigned long long) executor);
+    emit_call_reg(f->buf, JIT_RAX);
+}
+
+static void
+jit_emit_setpc(jit_function* f, unsigned newPc) {
+    emit_mov_imm64(f->buf, JIT_RAX, (unsigned long long) &f->vm->pc);
+    emit_store_imm32(f->buf, JIT_RAX, 0, newPc);
+}
+
+// address of a memory operand in reg, clobbers rax
+static void
+jit_emit_address(jit_function* f, vmarg* arg, jit_reg reg) {
+    switch (arg->type) {
+        case global_a: {
+            emit_mov_imm64(f->buf, reg, (unsigned long long) &f->vm->stack[AVM_STACKSIZE - 1 - arg->val]);
+            break;
+        }
+        case retval_a: {
+            emit_mov_imm64(f->buf, reg, (unsigned long long) &f->vm->retval);
+            break;
+        }
+        case local_a:
+        case formal_a: {
+            emit_mov_imm64(f->buf, JIT_RAX, (unsigned long long) &f->vm->topsp);
+            emit_load32(f->buf, JIT_RAX, JIT_RAX, 0);
+
+            if (arg->type == local_a) {
+                emit_sub32_imm(f->buf, JIT_RAX, arg->val);
+            }
+            else {
+                emit_add32_imm(f->buf, JIT_RAX, AVM_STACKENV_SIZE + 1 + arg->val);
+            }
+
+            emit_shl64_imm(f->buf, JIT_RAX, 4);
+            emit_mov_imm64(f->buf, reg, (unsigned long long) f->vm->stack);
+            emit_add64(f->buf, reg, JIT_RAX);
+            break;
+        }
+        default: assert(0);
+    }
+}
+
+// a number operand in xmm, jumping to a slow path recorded in slow if it is not one
+static void
+jit_emit_loadnumber(jit_function* f, vmarg* arg, jit_xmm xmm, unsigned long* slow, unsigned* totalSlow) {
+    if (is_constnumber(arg)) {
+        double value = constnumber(f, arg);
+        unsigned long long bits;
+        memcpy(&bits, &value, sizeof(bits));
+        emit_mov_imm64(f->buf, JIT_RAX, bits);
+        emit_movq_xmm(f->buf, xmm, JIT_RAX);
+        return;
+    }
+
+    jit_emit_address(f, arg, JIT_RCX);
+    emit_cmp_mem32_imm8(f->buf, JIT_RCX, MEMCELL_TYPE, number_m);
+    slow[(*totalSlow)++] = emit_jcc(f->buf, JIT_JNE);
+    emit_movsd_load(f->buf, xmm, JIT_RCX, MEMCELL_DATA);
+}
+
+// the address of a bool operand in rcx, returns the jump to take if it is not one
+static unsigned long
+jit_emit_loadbool(jit_function* f, vmarg* arg) {
+    jit_emit_address(f, arg, JIT_RCX);
+    emit_cmp_mem32_imm8(f->buf, JIT_RCX, MEMCELL_TYPE, bool_m);
+    return emit_jcc(f->buf, JIT_JNE);
+}
+
+static void
+jit_emit_goto(jit_function* f, unsigned target) {
+    jit_add_fixup(f, emit_jmp(f->buf), target);
+}
+
+static void
+jit_add_fixup(jit_function* f, unsigned long at, unsigned target) {
+    if (f->totalFixups == f->fixupCapacity) {
+        f->fixupCapacity = f->fixupCapacity ? f->fixupCapacity * 2 : 64;
+        f->fixups = realloc(f->fixups, f->fixupCapacity * sizeof(jit_fixup));
+
+        if (!f->fixups) {
+            printf("Error allocating memory for the jit.\n");
+            exit(1);
+        }
+    }
+
+    f->fixups[f->totalFixups].at = at;
+    f->fixups[f->totalFixups].target = target;
+    f->totalFixups++;
+}
+
+/*
+ * Jumps within the function go to the target's code. Jumps elsewhere go to
+ * an exit stub that sets pc to the target and returns to the dispatcher.
+ */
+static void
+jit_resolve_fixups(jit_function* f) {
+    for (unsigned i = 0; i < f->totalFixups; i++) {
+        jit_fixup* fixup = &f->fixups[i];
+
+        if (fixup->target == JIT_EXIT) {
+            emit_patch(f->buf, fixup->at, f->vm->jit->epilogue);
+        }
+        else if (jit_isown(f, fixup->target)) {
+            emit_patch(f->buf, fixup->at, f->labels[fixup->target - f->start]);
+        }
+        else {
+            emit_patch(f->buf, fixup->at, f->buf->size);
+            jit_emit_setpc(f, fixup->target);
+            emit_patch(f->buf, emit_jmp(f->buf), f->vm->jit->epilogue);
+        }
+    }
+}
+
+static unsigned char
+is_memory(vmarg* arg) {
+    return arg->type == global_a || arg->type == local_a || arg->type == formal_a || arg->type == retval_a;
+}
+
+static unsigned char
+is_constnumber(vmarg* arg) {
+    return arg->type == number_a || arg->type == immnumber_a;
+}
+
+static unsigned char
+is_constsimple(vmarg* arg) {
+    return arg->type == bool_a || arg->type == nil_a;
+}
+
+static unsigned char
+is_numberoperand(vmarg* arg) {
+    return is_memory(arg) || is_constnumber(arg);
+}
+
+static unsigned char
+is_boolcondition(instruction* instr) {
+    return (instr->origOpcode == jeq_v || instr->origOpcode == jne_v) &&
+        is_memory(&instr->arg1) && instr->arg2.type == bool_a;
+}
+
+static double
+constnumber(jit_function* f, vmarg* arg) {
+    return arg->type == immnumber_a ? (double) (int) arg->val : avm_getnumber(f->vm, arg->val);
+}
+
+#else
+
+unsigned char
+jit_init(avm_vm* vm) {
+    return 0;
+}
+
+void
+jit_destroy(avm_vm* vm) {
+}
+
+void
+jit_countcall(avm_vm* vm, unsigned funcPc) {
+}
+
+void
+jit_run(avm_vm* vm, jit_entry entry) {
+    assert(0);
+}
+
+void
+jit_compiletrace(avm_vm* vm, unsigned header, trace_entry* entries, unsigned length) {
+}
+
+#endif
@@ -0,0 +1,28 @@
+#ifndef JIT_H
+#define JIT_H
+
+#include "../avm_types.h"
+#include "trace.h"
+
+#define JIT_CALL_THRESHOLD  10
+#define JIT_CODE_SIZE       (16 * 1024 * 1024)
+
+// native code of each compiled instruction, vm->jitEntries[pc], NULL if none
+typedef void* jit_entry;
+
+unsigned char
+jit_init(avm_vm* vm);
+
+void
+jit_destroy(avm_vm* vm);
+
+void
+jit_countcall(avm_vm* vm, unsigned funcPc);
+
+void
+jit_run(avm_vm* vm, jit_entry entry);
+
+void
+jit_compiletrace(avm_vm* vm, unsigned header, trace_entry* entries, unsigned length);
+
+#endif
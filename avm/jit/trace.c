@@ -0,0 +1,196 @@
+#include "trace.h"
+#include "jit.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+
+/*
+ * Loop trace recorder. The dispatcher reports every backward transfer of
+ * control, and those made by a jump or a conditional branch count towards
+ * the loop header they land on. When a header gets hot, the dispatcher
+ * runs the next iteration one loaded instruction at a time, reporting each
+ * one before and after it executes, and the recorder keeps the pc and the
+ * operand types seen.
+ *
+ * Getting back to the header completes the trace and hands it to the JIT.
+ * Calling into a user function, leaving the function the loop is in, or
+ * running too long (an inner loop) aborts it, and a header that aborts
+ * TRACE_MAX_ABORTS times is not recorded again.
+ */
+
+typedef struct trace_state {
+    unsigned* loopCounts;
+    unsigned char* aborts;
+
+    unsigned char recording;
+    unsigned header;
+    trace_entry entries[TRACE_MAX_LENGTH];
+    unsigned totalEntries;
+} trace_state;
+
+/* ------------------------------------------- Static Declarations ------------------------------------------- */
+static unsigned char
+trace_isbackedge(avm_vm* vm, unsigned from, unsigned to);
+
+static void
+trace_abort(trace_state* trace);
+
+static trace_kind
+trace_kindof(avm_vm* vm, instruction* instr);
+
+static unsigned char
+is_memory(vmarg* arg);
+
+static unsigned char
+is_number(avm_vm* vm, vmarg* arg);
+
+/* ------------------------------------------- Implementation ------------------------------------------- */
+void
+trace_init(avm_vm* vm) {
+    trace_state* trace = calloc(1, sizeof(trace_state));
+
+    if (!trace ||
+        !(trace->loopCounts = calloc(vm->codeSize, sizeof(unsigned))) ||
+        !(trace->aborts = calloc(vm->codeSize, sizeof(unsigned char)))) {
+        printf("Error allocating memory for the trace recorder.\n");
+        exit(1);
+    }
+    vm->trace = trace;
+}
+
+void
+trace_destroy(avm_vm* vm) {
+    free(vm->trace->loopCounts);
+    free(vm->trace->aborts);
+    free(vm->trace);
+    vm->trace = NULL;
+}
+
+unsigned char
+trace_isrecording(avm_vm* vm) {
+    return vm->trace->recording;
+}
+
+void
+trace_countloop(avm_vm* vm, unsigned from, unsigned to) {
+    trace_state* trace = vm->trace;
+
+    if (trace->recording || vm->jitEntries[to] || trace->aborts[to] >= TRACE_MAX_ABORTS ||
+        !trace_isbackedge(vm, from, to)) {
+        return;
+    }
+
+    if (++trace->loopCounts[to] == TRACE_LOOP_THRESHOLD) {
+        trace->loopCounts[to] = 0;
+        trace->recording = 1;
+        trace->header = to;
+        trace->totalEntries = 0;
+    }
+}
+
+void
+trace_record(avm_vm* vm, unsigned pc) {
+    trace_state* trace = vm->trace;
+    assert(trace->recording && trace->totalEntries < TRACE_MAX_LENGTH);
+
+    trace->entries[trace->totalEntries].pc = pc;
+    trace->entries[trace->totalEntries].kind = trace_kindof(vm, vm->code + pc);
+    trace->totalEntries++;
+}
+
+void
+trace_recorded(avm_vm* vm, unsigned nextPc) {
+    trace_state* trace = vm->trace;
+    trace_entry* last = &trace->entries[trace->totalEntries - 1];
+    vmopcode op = vm->code[last->pc].origOpcode;
+
+    if (op == funcenter_v || op == funcexit_v || (op == call_v && nextPc != last->pc + 1)) {
+        trace_abort(trace);
+    }
+    else if (nextPc == trace->header) {
+        trace->recording = 0;
+        jit_compiletrace(vm, trace->header, trace->entries, trace->totalEntries);
+    }
+    else if (trace->totalEntries == TRACE_MAX_LENGTH || nextPc >= vm->codeSize) {
+        trace_abort(trace);
+    }
+}
+
+/* ------------------------------------------- Static Definitions ------------------------------------------- */
+
+// a jump or branch to `to`, or a superinstruction whose follower is that jump
+static unsigned char
+trace_isbackedge(avm_vm* vm, unsigned from, unsigned to) {
+    instruction* instr = vm->code + from;
+
+    switch (instr->origOpcode) {
+        case jump_v:
+            return instr->result.val == to;
+        case jeq_v:
+        case jne_v:
+        case jle_v:
+        case jge_v:
+        case jlt_v:
+        case jgt_v:
+            // a loop whose test is at its bottom branches back to its body
+            if (instr->result.val == to) {
+                return 1;
+            }
+            break;
+        default:
+            break;
+    }
+
+    return instr->opcode != instr->origOpcode &&
+        from + 1 < vm->codeSize &&
+        (instr + 1)->origOpcode == jump_v &&
+        (instr + 1)->result.val == to;
+}
+
+static void
+trace_abort(trace_state* trace) {
+    trace->recording = 0;
+    trace->aborts[trace->header]++;
+}
+
+static trace_kind
+trace_kindof(avm_vm* vm, instruction* instr) {
+    switch (instr->origOpcode) {
+        case add_v:
+        case sub_v:
+        case mul_v:
+        case div_v:
+        case jle_v:
+        case jge_v:
+        case jlt_v:
+        case jgt_v: {
+            return is_number(vm, &instr->arg1) && is_number(vm, &instr->arg2) ? TRACE_NUMBER : TRACE_OTHER;
+        }
+        case jeq_v:
+        case jne_v: {
+            if (is_number(vm, &instr->arg1) && is_number(vm, &instr->arg2)) {
+                return TRACE_NUMBER;
+            }
+            if (instr->arg2.type == bool_a && is_memory(&instr->arg1) &&
+                avm_translate_operand(vm, &instr->arg1, NULL)->type == bool_m) {
+                return TRACE_BOOL;
+            }
+            return TRACE_OTHER;
+        }
+        default: return TRACE_OTHER;
+    }
+}
+
+static unsigned char
+is_memory(vmarg* arg) {
+    return arg->type == global_a || arg->type == local_a || arg->type == formal_a || arg->type == retval_a;
+}
+
+static unsigned char
+is_number(avm_vm* vm, vmarg* arg) {
+    if (arg->type == number_a || arg->type == immnumber_a) {
+        return 1;
+    }
+    return is_memory(arg) && avm_translate_operand(vm, arg, NULL)->type == number_m;
+}
@@ -0,0 +1,39 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include "../avm_types.h"
+
+#define TRACE_LOOP_THRESHOLD    50
+#define TRACE_MAX_LENGTH        512
+#define TRACE_MAX_ABORTS        3
+
+typedef enum trace_kind {
+    TRACE_OTHER,
+    TRACE_NUMBER,   // number operands when recorded
+    TRACE_BOOL      // jeq/jne of a bool against a bool constant when recorded
+} trace_kind;
+
+typedef struct trace_entry {
+    unsigned pc;
+    trace_kind kind;
+} trace_entry;
+
+void
+trace_init(avm_vm* vm);
+
+void
+trace_destroy(avm_vm* vm);
+
+unsigned char
+trace_isrecording(avm_vm* vm);
+
+void
+trace_countloop(avm_vm* vm, unsigned from, unsigned to);
+
+void
+trace_record(avm_vm* vm, unsigned pc);
+
+void
+trace_recorded(avm_vm* vm, unsigned nextPc);
+
+#endif
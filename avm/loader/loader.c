@@ -1,5 +1,6 @@
 #include "../avm_types.h"
 #include "loader.h"
+#include "../quicken/quicken.h"
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -22,53 +23,51 @@ typedef struct avm_constants {
     unsigned totalGlobals;
 } avm_constants;
 
-static FILE* binaryFile = NULL;
-
 /* ------------------------------------------ Static Declarations ------------------------------------------ */
-static void
+static FILE*
 open_binaryFile(char* filename);
 
 static void
-read_magicNumber();
+read_magicNumber(FILE* binaryFile);
 
 static void
-read_strings(avm_constants* consts);
+read_strings(FILE* binaryFile, avm_constants* consts);
 
 static void
 print_strings(avm_constants* consts);
 
 static void
-read_nums(avm_constants* consts);
+read_nums(FILE* binaryFile, avm_constants* consts);
 
 static void
 print_nums(avm_constants* consts);
 
 static void
-read_userfuncs(avm_constants* consts);
+read_userfuncs(FILE* binaryFile, avm_constants* consts);
 
 static void
 print_userfuncs(avm_constants* consts);
 
 static void
-read_libfuncs(avm_constants* consts);
+read_libfuncs(FILE* binaryFile, avm_constants* consts);
 
 static void
 print_libfuncs(avm_constants* consts);
 
 static void
-read_instructions(avm_constants* consts);
+read_instructions(FILE* binaryFile, avm_constants* consts);
 
 static void
 print_instructions(avm_constants* consts);
 
 static void
-read_totalGlobals(avm_constants* consts);
+read_totalGlobals(FILE* binaryFile, avm_constants* consts);
 
 static void
 print_totalGlobals(avm_constants* consts);
 
 static void
-read_vmarg(vmarg* arg);
+read_vmarg(FILE* binaryFile, vmarg* arg);
 
 static char*
 vmarg_to_string(vmarg arg);
@@ -82,10 +81,16 @@ vmarg_type_to_string(vmarg_t type);
 /* ------------------------------------------ Implementation ------------------------------------------ */
 avm_constants*
 loader_load_avm_constants(char* filename) {
+    FILE* binaryFile = open_binaryFile(filename);
+    avm_constants* consts = loader_read_avm_constants(binaryFile);
+    fclose(binaryFile);
+    return consts;
+}
 
-    open_binaryFile(filename);
-
-    read_magicNumber();
+// reads the constants from an already open binary, e.g. one embedded in memory
+avm_constants*
+loader_read_avm_constants(FILE* binaryFile) {
+    read_magicNumber(binaryFile);
 
     avm_constants* consts;
 
@@ -95,12 +100,12 @@ loader_load_avm_constants(char* filename) {
         exit(1);
     }
 
-    read_strings(consts);
-    read_nums(consts);
-    read_userfuncs(consts);
-    read_libfuncs(consts);
-    read_instructions(consts);
-    read_totalGlobals(consts);
+    read_strings(binaryFile, consts);
+    read_nums(binaryFile, consts);
+    read_userfuncs(binaryFile, consts);
+    read_libfuncs(binaryFile, consts);
+    read_instructions(binaryFile, consts);
+    read_totalGlobals(binaryFile, consts);
 
     // print_strings(consts);
     // print_nums(consts);
@@ -112,12 +117,37 @@ loader_load_avm_constants(char* filename) {
     return consts;
 }
 
+void
+loader_destroy_avm_constants(avm_constants* consts) {
+    for (unsigned i = 0; i < consts->totalStringConsts; i++) {
+        free(consts->stringConsts[i]);
+    }
+    for (unsigned i = 0; i < consts->totalNamedLibFuncs; i++) {
+        free(consts->namedLibFuncs[i]);
+    }
+    for (unsigned i = 0; i < consts->totalUserFuncs; i++) {
+        free(consts->userFuncs[i].id);
+    }
+    free(consts->stringConsts);
+    free(consts->namedLibFuncs);
+    free(consts->userFuncs);
+    free(consts->numConsts);
+    free(consts->instructions);
+    free(consts);
+}
+
 double
 loader_consts_getnumber(avm_constants* consts, unsigned index) {
     assert(consts && consts->numConsts && (index < consts->totalNumConsts));
     return consts->numConsts[index];
 }
 
+unsigned
+loader_getTotalUserFuncs(avm_constants* consts) {
+    assert(consts);
+    return consts->totalUserFuncs;
+}
+
 userfunc
 loader_consts_getuserfunc(avm_constants* consts, unsigned index) {
     assert(consts && consts->userFuncs && (index < consts->totalUserFuncs));
@@ -154,18 +184,24 @@ loader_getcodeSize(avm_constants* consts) {
     return consts->totalInstructions;
 }
 
+const char*
+loader_vmopcodeToString(vmopcode op) {
+    return vmopcode_to_string(op);
+}
+
 /* ------------------------------------------ Static Definitions ------------------------------------------ */
-static void
+static FILE*
 open_binaryFile(char* filename) {
-    binaryFile = fopen(filename, "r");
+    FILE* binaryFile = fopen(filename, "r");
     if (!binaryFile) {
         printf("Error opening binary file.\n");
         exit(1);
     }
+    return binaryFile;
 }
 
 static void
-read_magicNumber() {
+read_magicNumber(FILE* binaryFile) {
     unsigned magicNumber;
     if (fscanf(binaryFile, "%u", &magicNumber) != 1) {
         printf("Error reading magic number.\n");
@@ -179,7 +215,7 @@ read_magicNumber() {
 }
 
 static void
-read_strings(avm_constants* consts) {
+read_strings(FILE* binaryFile, avm_constants* consts) {
     char** stringConsts;
     unsigned totalStrings;
 
@@ -235,7 +271,7 @@ print_strings(avm_constants* consts) {
 }
 
 static void
-read_nums(avm_constants* consts) {
+read_nums(FILE* binaryFile, avm_constants* consts) {
     unsigned totalNums;
     double* numConsts;
 
@@ -271,7 +307,7 @@ print_nums(avm_constants* consts) {
 }
 
 static void
-read_userfuncs(avm_constants* consts) {
+read_userfuncs(FILE* binaryFile, avm_constants* consts) {
     unsigned totalUserfuncs;
     userfunc* userfuncs;
 
@@ -345,7 +381,7 @@ print_userfuncs(avm_constants* consts) {
 }
 
 static void
-read_libfuncs(avm_constants* consts) {
+read_libfuncs(FILE* binaryFile, avm_constants* consts) {
     char** libfuncs;
     unsigned totalLibs;
 
@@ -401,7 +437,7 @@ print_libfuncs(avm_constants* consts) {
 }
 
 static void
-read_instructions(avm_constants* consts) {
+read_instructions(FILE* binaryFile, avm_constants* consts) {
     unsigned codesize;
     instruction* code;
     
@@ -425,11 +461,13 @@ read_instructions(avm_constants* consts) {
             exit(1);
         }
 
-        read_vmarg(&result);
-        read_vmarg(&arg1);
-        read_vmarg(&arg2);
+        read_vmarg(binaryFile, &result);
+        read_vmarg(binaryFile, &arg1);
+        read_vmarg(binaryFile, &arg2);
 
         code[i].opcode = opcode;
+        code[i].origOpcode = quicken_genericOpcode(opcode);
+        code[i].deopts = 0;
         code[i].result = result;
         code[i].arg1 = arg1;
         code[i].arg2 = arg2;
@@ -462,7 +500,7 @@ print_instructions(avm_constants* consts) {
 }
 
 static void
-read_totalGlobals(avm_constants* consts) {
+read_totalGlobals(FILE* binaryFile, avm_constants* consts) {
     unsigned totalGlobals;
     if (fscanf(binaryFile, "%u", &totalGlobals) != 1) {
         printf("Error reading total globals from binary file.\n");
@@ -477,7 +515,7 @@ print_totalGlobals(avm_constants* consts) {
 }
 
 static void
-read_vmarg(vmarg* arg) {
+read_vmarg(FILE* binaryFile, vmarg* arg) {
     vmarg_t type;
     unsigned value;
 
@@ -510,7 +548,12 @@ vmarg_to_string(vmarg arg) {
         exit(1);
     }
 
-    snprintf(result, 64, "[%s, %u]", type_str, arg.val);
+    if (arg.type == immnumber_a) {
+        snprintf(result, 64, "[%s, %d]", type_str, (int) arg.val);
+    }
+    else {
+        snprintf(result, 64, "[%s, %u]", type_str, arg.val);
+    }
     return result;
 }
 
@@ -542,6 +585,26 @@ vmopcode_to_string(vmopcode op) {
         case tablegetelem_v: return "tablegetelem_v";
         case tablesetelem_v: return "tablesetelem_v";
         case nop_v:          return "nop_v";
+        case arithassign_v:      return "arithassign_v";
+        case assignarith_v:      return "assignarith_v";
+        case assignassign_v:     return "assignassign_v";
+        case assignjump_v:       return "assignjump_v";
+        case jcondjump_v:        return "jcondjump_v";
+        case pushargcall_v:      return "pushargcall_v";
+        case tablegetelemcall_v: return "tablegetelemcall_v";
+        case add_nn_v:           return "add_nn_v";
+        case sub_nn_v:           return "sub_nn_v";
+        case mul_nn_v:           return "mul_nn_v";
+        case div_nn_v:           return "div_nn_v";
+        case mod_nn_v:           return "mod_nn_v";
+        case jle_nn_v:           return "jle_nn_v";
+        case jge_nn_v:           return "jge_nn_v";
+        case jlt_nn_v:           return "jlt_nn_v";
+        case jgt_nn_v:           return "jgt_nn_v";
+        case jeq_nn_v:           return "jeq_nn_v";
+        case jne_nn_v:           return "jne_nn_v";
+        case jeq_ss_v:           return "jeq_ss_v";
+        case jne_ss_v:           return "jne_ss_v";
         default:             return "UNKNOWN_OPCODE";
     }
 }
@@ -560,6 +623,7 @@ vmarg_type_to_string(vmarg_t type) {
         case userfunc_a:   return "userfunc";
         case libfunc_a:    return "libfunc";
         case retval_a:     return "retval";
+        case immnumber_a:  return "immnumber";
         case notype_a:     return "";
         default:           return "unknown";
     }
@@ -1,14 +1,25 @@
 #ifndef LOADER_H
 #define LOADER_H
 
+#include <stdio.h>
+
 typedef struct avm_constants avm_constants;
 
 avm_constants*
 loader_load_avm_constants(char* filename);
 
+avm_constants*
+loader_read_avm_constants(FILE* file);
+
+void
+loader_destroy_avm_constants(avm_constants* consts);
+
 double
 loader_consts_getnumber(avm_constants* consts, unsigned index);
 
+unsigned
+loader_getTotalUserFuncs(avm_constants* consts);
+
 userfunc
 loader_consts_getuserfunc(avm_constants* consts, unsigned index);
 
@@ -27,4 +38,7 @@ loader_getcode(avm_constants* consts);
 unsigned
 loader_getcodeSize(avm_constants* consts);
 
+const char*
+loader_vmopcodeToString(vmopcode op);
+
 #endif
\ No newline at end of file
@@ -7,11 +7,6 @@
 #include <assert.h>
 #include <stdlib.h>
 
-avm_memcell stack[AVM_STACKSIZE];
-avm_memcell ax, bx, cx;
-avm_memcell retval;
-unsigned top, topsp;
-
 static void
 memclear_string(avm_memcell* m);
 
@@ -32,11 +27,20 @@ memclear_func_t memclearFuncs[] = {
 };
 
 void
-memory_initstack(unsigned totalGlobals) {
-    top = AVM_STACKSIZE - 1 - totalGlobals;
+memory_initstack(avm_vm* vm, unsigned totalGlobals) {
+    vm->top = AVM_STACKSIZE - 1 - totalGlobals;
+    vm->topsp = 0;
+    for (int i = 0; i < AVM_STACKSIZE; i++) {
+        memset(&vm->stack[i], 0, sizeof(vm->stack[i]));
+        vm->stack[i].type = undef_m;
+    }
+}
+
+// frees what the cells of the stack still hold
+void
+memory_clearstack(avm_vm* vm) {
     for (int i = 0; i < AVM_STACKSIZE; i++) {
-        memset(&stack[i], 0, sizeof(stack[i]));
-        stack[i].type = undef_m;
+        avm_memcellclear(&vm->stack[i]);
     }
 }
 
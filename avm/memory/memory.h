@@ -1,7 +1,12 @@
 #ifndef MEMORY_H
 #define MEMORY_H
 
+#include "../avm_types.h"
+
+void
+memory_initstack(avm_vm* vm, unsigned totalGlobals);
+
 void
-memory_initstack(unsigned totalGlobals);
+memory_clearstack(avm_vm* vm);
 
 #endif
\ No newline at end of file
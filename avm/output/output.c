@@ -0,0 +1,324 @@
+#include "output.h"
+#include "../avm.h"
+#include "../../common/dtoa/dtoa.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/uio.h>
+
+#define OUTPUT_BLOCK_SIZE   65536
+#define OUTPUT_BATCH        16      // blocks written at once when batching
+
+typedef struct output_block {
+    char data[OUTPUT_BLOCK_SIZE];
+    size_t length;
+    struct output_block* next;
+} output_block;
+
+typedef struct output_state {
+    int fd;
+    output_policy policy;
+    unsigned char batched;
+
+    output_block* first;
+    output_block* last;
+    unsigned totalBlocks;
+    output_block* spare;
+} output_state;
+
+// the vms of the runner's workers share stdout, so each flush is written out whole
+static pthread_mutex_t output_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/* ------------------------------------------- Static Declarations ------------------------------------------- */
+static output_state*
+output_state_get(avm_vm* vm);
+
+static char*
+output_reserve(output_state* state, size_t size);
+
+static void
+output_bytes(output_state* state, const char* bytes, size_t length);
+
+static output_block*
+output_newblock(output_state* state);
+
+static void
+output_flushstate(output_state* state);
+
+static void
+output_flushlines(output_state* state);
+
+static void
+output_writeall(int fd, struct iovec* iov, int count);
+
+/* ------------------------------------------- Implementation ------------------------------------------- */
+void
+output_value(avm_vm* vm, avm_memcell* m) {
+    output_state* state = output_state_get(vm);
+
+    switch (m->type) {
+        case number_m: {
+            char* p = output_reserve(state, DTOA_BUFFER_SIZE);
+            state->last->length += dtoa_format(p, m->data.numVal);
+            break;
+        }
+        case string_m: {
+            output_bytes(state, m->data.strVal, strlen(m->data.strVal));
+            break;
+        }
+        case bool_m: {
+            output_bytes(state, m->data.boolVal ? "true" : "false", m->data.boolVal ? 4 : 5);
+            break;
+        }
+        case table_m:       output_bytes(state, "table", 5); break;
+        case userfunc_m:    output_bytes(state, "userfunc", 8); break;
+        case libfunc_m:     output_bytes(state, m->data.libfuncVal, strlen(m->data.libfuncVal)); break;
+        case nil_m:         output_bytes(state, "nil", 3); break;
+        default:            output_bytes(state, "undef", 5); break;
+    }
+}
+
+void
+output_char(avm_vm* vm, char c) {
+    output_state* state = output_state_get(vm);
+    *output_reserve(state, 1) = c;
+    state->last->length++;
+}
+
+void
+output_printed(avm_vm* vm) {
+    if (vm->output && vm->output->policy == OUTPUT_LINE) {
+        output_flush(vm);
+    }
+}
+
+void
+output_flush(avm_vm* vm) {
+    if (vm->output) {
+        output_flushstate(vm->output);
+    }
+}
+
+void
+output_destroy(avm_vm* vm) {
+    output_state* state = vm->output;
+
+    if (!state) {
+        return;
+    }
+    output_flush(vm);
+
+    free(state->first);
+    while (state->spare) {
+        output_block* next = state->spare->next;
+        free(state->spare);
+        state->spare = next;
+    }
+    free(state);
+    vm->output = NULL;
+}
+
+/* ------------------------------------------- Static Definitions ------------------------------------------- */
+static output_state*
+output_state_get(avm_vm* vm) {
+    if (!vm->output) {
+        output_state* state = calloc(1, sizeof(output_state));
+
+        if (!state) {
+            printf("Error allocating memory for the output.\n");
+            exit(1);
+        }
+
+        state->fd = STDOUT_FILENO;
+        if (vm->options & AVM_OPTION_OUTPUTLINE) {
+            state->policy = OUTPUT_LINE;
+        }
+        else if (vm->options & AVM_OPTION_OUTPUTBLOCK) {
+            state->policy = OUTPUT_BLOCK;
+        }
+        else if (vm->options & AVM_OPTION_OUTPUTEXPLICIT) {
+            state->policy = OUTPUT_EXPLICIT;
+        }
+        else {
+            state->policy = isatty(state->fd) ? OUTPUT_LINE : OUTPUT_BLOCK;
+        }
+        state->batched = (vm->options & AVM_OPTION_WRITEV) != 0;
+
+        state->first = state->last = output_newblock(state);
+        state->totalBlocks = 1;
+        vm->output = state;
+    }
+    return vm->output;
+}
+
+// room for size bytes at the end of the last block, size at most a block
+static char*
+output_reserve(output_state* state, size_t size) {
+    output_block* last = state->last;
+
+    if (OUTPUT_BLOCK_SIZE - last->length >= size) {
+        return last->data + last->length;
+    }
+
+    if (state->policy == OUTPUT_EXPLICIT || (state->batched && state->totalBlocks < OUTPUT_BATCH)) {
+        last->next = output_newblock(state);
+        state->last = last->next;
+        state->totalBlocks++;
+    }
+    else {
+        output_flushlines(state);
+    }
+    return state->last->data + state->last->length;
+}
+
+static void
+output_bytes(output_state* state, const char* bytes, size_t length) {
+    while (length) {
+        size_t room = OUTPUT_BLOCK_SIZE - state->last->length;
+        size_t size;
+
+        if (!room) {
+            output_reserve(state, 1);
+            room = OUTPUT_BLOCK_SIZE - state->last->length;
+        }
+        size = length < room ? length : room;
+
+        memcpy(state->last->data + state->last->length, bytes, size);
+        state->last->length += size;
+        bytes += size;
+        length -= size;
+    }
+}
+
+static output_block*
+output_newblock(output_state* state) {
+    output_block* block = state->spare;
+
+    if (block) {
+        state->spare = block->next;
+    }
+    else if (!(block = malloc(sizeof(output_block)))) {
+        printf("Error allocating memory for the output.\n");
+        exit(1);
+    }
+
+    block->length = 0;
+    block->next = NULL;
+    return block;
+}
+
+static void
+output_flushstate(output_state* state) {
+    struct iovec iov[OUTPUT_BATCH];
+    int count = 0;
+
+    pthread_mutex_lock(&output_lock);
+    for (output_block* block = state->first; block; block = block->next) {
+        if (count == OUTPUT_BATCH) {
+            output_writeall(state->fd, iov, count);
+            count = 0;
+        }
+        if (block->length) {
+            iov[count].iov_base = block->data;
+            iov[count].iov_len = block->length;
+            count++;
+        }
+    }
+    output_writeall(state->fd, iov, count);
+    pthread_mutex_unlock(&output_lock);
+
+    // the first block stays, the others are kept for reuse
+    if (state->first->next) {
+        state->last->next = state->spare;
+        state->spare = state->first->next;
+        state->first->next = NULL;
+    }
+    state->first->length = 0;
+    state->last = state->first;
+    state->totalBlocks = 1;
+}
+
+/*
+ * Writes out what is buffered up to the last newline and keeps the partial
+ * line after it, so that the lines of vms sharing stdout are not torn. A
+ * tail of more than half a block is written out with the rest.
+ */
+static void
+output_flushlines(output_state* state) {
+    output_block* lineEnd = NULL;
+    size_t end = 0;
+    size_t tail;
+
+    for (output_block* block = state->first; block; block = block->next) {
+        for (size_t i = block->length; i > 0; i--) {
+            if (block->data[i - 1] == '\n') {
+                lineEnd = block;
+                end = i;
+                break;
+            }
+        }
+    }
+    if (!lineEnd) {
+        output_flushstate(state);
+        return;
+    }
+
+    tail = lineEnd->length - end;
+    for (output_block* block = lineEnd->next; block; block = block->next) {
+        tail += block->length;
+    }
+    if (tail > OUTPUT_BLOCK_SIZE / 2) {
+        output_flushstate(state);
+        return;
+    }
+
+    output_block* rest = lineEnd->next;
+    size_t length = lineEnd->length;
+
+    lineEnd->length = end;
+    lineEnd->next = NULL;
+    state->last = lineEnd;
+    output_flushstate(state);
+
+    // blocks written out keep their data until reused, so the tail is moved from them
+    output_block* first = state->first;
+    memmove(first->data, lineEnd->data + end, length - end);
+    first->length = length - end;
+
+    while (rest) {
+        output_block* next = rest->next;
+
+        memcpy(first->data + first->length, rest->data, rest->length);
+        first->length += rest->length;
+        rest->next = state->spare;
+        state->spare = rest;
+        rest = next;
+    }
+}
+
+static void
+output_writeall(int fd, struct iovec* iov, int count) {
+    while (count) {
+        ssize_t written = count == 1 ? write(fd, iov->iov_base, iov->iov_len) : writev(fd, iov, count);
+
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return;
+        }
+        while (count && (size_t) written >= iov->iov_len) {
+            written -= iov->iov_len;
+            iov++;
+            count--;
+        }
+        if (count) {
+            iov->iov_base = (char*) iov->iov_base + written;
+            iov->iov_len -= written;
+        }
+    }
+}
@@ -0,0 +1,37 @@
+#ifndef OUTPUT_H
+#define OUTPUT_H
+
+#include "../avm_types.h"
+
+/*
+ * What print writes to stdout. Values are formatted straight into the vm's
+ * output buffer, which is written out according to the policy:
+ *     line      after every print, the default on a terminal
+ *     block     when a buffer block is full, up to its last whole line, the
+ *               default otherwise
+ *     explicit  only on flush() and when the vm is destroyed
+ * With batching, full blocks are kept and written together with writev.
+ */
+typedef enum output_policy {
+    OUTPUT_LINE,
+    OUTPUT_BLOCK,
+    OUTPUT_EXPLICIT
+} output_policy;
+
+void
+output_value(avm_vm* vm, avm_memcell* m);
+
+void
+output_char(avm_vm* vm, char c);
+
+// the end of a print, where the line policy flushes
+void
+output_printed(avm_vm* vm);
+
+void
+output_flush(avm_vm* vm);
+
+void
+output_destroy(avm_vm* vm);
+
+#endif
@@ -0,0 +1,53 @@
+#include "quicken.h"
+
+#include <stdio.h>
+#include <assert.h>
+
+/*
+ * Generic executors call quicken_rewrite once they have seen the operand
+ * types of an instruction, replacing it in place with an opcode specialized
+ * for those types. The specialized executors only check a guard, and call
+ * quicken_deoptimize when it fails. Sites that keep failing their guards
+ * are polymorphic and stay generic after QUICKEN_MAX_DEOPTS attempts.
+ *
+ * Only instructions that still carry their loaded opcode are rewritten, so
+ * superinstructions are never replaced.
+ *
+ * The compiler emits quickened opcodes itself where it proved the operand
+ * types. The loader gives those instructions the generic opcode as their
+ * loaded one, so they deoptimize like any other.
+ */
+
+void
+quicken_rewrite(instruction* instr, vmopcode quickOpcode) {
+    if (instr->opcode == instr->origOpcode && instr->deopts < QUICKEN_MAX_DEOPTS) {
+        instr->opcode = quickOpcode;
+    }
+}
+
+void
+quicken_deoptimize(instruction* instr) {
+    assert(instr->opcode != instr->origOpcode);
+    instr->opcode = instr->origOpcode;
+    instr->deopts++;
+}
+
+vmopcode
+quicken_genericOpcode(vmopcode op) {
+    switch (op) {
+        case add_nn_v:  return add_v;
+        case sub_nn_v:  return sub_v;
+        case mul_nn_v:  return mul_v;
+        case div_nn_v:  return div_v;
+        case mod_nn_v:  return mod_v;
+        case jle_nn_v:  return jle_v;
+        case jge_nn_v:  return jge_v;
+        case jlt_nn_v:  return jlt_v;
+        case jgt_nn_v:  return jgt_v;
+        case jeq_nn_v:
+        case jeq_ss_v:  return jeq_v;
+        case jne_nn_v:
+        case jne_ss_v:  return jne_v;
+        default:        return op;
+    }
+}
@@ -0,0 +1,18 @@
+#ifndef QUICKEN_H
+#define QUICKEN_H
+
+#include "../avm_types.h"
+
+#define QUICKEN_MAX_DEOPTS 4
+
+void
+quicken_rewrite(instruction* instr, vmopcode quickOpcode);
+
+void
+quicken_deoptimize(instruction* instr);
+
+// the generic opcode a quickened one falls back to, the opcode itself if it is not quickened
+vmopcode
+quicken_genericOpcode(vmopcode op);
+
+#endif
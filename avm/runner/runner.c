@@ -0,0 +1,297 @@
+#include "runner.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "../avm.h"
+#include "../executors/function.h"
+#include "../io/io.h"
+
+/*
+ * Jobs run as coroutines of the workers' vms, M of them over N threads.
+ * Each worker is a vm of its own over the shared image, so its stack,
+ * registers, tables and JIT code are never touched by another thread.
+ *
+ * The jobs are dealt out to per-worker deques up front. A worker takes new
+ * jobs from the front of its own deque, and when that runs dry it steals
+ * from the back of the others'. A job that yields goes to the back of its
+ * worker's ready queue and is resumed in turn, and one that waits on I/O
+ * is resumed once the worker's event loop has done it. Started jobs have
+ * tables and frames in their worker's vm, so only jobs that have not
+ * started move between workers. Each result is stored in the job's slot,
+ * and the deque locks are only taken to get a new job.
+ */
+
+#define RUNNER_MAX_TASKS    1024    // started and unfinished jobs of a worker
+
+typedef struct runner_deque {
+    pthread_mutex_t lock;
+    unsigned head, tail;    // its jobs are [head, tail)
+} runner_deque;
+
+typedef struct runner_jobs {
+    struct avm_constants* image;
+    char* entry;
+    unsigned options;
+
+    char** lines;
+    char** results;
+    unsigned totalJobs;
+
+    runner_deque* deques;
+    unsigned workers;
+} runner_jobs;
+
+typedef struct runner_worker_arg {
+    runner_jobs* jobs;
+    unsigned self;
+} runner_worker_arg;
+
+typedef struct runner_task {
+    unsigned co;
+    unsigned job;
+} runner_task;
+
+/* ------------------------------------------- Static Declarations ------------------------------------------- */
+static void*
+runner_worker(void* arg);
+
+static unsigned char
+runner_take(runner_jobs* jobs, unsigned self, unsigned* job);
+
+static unsigned char
+runner_finished(avm_vm* vm, runner_jobs* jobs, runner_task* task);
+
+static void
+runner_setjob(unsigned** jobOf, unsigned* size, unsigned co, unsigned job);
+
+static char**
+runner_readlines(FILE* in, unsigned* total);
+
+static char*
+runner_result(avm_memcell* m);
+
+/* ------------------------------------------- Implementation ------------------------------------------- */
+void
+runner_run(char* binFilename, char* entry, unsigned workers, unsigned options, FILE* in, FILE* out) {
+    runner_jobs jobs;
+    pthread_t* threads = malloc(workers * sizeof(pthread_t));
+    runner_worker_arg* args = malloc(workers * sizeof(runner_worker_arg));
+
+    jobs.image = avm_loadshared(binFilename);
+    jobs.entry = entry;
+    jobs.options = options;
+    jobs.lines = runner_readlines(in, &jobs.totalJobs);
+    jobs.results = calloc(jobs.totalJobs ? jobs.totalJobs : 1, sizeof(char*));
+    jobs.deques = malloc(workers * sizeof(runner_deque));
+    jobs.workers = workers;
+
+    if (!threads || !args || !jobs.results || !jobs.deques) {
+        printf("Error allocating memory for the workers.\n");
+        exit(1);
+    }
+
+    for (unsigned i = 0; i < workers; i++) {
+        pthread_mutex_init(&jobs.deques[i].lock, NULL);
+        jobs.deques[i].head = (unsigned long long) jobs.totalJobs * i / workers;
+        jobs.deques[i].tail = (unsigned long long) jobs.totalJobs * (i + 1) / workers;
+        args[i].jobs = &jobs;
+        args[i].self = i;
+    }
+
+    for (unsigned i = 0; i < workers; i++) {
+        if (pthread_create(&threads[i], NULL, runner_worker, &args[i]) != 0) {
+            printf("Error starting worker %u.\n", i);
+            exit(1);
+        }
+    }
+    for (unsigned i = 0; i < workers; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    for (unsigned i = 0; i < jobs.totalJobs; i++) {
+        fprintf(out, "%s\n", jobs.results[i]);
+        free(jobs.results[i]);
+        free(jobs.lines[i]);
+    }
+
+    for (unsigned i = 0; i < workers; i++) {
+        pthread_mutex_destroy(&jobs.deques[i].lock);
+    }
+
+    free(jobs.deques);
+    free(jobs.results);
+    free(jobs.lines);
+    free(args);
+    free(threads);
+    avm_destroyshared(jobs.image);
+}
+
+/* ------------------------------------------- Static Definitions ------------------------------------------- */
+static void*
+runner_worker(void* arg) {
+    runner_jobs* jobs = ((runner_worker_arg*) arg)->jobs;
+    unsigned self = ((runner_worker_arg*) arg)->self;
+    avm_vm* vm = avm_create(jobs->options);
+
+    avm_useshared(vm, jobs->image);
+    avm_run(vm);
+
+    unsigned entry = avm_findfunction(vm, jobs->entry);
+    if (entry == AVM_NOFUNCTION) {
+        printf("No user function named %s.\n", jobs->entry);
+        exit(1);
+    }
+
+    runner_task ready[RUNNER_MAX_TASKS];
+    unsigned first = 0, totalReady = 0;
+    unsigned* jobOf = NULL;     // of the coroutines parked on I/O
+    unsigned jobOfSize = 0;
+    avm_memcell nil;
+    nil.type = nil_m;
+
+    io_enablescheduling(vm);
+
+    while (1) {
+        runner_task task;
+        avm_memcell value;
+        unsigned totalTasks = totalReady + io_totalwaiting(vm);
+
+        if (io_totalwaiting(vm)) {
+            io_wait(vm, totalReady || totalTasks < RUNNER_MAX_TASKS ? 0 : -1);
+        }
+
+        if ((task.co = io_completed(vm, &value))) {
+            task.job = jobOf[task.co];
+            avm_resume(vm, task.co, &value);
+            avm_memcellclear(&value);
+        }
+        else if (totalTasks < RUNNER_MAX_TASKS && runner_take(jobs, self, &task.job)) {
+            avm_memcell line;
+            line.type = string_m;
+            line.data.strVal = jobs->lines[task.job];
+
+            task.co = avm_newcoroutine(vm, entry);
+            avm_resume(vm, task.co, &line);
+        }
+        else if (totalReady) {
+            task = ready[first];
+            first = (first + 1) % RUNNER_MAX_TASKS;
+            totalReady--;
+            avm_resume(vm, task.co, &nil);
+        }
+        else if (io_totalwaiting(vm)) {
+            io_wait(vm, -1);
+            continue;
+        }
+        else {
+            break;
+        }
+
+        if (runner_finished(vm, jobs, &task)) {
+            continue;
+        }
+        if (io_iswaiting(vm, task.co)) {
+            runner_setjob(&jobOf, &jobOfSize, task.co, task.job);
+        }
+        else {
+            ready[(first + totalReady) % RUNNER_MAX_TASKS] = task;
+            totalReady++;
+        }
+    }
+
+    free(jobOf);
+    avm_destroy(vm);
+    return NULL;
+}
+
+// the next job of the worker's own deque, or one stolen from another
+static unsigned char
+runner_take(runner_jobs* jobs, unsigned self, unsigned* job) {
+    for (unsigned i = 0; i < jobs->workers; i++) {
+        runner_deque* deque = &jobs->deques[(self + i) % jobs->workers];
+        unsigned char taken = 0;
+
+        pthread_mutex_lock(&deque->lock);
+        if (deque->head < deque->tail) {
+            *job = i == 0 ? deque->head++ : --deque->tail;
+            taken = 1;
+        }
+        pthread_mutex_unlock(&deque->lock);
+
+        if (taken) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static unsigned char
+runner_finished(avm_vm* vm, runner_jobs* jobs, runner_task* task) {
+    if (!avm_isdead(vm, task->co)) {
+        return 0;
+    }
+
+    jobs->results[task->job] = runner_result(avm_result(vm));
+    avm_freecoroutine(vm, task->co);
+    return 1;
+}
+
+static void
+runner_setjob(unsigned** jobOf, unsigned* size, unsigned co, unsigned job) {
+    if (co >= *size) {
+        unsigned newSize = *size ? *size : 64;
+        while (newSize <= co) {
+            newSize *= 2;
+        }
+        *jobOf = realloc(*jobOf, newSize * sizeof(unsigned));
+        if (!*jobOf) {
+            printf("Error allocating memory for the workers.\n");
+            exit(1);
+        }
+        *size = newSize;
+    }
+    (*jobOf)[co] = job;
+}
+
+// the lines of in without their newlines
+static char**
+runner_readlines(FILE* in, unsigned* total) {
+    unsigned size = 64;
+    char** lines = malloc(size * sizeof(char*));
+    char* line = NULL;
+    size_t capacity = 0;
+    ssize_t length;
+
+    *total = 0;
+    while (lines && (length = getline(&line, &capacity, in)) != -1) {
+        if (length && line[length - 1] == '\n') {
+            line[length - 1] = '\0';
+        }
+        if (*total == size) {
+            size *= 2;
+            lines = realloc(lines, size * sizeof(char*));
+            if (!lines) {
+                break;
+            }
+        }
+        lines[(*total)++] = strdup(line);
+    }
+    free(line);
+
+    if (!lines) {
+        printf("Error allocating memory for the jobs.\n");
+        exit(1);
+    }
+    return lines;
+}
+
+// only numbers and strings have a printed form
+static char*
+runner_result(avm_memcell* m) {
+    if (m->type == number_m || m->type == string_m) {
+        return avm_tostring(m);
+    }
+    return strdup("");
+}
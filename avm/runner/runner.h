@@ -0,0 +1,14 @@
+#ifndef RUNNER_H
+#define RUNNER_H
+
+#include <stdio.h>
+
+/*
+ * Runs the program's entry function once per line of in, with the line as
+ * its argument, on `workers` threads that share the loaded program. What
+ * each call returns is written to out, one line per job in input order.
+ */
+void
+runner_run(char* binFilename, char* entry, unsigned workers, unsigned options, FILE* in, FILE* out);
+
+#endif
@@ -0,0 +1,107 @@
+#include "superinstr.h"
+
+#include <stdio.h>
+#include <assert.h>
+
+/*
+ * Load-time pass that replaces the most frequent opcode pairs with a single
+ * superinstruction. The candidates come from the opcode pair counts that
+ * `avm --profile` reports:
+ *
+ *   assign + assign        x = e; (the assignment expression copies x to a temp)
+ *   assign + add..mod      x++ (save the old value, then increment)
+ *   assign + jump          materializing a relational result
+ *   add..mod + assign      assignments of arithmetic results (++x, x = x + 1)
+ *   jxx + jump             if/while/for conditions
+ *   pusharg... + call      argument pushes followed by their call
+ *   tablegetelem + call    calls through table members (t.f(), t..f())
+ *
+ * Only the first instruction of a sequence is rewritten. The followers are
+ * fused in turn as the start of their own sequence, so a jump that lands in
+ * the middle of a sequence still runs fused code.
+ */
+
+/* ------------------------------------------ Static Declarations ------------------------------------------ */
+static unsigned char
+is_arithmetic(vmopcode op);
+
+static unsigned char
+is_condjump(vmopcode op);
+
+static unsigned
+fuse_at(instruction* code, unsigned codeSize, unsigned i);
+
+static vmopcode
+pair_opcode(vmopcode first, vmopcode second);
+
+/* ------------------------------------------ Implementation ------------------------------------------ */
+void
+superinstr_fuse(instruction* code, unsigned codeSize) {
+    assert(code);
+
+    unsigned i = 0;
+    while (i < codeSize) {
+        i += fuse_at(code, codeSize, i);
+    }
+}
+
+/* ------------------------------------------ Static Definitions ------------------------------------------ */
+static unsigned char
+is_arithmetic(vmopcode op) {
+    return op >= add_v && op <= mod_v;
+}
+
+static unsigned char
+is_condjump(vmopcode op) {
+    return op >= jeq_v && op <= jgt_v;
+}
+
+/*
+ * Tries to start a superinstruction at code[i] and returns where the pass
+ * continues. Runs of pushargs are skipped as a whole, since execution only
+ * ever enters them at their first instruction.
+ */
+static unsigned
+fuse_at(instruction* code, unsigned codeSize, unsigned i) {
+    vmopcode op = code[i].origOpcode;
+
+    if (op == pusharg_v) {
+        unsigned n = 0;
+        while (i + n < codeSize && code[i + n].origOpcode == pusharg_v) {
+            n++;
+        }
+        if (i + n < codeSize && code[i + n].origOpcode == call_v) {
+            code[i].opcode = pushargcall_v;
+            code[i].arg2.val = n;
+        }
+        return n;
+    }
+
+    if (i + 1 < codeSize) {
+        vmopcode superOpcode = pair_opcode(op, code[i + 1].origOpcode);
+        if (superOpcode != nop_v) {
+            code[i].opcode = superOpcode;
+        }
+    }
+
+    return 1;
+}
+
+static vmopcode
+pair_opcode(vmopcode first, vmopcode second) {
+    if (first == assign_v) {
+        if (second == assign_v)         return assignassign_v;
+        if (is_arithmetic(second))      return assignarith_v;
+        if (second == jump_v)           return assignjump_v;
+    }
+    else if (is_arithmetic(first) && second == assign_v) {
+        return arithassign_v;
+    }
+    else if (is_condjump(first) && second == jump_v) {
+        return jcondjump_v;
+    }
+    else if (first == tablegetelem_v && second == call_v) {
+        return tablegetelemcall_v;
+    }
+    return nop_v;
+}
@@ -0,0 +1,9 @@
+#ifndef SUPERINSTR_H
+#define SUPERINSTR_H
+
+#include "../avm_types.h"
+
+void
+superinstr_fuse(instruction* code, unsigned codeSize);
+
+#endif
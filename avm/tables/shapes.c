@@ -0,0 +1,101 @@
+#include "shapes.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * A shape describes the string keys of a record-like table and the slot
+ * each one lives in. Tables that get the same keys in the same order share
+ * a shape, because adding a key follows the transition tree from the empty
+ * root shape. Each vm has its own tree, freed with the vm.
+ *
+ * Layout ids identify a table layout for the inline caches. Every shape
+ * has one, and tables in dictionary mode take fresh ones, all from the
+ * same per-vm counter so that they never collide. Ids start at 1, 0 is
+ * an empty cache.
+ */
+
+/* ------------------------------------------- Static Declarations ------------------------------------------- */
+static avm_shape*
+shapes_new(avm_vm* vm, avm_shape* parent, const char* key);
+
+static void
+shapes_free(avm_shape* shape);
+
+/* ------------------------------------------- Implementation ------------------------------------------- */
+avm_shape*
+shapes_root(avm_vm* vm) {
+    if (!vm->shapeRoot) {
+        vm->shapeRoot = shapes_new(vm, NULL, NULL);
+    }
+    return vm->shapeRoot;
+}
+
+avm_shape*
+shapes_transition(avm_vm* vm, avm_shape* shape, const char* key) {
+    for (avm_shape* child = shape->transitions; child; child = child->sibling) {
+        if (strcmp(child->key, key) == 0) {
+            return child;
+        }
+    }
+
+    avm_shape* child = shapes_new(vm, shape, key);
+    child->sibling = shape->transitions;
+    shape->transitions = child;
+    return child;
+}
+
+int
+shapes_lookup(avm_shape* shape, const char* key) {
+    for (; shape->key; shape = shape->parent) {
+        if (strcmp(shape->key, key) == 0) {
+            return shape->slot;
+        }
+    }
+    return -1;
+}
+
+unsigned
+shapes_newLayoutId(avm_vm* vm) {
+    return ++vm->nextLayoutId;
+}
+
+void
+shapes_destroy(avm_vm* vm) {
+    if (vm->shapeRoot) {
+        shapes_free(vm->shapeRoot);
+        vm->shapeRoot = NULL;
+    }
+}
+
+/* ------------------------------------------- Static Definitions ------------------------------------------- */
+static avm_shape*
+shapes_new(avm_vm* vm, avm_shape* parent, const char* key) {
+    avm_shape* shape = malloc(sizeof(avm_shape));
+
+    if (!shape) {
+        printf("Error allocating memory for new shape.\n");
+        exit(1);
+    }
+
+    shape->id = shapes_newLayoutId(vm);
+    shape->key = key ? strdup(key) : NULL;
+    shape->slot = parent ? parent->totalSlots : 0;
+    shape->totalSlots = parent ? parent->totalSlots + 1 : 0;
+    shape->parent = parent;
+    shape->transitions = NULL;
+    shape->sibling = NULL;
+    return shape;
+}
+
+static void
+shapes_free(avm_shape* shape) {
+    for (avm_shape* child = shape->transitions; child;) {
+        avm_shape* next = child->sibling;
+        shapes_free(child);
+        child = next;
+    }
+    free(shape->key);
+    free(shape);
+}
@@ -0,0 +1,35 @@
+#ifndef SHAPES_H
+#define SHAPES_H
+
+#include "../avm_types.h"
+
+#define AVM_SHAPE_MAXSLOTS 32
+
+typedef struct avm_shape avm_shape;
+
+struct avm_shape {
+    unsigned id;
+    char* key;                  // field added by the transition into this shape
+    unsigned slot;              // slot of key
+    unsigned totalSlots;
+    avm_shape* parent;
+    avm_shape* transitions;     // first child
+    avm_shape* sibling;
+};
+
+avm_shape*
+shapes_root(avm_vm* vm);
+
+avm_shape*
+shapes_transition(avm_vm* vm, avm_shape* shape, const char* key);
+
+int
+shapes_lookup(avm_shape* shape, const char* key);
+
+unsigned
+shapes_newLayoutId(avm_vm* vm);
+
+void
+shapes_destroy(avm_vm* vm);
+
+#endif
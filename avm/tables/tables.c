@@ -1,4 +1,5 @@
 #include "tables.h"
+#include "shapes.h"
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -11,17 +12,44 @@ typedef struct avm_table_bucket {
     avm_table_bucket* next;
 } avm_table_bucket;
 
+/*
+ * String keys live in one of two modes. A table starts out with the empty
+ * shape and keeps its string-keyed values in the dense slots array, in the
+ * order its shape gives. Once it has more than AVM_SHAPE_MAXSLOTS string
+ * keys, or gets a key that is not a string constant of the program, it
+ * switches to dictionary mode: shape becomes NULL and the values move to
+ * the strIndexed buckets for good.
+ *
+ * The bucket arrays are only allocated when the first key of their kind
+ * is inserted.
+ */
 typedef struct avm_table {
     unsigned refCounter;
-    avm_table_bucket* strIndexed[AVM_TABLE_HASHSIZE];
-    avm_table_bucket* numIndexed[AVM_TABLE_HASHSIZE];
+    unsigned layoutId;      // shape->id, or a fresh id per key added in dictionary mode
+    avm_shape* shape;
+    avm_memcell* slots;
+    unsigned slotCapacity;
+    avm_table_bucket** strIndexed;
+    avm_table_bucket** numIndexed;
     unsigned totalStrIndexed;
     unsigned totalNumIndexed;
 } avm_table;
 
+/*
+ * Inline cache of a tablegetelem/tablesetelem whose key is a string constant,
+ * one per instruction. Layout ids are never reused, so a matching id means
+ * the table has the shape the slot was found in, or is the dictionary the
+ * bucket was found in. Buckets are never unlinked while their table lives.
+ */
+typedef struct avm_table_cache {
+    unsigned layoutId;
+    unsigned slot;
+    avm_table_bucket* bucket;   // NULL when the key was found in a shape
+} avm_table_cache;
+
 /* ---------------------------------- Static Declarations ---------------------------------- */
 static avm_table*
-avm_tablenew();
+avm_tablenew(avm_vm* vm);
 
 static void
 avm_tabledestroy(avm_table* t);
@@ -30,7 +58,16 @@ static avm_memcell*
 avm_tablegetelem(avm_table* table, avm_memcell* index);
 
 static void
-avm_tablesetelem(avm_table* table, avm_memcell* index, avm_memcell* content);
+avm_tablesetelem(avm_vm* vm, avm_table* table, avm_memcell* index, avm_memcell* content);
+
+static avm_memcell*
+avm_tablegetstr(avm_table* table, const char* key);
+
+static void
+avm_tablesetstr(avm_vm* vm, avm_table* table, const char* key, avm_memcell* content, unsigned char constKey);
+
+static void
+avm_tabletodictionary(avm_vm* vm, avm_table* table);
 
 static void
 avm_tableIncrementRefCounter(avm_table* t);
@@ -38,12 +75,30 @@ avm_tableIncrementRefCounter(avm_table* t);
 static void
 avm_tableDecrementRefCounter(avm_table* t);
 
-static void
-avm_tablebucketsinit(avm_table_bucket** p);
+static avm_table_bucket**
+avm_tablebucketsnew();
 
 static void
 avm_tablebucketsdestroy(avm_table_bucket** p);
 
+static avm_table_bucket*
+avm_tablebucketnew(avm_memcell* key, avm_memcell* content);
+
+static avm_table_bucket*
+avm_tablelookupstr(avm_table* table, const char* key);
+
+static avm_table_cache*
+avm_tablecache(avm_vm* vm, instruction* instr);
+
+static avm_memcell*
+avm_tablegetelem_cached(avm_vm* vm, avm_table* table, instruction* instr);
+
+static void
+avm_tablesetelem_cached(avm_vm* vm, avm_table* table, instruction* instr, avm_memcell* content);
+
+static void
+avm_tablecache_fill(avm_table_cache* cache, avm_table* table, const char* key);
+
 static unsigned
 hash_string(const char* str);
 
@@ -52,26 +107,24 @@ hash_int(int key);
 
 /* ---------------------------------- Implementation ---------------------------------- */
 void
-execute_newtable(instruction* instr) {
-    avm_memcell* lv = avm_translate_operand(&instr->arg1, NULL);
-    assert(lv && (&stack[top] < lv && lv <= &stack[N - 1]) || lv == &retval);
+execute_newtable(avm_vm* vm, instruction* instr) {
+    avm_memcell* lv = avm_translate_operand(vm, &instr->arg1, NULL);
+    assert(lv && (&vm->stack[vm->top] < lv && lv <= &vm->stack[N - 1]) || lv == &vm->retval);
 
     avm_memcellclear(lv);
 
     lv->type = table_m;
-    lv->data.tableVal = avm_tablenew();
+    lv->data.tableVal = avm_tablenew(vm);
     avm_tableIncrementRefCounter(lv->data.tableVal);
 }
 
 void
-execute_tablegetelem(instruction* instr) {
-    avm_memcell* lv = avm_translate_operand(&instr->result, NULL);
-    avm_memcell* t = avm_translate_operand(&instr->arg1, NULL);
-    avm_memcell* i = avm_translate_operand(&instr->arg2, &ax);
+execute_tablegetelem(avm_vm* vm, instruction* instr) {
+    avm_memcell* lv = avm_translate_operand(vm, &instr->result, NULL);
+    avm_memcell* t = avm_translate_operand(vm, &instr->arg1, NULL);
 
-    assert(lv && (lv > &stack[top] && lv <= &stack[N - 1]) || lv == &retval);
-    assert(t && &stack[N - 1] >= t && t > &stack[top]);
-    assert(i);
+    assert(lv && (lv > &vm->stack[vm->top] && lv <= &vm->stack[N - 1]) || lv == &vm->retval);
+    assert(t && &vm->stack[N - 1] >= t && t > &vm->stack[vm->top]);
 
     avm_memcellclear(lv);
     lv->type = nil_m;
@@ -81,10 +134,19 @@ execute_tablegetelem(instruction* instr) {
         exit(1);
     }
 
-    avm_memcell* content = avm_tablegetelem(t->data.tableVal, i);
+    avm_memcell* content;
+
+    if (instr->arg2.type == string_a) {
+        content = avm_tablegetelem_cached(vm, t->data.tableVal, instr);
+    }
+    else {
+        avm_memcell* i = avm_translate_operand(vm, &instr->arg2, &vm->ax);
+        assert(i);
+        content = avm_tablegetelem(t->data.tableVal, i);
+    }
 
     if (content) {
-        avm_assign(lv, content);
+        avm_assign(vm, lv, content);
     }
     else {
         printf("Key not found.\n");
@@ -93,37 +155,54 @@ execute_tablegetelem(instruction* instr) {
 }
 
 void
-execute_tablesetelem(instruction* instr) {
-    avm_memcell* t = avm_translate_operand(&instr->arg1, NULL);
-    avm_memcell* i = avm_translate_operand(&instr->arg2, &ax);
-    avm_memcell* c = avm_translate_operand(&instr->result, &bx);
+execute_tablesetelem(avm_vm* vm, instruction* instr) {
+    avm_memcell* t = avm_translate_operand(vm, &instr->arg1, NULL);
+    avm_memcell* c = avm_translate_operand(vm, &instr->result, &vm->bx);
 
-    assert(t && &stack[N - 1] >= t && t > &stack[top]);
-    assert(i && c);
+    assert(t && &vm->stack[N - 1] >= t && t > &vm->stack[vm->top]);
+    assert(c);
 
     if (t->type != table_m) {
         printf("illegal use of type as table.\n");
         exit(1);
     }
 
-    avm_tablesetelem(t->data.tableVal, i, c);
+    if (instr->arg2.type == string_a) {
+        avm_tablesetelem_cached(vm, t->data.tableVal, instr, c);
+    }
+    else {
+        avm_memcell* i = avm_translate_operand(vm, &instr->arg2, &vm->ax);
+        assert(i);
+        avm_tablesetelem(vm, t->data.tableVal, i, c);
+    }
 }
 
 /* ---------------------------------- Static Definitions ---------------------------------- */
 static avm_table*
-avm_tablenew() {
-    avm_table* t = malloc(sizeof(avm_table));
-    memset(t, 0, sizeof(t));
+avm_tablenew(avm_vm* vm) {
+    avm_table* t = calloc(1, sizeof(avm_table));
+
+    if (!t) {
+        printf("Error allocating memory for new table.\n");
+        exit(1);
+    }
+
     t->refCounter = 0;
+    t->shape = shapes_root(vm);
+    t->layoutId = t->shape->id;
     t->totalNumIndexed = 0;
     t->totalStrIndexed = 0;
-    avm_tablebucketsinit(t->numIndexed);
-    avm_tablebucketsinit(t->strIndexed);
     return t;
 }
 
 static void
 avm_tabledestroy(avm_table* t) {
+    if (t->shape) {
+        for (unsigned i = 0; i < t->shape->totalSlots; i++) {
+            avm_memcellclear(&t->slots[i]);
+        }
+    }
+    free(t->slots);
     avm_tablebucketsdestroy(t->strIndexed);
     avm_tablebucketsdestroy(t->numIndexed);
     free(t);
@@ -132,34 +211,26 @@ avm_tabledestroy(avm_table* t) {
 static avm_memcell*
 avm_tablegetelem(avm_table* table, avm_memcell* index) {
     avm_table_bucket* curr;
-    avm_table_bucket* prev;
 
     switch (index->type) {
         case string_m: {
-            unsigned int hash = hash_string(index->data.strVal);
-            curr = table->strIndexed[hash];
-
-            while (curr) {
-                prev = curr;
-                if (strcmp(curr->key.data.strVal, index->data.strVal) == 0) {
-                    return &(curr->value);
-                }
-                curr = curr->next;
-            }
-            break;
+            return avm_tablegetstr(table, index->data.strVal);
         }
         case number_m: {
+            if (!table->numIndexed) {
+                return NULL;
+            }
+
             unsigned int hash = hash_int((int)index->data.numVal);
             curr = table->numIndexed[hash];
 
             while (curr) {
-                prev = curr;
                 if (curr->key.data.numVal == index->data.numVal) {
                     return &(curr->value);
                 }
                 curr = curr->next;
             }
-            break;
+            return NULL;
         }
         default: {
             printf("table index type not supported.\n");
@@ -169,55 +240,21 @@ avm_tablegetelem(avm_table* table, avm_memcell* index) {
 }
 
 static void
-avm_tablesetelem(avm_table* table, avm_memcell* index, avm_memcell* content) {
+avm_tablesetelem(avm_vm* vm, avm_table* table, avm_memcell* index, avm_memcell* content) {
 
     avm_table_bucket* curr;
     avm_table_bucket* prev;
 
     switch (index->type) {
         case string_m: {
-            unsigned hash = hash_string(index->data.strVal);
-            curr = table->strIndexed[hash];
-            prev = NULL;
-
-            while (curr) {
-                prev = curr;
-                if (strcmp(curr->key.data.strVal, index->data.strVal) == 0) {
-                    curr->value = *content;
-                    return;
-                }
-                curr = curr->next;
-            }
-            
-            avm_table_bucket* node;
-
-            node = malloc(sizeof(avm_table_bucket));
-
-            if (!node) {
-                printf("Error allocating memory for new bucket node.\n");
-                exit(1);
-            }
-
-            node->next = NULL;
-            node->key = *index;
-            node->value = *content;
-
-            if (content->type == string_m) {
-                node->value.data.strVal = strdup(content->data.strVal);
-            }
-            if (index->type == string_m) {
-                node->key.data.strVal = strdup(index->data.strVal);
-            }
-
-            if (prev == NULL) {
-                table->strIndexed[hash] = node;
-            }
-            else {
-                prev->next = node;
-            }
+            avm_tablesetstr(vm, table, index->data.strVal, content, 0);
             break;
         }
         case number_m: {
+            if (!table->numIndexed) {
+                table->numIndexed = avm_tablebucketsnew();
+            }
+
             unsigned int hash = hash_int((int)index->data.numVal);
             curr = table->numIndexed[hash];
             prev = NULL;
@@ -231,18 +268,7 @@ avm_tablesetelem(avm_table* table, avm_memcell* index, avm_memcell* content) {
                 curr = curr->next;
             }
 
-            avm_table_bucket* node;
-
-            node = malloc(sizeof(avm_table_bucket));
-
-            if (!node) {
-                printf("Error allocating memory for new bucket node.\n");
-                exit(1);
-            }
-
-            node->next = NULL;
-            node->key = *index;
-            node->value = *content;
+            avm_table_bucket* node = avm_tablebucketnew(index, content);
 
             if (prev == NULL) {
                 table->numIndexed[hash] = node;
@@ -250,6 +276,7 @@ avm_tablesetelem(avm_table* table, avm_memcell* index, avm_memcell* content) {
             else {
                 prev->next = node;
             }
+            table->totalNumIndexed++;
             break;
         }
         default: {
@@ -259,6 +286,97 @@ avm_tablesetelem(avm_table* table, avm_memcell* index, avm_memcell* content) {
     }
 }
 
+static avm_memcell*
+avm_tablegetstr(avm_table* table, const char* key) {
+    if (table->shape) {
+        int slot = shapes_lookup(table->shape, key);
+        return slot >= 0 ? &table->slots[slot] : NULL;
+    }
+
+    avm_table_bucket* bucket = avm_tablelookupstr(table, key);
+    return bucket ? &(bucket->value) : NULL;
+}
+
+static void
+avm_tablesetstr(avm_vm* vm, avm_table* table, const char* key, avm_memcell* content, unsigned char constKey) {
+    avm_memcell* existing = avm_tablegetstr(table, key);
+
+    if (existing) {
+        *existing = *content;
+        return;
+    }
+
+    if (table->shape && (!constKey || table->shape->totalSlots >= AVM_SHAPE_MAXSLOTS)) {
+        avm_tabletodictionary(vm, table);
+    }
+
+    if (table->shape) {
+        avm_shape* shape = shapes_transition(vm, table->shape, key);
+
+        if (shape->slot >= table->slotCapacity) {
+            table->slotCapacity = table->slotCapacity ? table->slotCapacity * 2 : 4;
+            table->slots = realloc(table->slots, table->slotCapacity * sizeof(avm_memcell));
+
+            if (!table->slots) {
+                printf("Error allocating memory for table slots.\n");
+                exit(1);
+            }
+        }
+
+        table->slots[shape->slot] = *content;
+
+        if (content->type == string_m) {
+            table->slots[shape->slot].data.strVal = strdup(content->data.strVal);
+        }
+
+        table->shape = shape;
+        table->layoutId = shape->id;
+    }
+    else {
+        avm_memcell index;
+        index.type = string_m;
+        index.data.strVal = (char*) key;
+
+        unsigned hash = hash_string(key);
+        avm_table_bucket* node = avm_tablebucketnew(&index, content);
+        node->next = table->strIndexed[hash];
+        table->strIndexed[hash] = node;
+
+        table->layoutId = shapes_newLayoutId(vm);
+    }
+    table->totalStrIndexed++;
+}
+
+static void
+avm_tabletodictionary(avm_vm* vm, avm_table* table) {
+    assert(table->shape && !table->strIndexed);
+
+    table->strIndexed = avm_tablebucketsnew();
+
+    for (avm_shape* shape = table->shape; shape->key; shape = shape->parent) {
+        avm_table_bucket* node = malloc(sizeof(avm_table_bucket));
+
+        if (!node) {
+            printf("Error allocating memory for new bucket node.\n");
+            exit(1);
+        }
+
+        // the slot value is moved, not copied
+        unsigned hash = hash_string(shape->key);
+        node->key.type = string_m;
+        node->key.data.strVal = strdup(shape->key);
+        node->value = table->slots[shape->slot];
+        node->next = table->strIndexed[hash];
+        table->strIndexed[hash] = node;
+    }
+
+    free(table->slots);
+    table->slots = NULL;
+    table->slotCapacity = 0;
+    table->shape = NULL;
+    table->layoutId = shapes_newLayoutId(vm);
+}
+
 static void
 avm_tableIncrementRefCounter(avm_table* t) {
     ++t->refCounter;
@@ -272,17 +390,25 @@ avm_tableDecrementRefCounter(avm_table* t) {
     }
 }
 
-static void
-avm_tablebucketsinit(avm_table_bucket** p) {
-    for (unsigned i = 0; i < AVM_TABLE_HASHSIZE; i++) {
-        p[i] = NULL;
+static avm_table_bucket**
+avm_tablebucketsnew() {
+    avm_table_bucket** p = calloc(AVM_TABLE_HASHSIZE, sizeof(avm_table_bucket*));
+
+    if (!p) {
+        printf("Error allocating memory for table buckets.\n");
+        exit(1);
     }
+    return p;
 }
 
 static void
 avm_tablebucketsdestroy(avm_table_bucket** p) {
+    if (!p) {
+        return;
+    }
+
     for (unsigned i = 0; i < AVM_TABLE_HASHSIZE; i++) {
-        for (avm_table_bucket* b = *p; b;) {
+        for (avm_table_bucket* b = p[i]; b;) {
             avm_table_bucket* del = b;
             b = b->next;
             avm_memcellclear(&del->key);
@@ -291,6 +417,116 @@ avm_tablebucketsdestroy(avm_table_bucket** p) {
         }
         p[i] = NULL;
     }
+    free(p);
+}
+
+static avm_table_bucket*
+avm_tablebucketnew(avm_memcell* key, avm_memcell* content) {
+    avm_table_bucket* node = malloc(sizeof(avm_table_bucket));
+
+    if (!node) {
+        printf("Error allocating memory for new bucket node.\n");
+        exit(1);
+    }
+
+    node->next = NULL;
+    node->key = *key;
+    node->value = *content;
+
+    if (content->type == string_m) {
+        node->value.data.strVal = strdup(content->data.strVal);
+    }
+    if (key->type == string_m) {
+        node->key.data.strVal = strdup(key->data.strVal);
+    }
+    return node;
+}
+
+static avm_table_bucket*
+avm_tablelookupstr(avm_table* table, const char* key) {
+    if (!table->strIndexed) {
+        return NULL;
+    }
+
+    avm_table_bucket* curr = table->strIndexed[hash_string(key)];
+
+    while (curr) {
+        if (strcmp(curr->key.data.strVal, key) == 0) {
+            return curr;
+        }
+        curr = curr->next;
+    }
+    return NULL;
+}
+
+static avm_table_cache*
+avm_tablecache(avm_vm* vm, instruction* instr) {
+    if (!vm->inlineCaches) {
+        vm->inlineCaches = calloc(vm->codeSize, sizeof(avm_table_cache));
+
+        if (!vm->inlineCaches) {
+            printf("Error allocating memory for inline caches.\n");
+            exit(1);
+        }
+    }
+    return &vm->inlineCaches[instr - vm->code];
+}
+
+static avm_memcell*
+avm_tablegetelem_cached(avm_vm* vm, avm_table* table, instruction* instr) {
+    avm_table_cache* cache = avm_tablecache(vm, instr);
+
+    if (cache->layoutId != table->layoutId) {
+        avm_tablecache_fill(cache, table, avm_getstring(vm, instr->arg2.val));
+
+        if (cache->layoutId != table->layoutId) {
+            return NULL;
+        }
+    }
+    return cache->bucket ? &(cache->bucket->value) : &table->slots[cache->slot];
+}
+
+static void
+avm_tablesetelem_cached(avm_vm* vm, avm_table* table, instruction* instr, avm_memcell* content) {
+    avm_table_cache* cache = avm_tablecache(vm, instr);
+
+    if (cache->layoutId != table->layoutId) {
+        const char* key = avm_getstring(vm, instr->arg2.val);
+
+        // the key is strdup'ed by avm_tablesetstr if it gets inserted
+        avm_tablesetstr(vm, table, key, content, 1);
+        avm_tablecache_fill(cache, table, key);
+        return;
+    }
+
+    if (cache->bucket) {
+        cache->bucket->value = *content;
+    }
+    else {
+        table->slots[cache->slot] = *content;
+    }
+}
+
+static void
+avm_tablecache_fill(avm_table_cache* cache, avm_table* table, const char* key) {
+    cache->layoutId = 0;
+    cache->bucket = NULL;
+
+    if (table->shape) {
+        int slot = shapes_lookup(table->shape, key);
+
+        if (slot >= 0) {
+            cache->layoutId = table->layoutId;
+            cache->slot = slot;
+        }
+    }
+    else {
+        cache->bucket = avm_tablelookupstr(table, key);
+
+        if (cache->bucket) {
+            cache->layoutId = table->layoutId;
+        }
+    }
 }
 
 static unsigned
@@ -312,4 +548,4 @@ hash_int(int key) {
     ukey = (ukey * 2654435761u);
 
     return ukey % AVM_TABLE_HASHSIZE;
-}
\ No newline at end of file
+}
@@ -9,12 +9,12 @@ typedef struct avm_table_bucket avm_table_bucket;
 typedef struct avm_table avm_table;
 
 void
-execute_tablegetelem(instruction* instr);
+execute_tablegetelem(avm_vm* vm, instruction* instr);
 
 void
-execute_tablesetelem(instruction* instr);
+execute_tablesetelem(avm_vm* vm, instruction* instr);
 
 void
-execute_newtable(instruction* instr);
+execute_newtable(avm_vm* vm, instruction* instr);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,437 @@
+#include "dtoa.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+
+/*
+ * Grisu3 (Loitsch, "Printing Floating-Point Numbers Quickly and Accurately
+ * with Integers"): the value and its rounding boundaries are scaled by a
+ * cached power of ten into 64-bit fixed point, and digits are generated
+ * until they identify the value. The rare values it cannot decide on are
+ * formatted with printf at increasing precision instead.
+ */
+
+#define DTOA_HIDDEN_BIT     ((uint64_t) 1 << 52)
+#define DTOA_FRACTION_MASK  (DTOA_HIDDEN_BIT - 1)
+#define DTOA_EXPONENT_BIAS  1075    // 1023 and the 52 bits of the fraction
+#define DTOA_MAX_DIGITS     17
+#define DTOA_MIN_EXPONENT   -60     // the scaled value keeps 32 bits of integral part
+#define DTOA_MAX_EXPONENT   -32
+
+typedef struct dtoa_fp {
+    uint64_t f;
+    int e;
+} dtoa_fp;
+
+typedef struct dtoa_power {
+    uint64_t f;
+    int e;
+    int k;      // the power of ten
+} dtoa_power;
+
+// 10^k normalized and rounded to 64 bits, k = -348, -340, ..., 340
+static const dtoa_power dtoaPowers[] = {
+    { 0xfa8fd5a0081c0288ULL, -1220, -348 },
+    { 0xbaaee17fa23ebf76ULL, -1193, -340 },
+    { 0x8b16fb203055ac76ULL, -1166, -332 },
+    { 0xcf42894a5dce35eaULL, -1140, -324 },
+    { 0x9a6bb0aa55653b2dULL, -1113, -316 },
+    { 0xe61acf033d1a45dfULL, -1087, -308 },
+    { 0xab70fe17c79ac6caULL, -1060, -300 },
+    { 0xff77b1fcbebcdc4fULL, -1034, -292 },
+    { 0xbe5691ef416bd60cULL, -1007, -284 },
+    { 0x8dd01fad907ffc3cULL,  -980, -276 },
+    { 0xd3515c2831559a83ULL,  -954, -268 },
+    { 0x9d71ac8fada6c9b5ULL,  -927, -260 },
+    { 0xea9c227723ee8bcbULL,  -901, -252 },
+    { 0xaecc49914078536dULL,  -874, -244 },
+    { 0x823c12795db6ce57ULL,  -847, -236 },
+    { 0xc21094364dfb5637ULL,  -821, -228 },
+    { 0x9096ea6f3848984fULL,  -794, -220 },
+    { 0xd77485cb25823ac7ULL,  -768, -212 },
+    { 0xa086cfcd97bf97f4ULL,  -741, -204 },
+    { 0xef340a98172aace5ULL,  -715, -196 },
+    { 0xb23867fb2a35b28eULL,  -688, -188 },
+    { 0x84c8d4dfd2c63f3bULL,  -661, -180 },
+    { 0xc5dd44271ad3cdbaULL,  -635, -172 },
+    { 0x936b9fcebb25c996ULL,  -608, -164 },
+    { 0xdbac6c247d62a584ULL,  -582, -156 },
+    { 0xa3ab66580d5fdaf6ULL,  -555, -148 },
+    { 0xf3e2f893dec3f126ULL,  -529, -140 },
+    { 0xb5b5ada8aaff80b8ULL,  -502, -132 },
+    { 0x87625f056c7c4a8bULL,  -475, -124 },
+    { 0xc9bcff6034c13053ULL,  -449, -116 },
+    { 0x964e858c91ba2655ULL,  -422, -108 },
+    { 0xdff9772470297ebdULL,  -396, -100 },
+    { 0xa6dfbd9fb8e5b88fULL,  -369,  -92 },
+    { 0xf8a95fcf88747d94ULL,  -343,  -84 },
+    { 0xb94470938fa89bcfULL,  -316,  -76 },
+    { 0x8a08f0f8bf0f156bULL,  -289,  -68 },
+    { 0xcdb02555653131b6ULL,  -263,  -60 },
+    { 0x993fe2c6d07b7facULL,  -236,  -52 },
+    { 0xe45c10c42a2b3b06ULL,  -210,  -44 },
+    { 0xaa242499697392d3ULL,  -183,  -36 },
+    { 0xfd87b5f28300ca0eULL,  -157,  -28 },
+    { 0xbce5086492111aebULL,  -130,  -20 },
+    { 0x8cbccc096f5088ccULL,  -103,  -12 },
+    { 0xd1b71758e219652cULL,   -77,   -4 },
+    { 0x9c40000000000000ULL,   -50,    4 },
+    { 0xe8d4a51000000000ULL,   -24,   12 },
+    { 0xad78ebc5ac620000ULL,     3,   20 },
+    { 0x813f3978f8940984ULL,    30,   28 },
+    { 0xc097ce7bc90715b3ULL,    56,   36 },
+    { 0x8f7e32ce7bea5c70ULL,    83,   44 },
+    { 0xd5d238a4abe98068ULL,   109,   52 },
+    { 0x9f4f2726179a2245ULL,   136,   60 },
+    { 0xed63a231d4c4fb27ULL,   162,   68 },
+    { 0xb0de65388cc8ada8ULL,   189,   76 },
+    { 0x83c7088e1aab65dbULL,   216,   84 },
+    { 0xc45d1df942711d9aULL,   242,   92 },
+    { 0x924d692ca61be758ULL,   269,  100 },
+    { 0xda01ee641a708deaULL,   295,  108 },
+    { 0xa26da3999aef774aULL,   322,  116 },
+    { 0xf209787bb47d6b85ULL,   348,  124 },
+    { 0xb454e4a179dd1877ULL,   375,  132 },
+    { 0x865b86925b9bc5c2ULL,   402,  140 },
+    { 0xc83553c5c8965d3dULL,   428,  148 },
+    { 0x952ab45cfa97a0b3ULL,   455,  156 },
+    { 0xde469fbd99a05fe3ULL,   481,  164 },
+    { 0xa59bc234db398c25ULL,   508,  172 },
+    { 0xf6c69a72a3989f5cULL,   534,  180 },
+    { 0xb7dcbf5354e9beceULL,   561,  188 },
+    { 0x88fcf317f22241e2ULL,   588,  196 },
+    { 0xcc20ce9bd35c78a5ULL,   614,  204 },
+    { 0x98165af37b2153dfULL,   641,  212 },
+    { 0xe2a0b5dc971f303aULL,   667,  220 },
+    { 0xa8d9d1535ce3b396ULL,   694,  228 },
+    { 0xfb9b7cd9a4a7443cULL,   720,  236 },
+    { 0xbb764c4ca7a44410ULL,   747,  244 },
+    { 0x8bab8eefb6409c1aULL,   774,  252 },
+    { 0xd01fef10a657842cULL,   800,  260 },
+    { 0x9b10a4e5e9913129ULL,   827,  268 },
+    { 0xe7109bfba19c0c9dULL,   853,  276 },
+    { 0xac2820d9623bf429ULL,   880,  284 },
+    { 0x80444b5e7aa7cf85ULL,   907,  292 },
+    { 0xbf21e44003acdd2dULL,   933,  300 },
+    { 0x8e679c2f5e44ff8fULL,   960,  308 },
+    { 0xd433179d9c8cb841ULL,   986,  316 },
+    { 0x9e19db92b4e31ba9ULL,  1013,  324 },
+    { 0xeb96bf6ebadf77d9ULL,  1039,  332 },
+    { 0xaf87023b9bf0ee6bULL,  1066,  340 },
+};
+
+#define DTOA_TOTAL_POWERS   (sizeof(dtoaPowers) / sizeof(dtoaPowers[0]))
+
+static const uint32_t dtoaSmallPowers[] = {
+    1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000
+};
+
+/* ------------------------------------------- Static Declarations ------------------------------------------- */
+static unsigned char
+dtoa_integer(char* digits, double v, unsigned* length);
+
+static unsigned char
+dtoa_grisu3(char* digits, double v, unsigned* length, int* exponent);
+
+static void
+dtoa_fallback(char* digits, double v, unsigned* length, int* exponent);
+
+static unsigned char
+dtoa_digitgen(dtoa_fp low, dtoa_fp w, dtoa_fp high, char* digits, unsigned* length, int* kappa);
+
+static unsigned char
+dtoa_roundweed(char* digits, unsigned length, uint64_t distanceTooHighW, uint64_t unsafeInterval,
+               uint64_t rest, uint64_t tenKappa, uint64_t unit);
+
+static dtoa_fp
+dtoa_multiply(dtoa_fp x, dtoa_fp y);
+
+static dtoa_fp
+dtoa_normalize(dtoa_fp x);
+
+static unsigned
+dtoa_layout(char* buffer, const char* digits, unsigned length, int point);
+
+/* ------------------------------------------- Implementation ------------------------------------------- */
+unsigned
+dtoa_format(char* buffer, double v) {
+    char digits[DTOA_MAX_DIGITS + 1];
+    unsigned length;
+    int exponent = 0;
+    char* p = buffer;
+
+    if (isnan(v)) {
+        strcpy(buffer, "nan");
+        return 3;
+    }
+    if (signbit(v)) {
+        *p++ = '-';
+        v = -v;
+    }
+    if (isinf(v)) {
+        strcpy(p, "inf");
+        return p - buffer + 3;
+    }
+
+    if (!dtoa_integer(digits, v, &length) && !dtoa_grisu3(digits, v, &length, &exponent)) {
+        dtoa_fallback(digits, v, &length, &exponent);
+    }
+    return p - buffer + dtoa_layout(p, digits, length, (int) length + exponent);
+}
+
+/* ------------------------------------------- Static Definitions ------------------------------------------- */
+
+// integral values below 2^53 are exact, their digits are all there is
+static unsigned char
+dtoa_integer(char* digits, double v, unsigned* length) {
+    if (v >= 9007199254740992.0 || v != (double) (uint64_t) v) {
+        return 0;
+    }
+
+    uint64_t n = (uint64_t) v;
+    char reversed[DTOA_MAX_DIGITS];
+    unsigned count = 0;
+
+    do {
+        reversed[count++] = '0' + n % 10;
+        n /= 10;
+    } while (n);
+
+    for (unsigned i = 0; i < count; i++) {
+        digits[i] = reversed[count - 1 - i];
+    }
+    *length = count;
+    return 1;
+}
+
+// v positive and finite, v = digits * 10^exponent
+static unsigned char
+dtoa_grisu3(char* digits, double v, unsigned* length, int* exponent) {
+    uint64_t bits;
+    memcpy(&bits, &v, sizeof(bits));
+
+    uint64_t fraction = bits & DTOA_FRACTION_MASK;
+    int biased = (int) (bits >> 52);
+    dtoa_fp value;
+
+    if (biased) {
+        value.f = fraction | DTOA_HIDDEN_BIT;
+        value.e = biased - DTOA_EXPONENT_BIAS;
+    }
+    else {
+        value.f = fraction;
+        value.e = 1 - DTOA_EXPONENT_BIAS;
+    }
+
+    // the boundaries halfway to the neighbouring doubles, the lower one closer at powers of two
+    dtoa_fp plus = dtoa_normalize((dtoa_fp) { (value.f << 1) + 1, value.e - 1 });
+    dtoa_fp minus;
+    if (value.f == DTOA_HIDDEN_BIT && biased > 1) {
+        minus = (dtoa_fp) { (value.f << 2) - 1, value.e - 2 };
+    }
+    else {
+        minus = (dtoa_fp) { (value.f << 1) - 1, value.e - 1 };
+    }
+    minus.f <<= minus.e - plus.e;
+    minus.e = plus.e;
+
+    dtoa_fp w = dtoa_normalize(value);
+
+    // the power that scales the exponent into [DTOA_MIN_EXPONENT, DTOA_MAX_EXPONENT]
+    double estimate = (DTOA_MIN_EXPONENT - 1 - w.e) * 0.30102999566398114 + 347;
+    int k = (int) estimate;
+    if (estimate - k > 0) {
+        k++;
+    }
+    int index = (k >> 3) + 1;
+    if (index < 0) {
+        index = 0;
+    }
+    if (index >= (int) DTOA_TOTAL_POWERS) {
+        index = DTOA_TOTAL_POWERS - 1;
+    }
+    while (index < (int) DTOA_TOTAL_POWERS - 1 && w.e + dtoaPowers[index].e + 64 < DTOA_MIN_EXPONENT) {
+        index++;
+    }
+    while (index > 0 && w.e + dtoaPowers[index].e + 64 > DTOA_MAX_EXPONENT) {
+        index--;
+    }
+
+    dtoa_fp power = { dtoaPowers[index].f, dtoaPowers[index].e };
+    int kappa;
+
+    if (!dtoa_digitgen(dtoa_multiply(minus, power), dtoa_multiply(w, power), dtoa_multiply(plus, power),
+                       digits, length, &kappa)) {
+        return 0;
+    }
+    *exponent = kappa - dtoaPowers[index].k;
+    return 1;
+}
+
+// shortest precision of printf that reads back
+static void
+dtoa_fallback(char* digits, double v, unsigned* length, int* exponent) {
+    char text[DTOA_MAX_DIGITS + 16];
+
+    for (int precision = 1; precision <= DTOA_MAX_DIGITS; precision++) {
+        snprintf(text, sizeof(text), "%.*e", precision - 1, v);
+        if (strtod(text, NULL) == v) {
+            break;
+        }
+    }
+
+    // d.ddde[+-]x
+    unsigned count = 0;
+    char* p = text;
+    for (; *p != 'e'; p++) {
+        if (*p != '.') {
+            digits[count++] = *p;
+        }
+    }
+    while (count > 1 && digits[count - 1] == '0') {
+        count--;
+    }
+    *length = count;
+    *exponent = atoi(p + 1) - (int) (count - 1);
+}
+
+static unsigned char
+dtoa_digitgen(dtoa_fp low, dtoa_fp w, dtoa_fp high, char* digits, unsigned* length, int* kappa) {
+    uint64_t unit = 1;
+    uint64_t tooLow = low.f - unit;
+    uint64_t tooHigh = high.f + unit;
+    uint64_t unsafeInterval = tooHigh - tooLow;
+
+    // the integral and fractional parts of the upper boundary
+    int shift = -w.e;
+    uint64_t one = (uint64_t) 1 << shift;
+    uint32_t integral = (uint32_t) (tooHigh >> shift);
+    uint64_t fractional = tooHigh & (one - 1);
+
+    int divisorDigits = 1;
+    while (divisorDigits < 10 && dtoaSmallPowers[divisorDigits] <= integral) {
+        divisorDigits++;
+    }
+    uint32_t divisor = dtoaSmallPowers[divisorDigits - 1];
+
+    *kappa = divisorDigits;
+    *length = 0;
+
+    while (*kappa > 0) {
+        digits[(*length)++] = '0' + integral / divisor;
+        integral %= divisor;
+        (*kappa)--;
+
+        uint64_t rest = ((uint64_t) integral << shift) + fractional;
+        if (rest < unsafeInterval) {
+            return dtoa_roundweed(digits, *length, tooHigh - w.f, unsafeInterval, rest,
+                                  (uint64_t) divisor << shift, unit);
+        }
+        divisor /= 10;
+    }
+
+    for (;;) {
+        fractional *= 10;
+        unit *= 10;
+        unsafeInterval *= 10;
+
+        digits[(*length)++] = '0' + (int) (fractional >> shift);
+        fractional &= one - 1;
+        (*kappa)--;
+
+        if (fractional < unsafeInterval) {
+            return dtoa_roundweed(digits, *length, (tooHigh - w.f) * unit, unsafeInterval, fractional,
+                                  one, unit);
+        }
+        if (*length == DTOA_MAX_DIGITS) {
+            return 0;
+        }
+    }
+}
+
+// moves the last digit closer to w, and tells if the digits are known to be right
+static unsigned char
+dtoa_roundweed(char* digits, unsigned length, uint64_t distanceTooHighW, uint64_t unsafeInterval,
+               uint64_t rest, uint64_t tenKappa, uint64_t unit) {
+    uint64_t smallDistance = distanceTooHighW - unit;
+    uint64_t bigDistance = distanceTooHighW + unit;
+
+    while (rest < smallDistance && unsafeInterval - rest >= tenKappa &&
+           (rest + tenKappa < smallDistance || smallDistance - rest >= rest + tenKappa - smallDistance)) {
+        digits[length - 1]--;
+        rest += tenKappa;
+    }
+
+    if (rest < bigDistance && unsafeInterval - rest >= tenKappa &&
+        (rest + tenKappa < bigDistance || bigDistance - rest > rest + tenKappa - bigDistance)) {
+        return 0;
+    }
+    return 2 * unit <= rest && rest <= unsafeInterval - 4 * unit;
+}
+
+// the upper 64 bits of the product, rounded
+static dtoa_fp
+dtoa_multiply(dtoa_fp x, dtoa_fp y) {
+    uint64_t mask = 0xffffffffu;
+    uint64_t a = x.f >> 32, b = x.f & mask;
+    uint64_t c = y.f >> 32, d = y.f & mask;
+    uint64_t ac = a * c, bc = b * c, ad = a * d, bd = b * d;
+    uint64_t middle = (bd >> 32) + (ad & mask) + (bc & mask) + ((uint64_t) 1 << 31);
+
+    return (dtoa_fp) { ac + (ad >> 32) + (bc >> 32) + (middle >> 32), x.e + y.e + 64 };
+}
+
+static dtoa_fp
+dtoa_normalize(dtoa_fp x) {
+    while (!(x.f & ((uint64_t) 1 << 63))) {
+        x.f <<= 1;
+        x.e--;
+    }
+    return x;
+}
+
+// point is where the decimal point goes among the digits
+static unsigned
+dtoa_layout(char* buffer, const char* digits, unsigned length, int point) {
+    char* p = buffer;
+
+    if (point > 0 && point <= 21) {
+        if ((int) length <= point) {
+            memcpy(p, digits, length);
+            p += length;
+            memset(p, '0', point - length);
+            p += point - length;
+        }
+        else {
+            memcpy(p, digits, point);
+            p += point;
+            *p++ = '.';
+            memcpy(p, digits + point, length - point);
+            p += length - point;
+        }
+    }
+    else if (point <= 0 && point > -6) {
+        *p++ = '0';
+        *p++ = '.';
+        memset(p, '0', -point);
+        p += -point;
+        memcpy(p, digits, length);
+        p += length;
+    }
+    else {
+        *p++ = digits[0];
+        if (length > 1) {
+            *p++ = '.';
+            memcpy(p, digits + 1, length - 1);
+            p += length - 1;
+        }
+        p += sprintf(p, "e%+d", point - 1);
+        return p - buffer;
+    }
+
+    *p = '\0';
+    return p - buffer;
+}
@@ -0,0 +1,16 @@
+#ifndef DTOA_H
+#define DTOA_H
+
+#define DTOA_BUFFER_SIZE    32  // "-0.00000" and 17 digits, or 17 digits and "-e-324"
+
+/*
+ * Writes the shortest decimal that reads back as v, NUL terminated, and
+ * returns its length. Integers have no fraction ("3"), and values whose
+ * decimal point would be more than 21 digits out or 6 zeros in use an
+ * exponent ("1e+21", "1.5e-7"). Shared by the compiler's constants and
+ * the avm's number to string conversions.
+ */
+unsigned
+dtoa_format(char* buffer, double v);
+
+#endif
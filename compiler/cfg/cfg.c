@@ -0,0 +1,767 @@
+#include "cfg.h"
+#include "../opt/opt.h"
+#include "../quad/quad.h"
+#include "../icode/icode.h"
+#include "../symbol_table/symbol_table.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <string.h>
+
+typedef struct CfgBlock {
+    unsigned first;
+    unsigned last;
+    unsigned function;
+
+    unsigned succs[2];
+    unsigned totalSuccs;
+    unsigned* preds;
+    unsigned totalPreds;
+    unsigned predsSize;
+
+    unsigned rpo;           // position in the function's reverse postorder, CFG_NONE if unreachable
+    unsigned idom;
+    unsigned loop;
+    unsigned loopDepth;
+} CfgBlock;
+
+typedef struct CfgFunction {
+    unsigned start;
+    unsigned end;
+    unsigned firstBlock;
+    unsigned totalBlocks;
+    unsigned* rpo;
+    unsigned totalReachable;
+} CfgFunction;
+
+typedef struct CfgLoop {
+    unsigned header;
+    unsigned parent;
+    unsigned depth;
+    unsigned totalBlocks;
+    unsigned char* body;    // by block, from the first block of the header's function
+} CfgLoop;
+
+static CfgBlock* blocks = NULL;
+static unsigned totalBlocks = 0;
+static unsigned blocksSize = 0;
+
+static CfgFunction* functions = NULL;
+static unsigned totalFunctions = 0;
+
+static CfgLoop* loops = NULL;
+static unsigned totalLoops = 0;
+static unsigned loopsSize = 0;
+
+static unsigned* blockOfQuad = NULL;
+static unsigned totalQuads = 0;
+
+/* ------------------------------------------ Static Declarations ------------------------------------------ */
+static void
+find_functions(unsigned* functionOfQuad);
+
+static void
+find_blocks(unsigned* functionOfQuad);
+
+static void
+find_edges();
+
+static void
+add_edge(unsigned from, unsigned to);
+
+static void
+order_blocks(CfgFunction* f);
+
+static void
+find_dominators(CfgFunction* f);
+
+static unsigned
+intersect(unsigned b1, unsigned b2);
+
+static void
+find_loops(CfgFunction* f);
+
+static void
+nest_loops();
+
+static unsigned
+new_block();
+
+static const char*
+function_name(CfgFunction* f);
+
+static void
+write_cfg(FILE* out);
+
+/* ------------------------------------------ Implementation ------------------------------------------ */
+void
+cfg_build() {
+    unsigned* functionOfQuad;
+
+    cfg_destroy();
+
+    totalQuads = quad_totalQuads();
+    functionOfQuad = malloc(sizeof(unsigned) * totalQuads);
+    blockOfQuad = malloc(sizeof(unsigned) * totalQuads);
+
+    if (!functionOfQuad || !blockOfQuad) {
+        printf("Error allocating memory for the cfg.\n");
+        exit(1);
+    }
+
+    find_functions(functionOfQuad);
+    find_blocks(functionOfQuad);
+    find_edges();
+
+    for (unsigned f = 0; f < totalFunctions; f++) {
+        order_blocks(&functions[f]);
+        find_dominators(&functions[f]);
+        find_loops(&functions[f]);
+    }
+    nest_loops();
+
+    free(functionOfQuad);
+}
+
+void
+cfg_destroy() {
+    for (unsigned b = 0; b < totalBlocks; b++) {
+        free(blocks[b].preds);
+    }
+    for (unsigned f = 0; f < totalFunctions; f++) {
+        free(functions[f].rpo);
+    }
+    for (unsigned l = 0; l < totalLoops; l++) {
+        free(loops[l].body);
+    }
+    free(blocks);
+    free(functions);
+    free(loops);
+    free(blockOfQuad);
+
+    blocks = NULL;
+    functions = NULL;
+    loops = NULL;
+    blockOfQuad = NULL;
+    totalBlocks = blocksSize = 0;
+    totalFunctions = 0;
+    totalLoops = loopsSize = 0;
+    totalQuads = 0;
+}
+
+void
+cfg_writeToFile(char* filename) {
+    FILE* file = fopen(filename, "w");
+
+    if (!file) {
+        printf("Error opening file to write the cfg.\n");
+        exit(1);
+    }
+
+    write_cfg(file);
+    fclose(file);
+}
+
+unsigned
+cfg_totalFunctions() {
+    return totalFunctions;
+}
+
+unsigned
+cfg_getFunctionStart(unsigned f) {
+    assert(f < totalFunctions);
+    return functions[f].start;
+}
+
+unsigned
+cfg_getFunctionEnd(unsigned f) {
+    assert(f < totalFunctions);
+    return functions[f].end;
+}
+
+unsigned
+cfg_getFunctionFirstBlock(unsigned f) {
+    assert(f < totalFunctions);
+    return functions[f].firstBlock;
+}
+
+unsigned
+cfg_getFunctionTotalBlocks(unsigned f) {
+    assert(f < totalFunctions);
+    return functions[f].totalBlocks;
+}
+
+unsigned
+cfg_getFunctionTotalReachable(unsigned f) {
+    assert(f < totalFunctions);
+    return functions[f].totalReachable;
+}
+
+unsigned
+cfg_getFunctionRpoBlock(unsigned f, unsigned i) {
+    assert(f < totalFunctions && i < functions[f].totalReachable);
+    return functions[f].rpo[i];
+}
+
+unsigned
+cfg_totalBlocks() {
+    return totalBlocks;
+}
+
+unsigned
+cfg_getBlockOfQuad(unsigned quad) {
+    assert(quad > 0 && quad < totalQuads);
+    return blockOfQuad[quad];
+}
+
+unsigned
+cfg_getBlockFunction(unsigned b) {
+    assert(b < totalBlocks);
+    return blocks[b].function;
+}
+
+unsigned
+cfg_getFirstQuad(unsigned b) {
+    assert(b < totalBlocks);
+    return blocks[b].first;
+}
+
+unsigned
+cfg_getLastQuad(unsigned b) {
+    assert(b < totalBlocks);
+    return blocks[b].last;
+}
+
+unsigned
+cfg_totalSuccessors(unsigned b) {
+    assert(b < totalBlocks);
+    return blocks[b].totalSuccs;
+}
+
+unsigned
+cfg_getSuccessor(unsigned b, unsigned i) {
+    assert(b < totalBlocks && i < blocks[b].totalSuccs);
+    return blocks[b].succs[i];
+}
+
+unsigned
+cfg_totalPredecessors(unsigned b) {
+    assert(b < totalBlocks);
+    return blocks[b].totalPreds;
+}
+
+unsigned
+cfg_getPredecessor(unsigned b, unsigned i) {
+    assert(b < totalBlocks && i < blocks[b].totalPreds);
+    return blocks[b].preds[i];
+}
+
+unsigned char
+cfg_isReachable(unsigned b) {
+    assert(b < totalBlocks);
+    return blocks[b].rpo != CFG_NONE;
+}
+
+unsigned
+cfg_getIdom(unsigned b) {
+    assert(b < totalBlocks);
+    return blocks[b].idom;
+}
+
+unsigned char
+cfg_dominates(unsigned a, unsigned b) {
+    assert(a < totalBlocks && b < totalBlocks);
+
+    if (!cfg_isReachable(a) || !cfg_isReachable(b)) {
+        return 0;
+    }
+    while (b != CFG_NONE) {
+        if (a == b) {
+            return 1;
+        }
+        b = blocks[b].idom;
+    }
+    return 0;
+}
+
+unsigned
+cfg_totalLoops() {
+    return totalLoops;
+}
+
+unsigned
+cfg_getLoopHeader(unsigned l) {
+    assert(l < totalLoops);
+    return loops[l].header;
+}
+
+unsigned
+cfg_getLoopParent(unsigned l) {
+    assert(l < totalLoops);
+    return loops[l].parent;
+}
+
+unsigned
+cfg_getLoopDepth(unsigned l) {
+    assert(l < totalLoops);
+    return loops[l].depth;
+}
+
+unsigned char
+cfg_isInLoop(unsigned b, unsigned l) {
+    assert(b < totalBlocks && l < totalLoops);
+    CfgFunction* f = &functions[blocks[loops[l].header].function];
+
+    if (blocks[b].function != blocks[loops[l].header].function) {
+        return 0;
+    }
+    return loops[l].body[b - f->firstBlock];
+}
+
+unsigned
+cfg_getBlockLoop(unsigned b) {
+    assert(b < totalBlocks);
+    return blocks[b].loop;
+}
+
+unsigned
+cfg_getBlockLoopDepth(unsigned b) {
+    assert(b < totalBlocks);
+    return blocks[b].loopDepth;
+}
+
+/* ------------------------------------------ Static Definitions ------------------------------------------ */
+
+// a quad belongs to the innermost function it is in, nested functions are skipped over by a jump
+static void
+find_functions(unsigned* functionOfQuad) {
+    unsigned* stack = malloc(sizeof(unsigned) * totalQuads);
+    unsigned top = 0;
+    unsigned size = 16;
+
+    functions = malloc(sizeof(CfgFunction) * size);
+    if (!stack || !functions) {
+        printf("Error allocating memory for the cfg.\n");
+        exit(1);
+    }
+
+    memset(&functions[0], 0, sizeof(CfgFunction));
+    totalFunctions = 1;
+    stack[top++] = 0;
+
+    for (unsigned q = 1; q < totalQuads; q++) {
+        IOPCodeType op = quad_getOpcode(q);
+
+        if (op == funcstart_op) {
+            if (totalFunctions == size) {
+                size *= 2;
+                functions = realloc(functions, sizeof(CfgFunction) * size);
+                if (!functions) {
+                    printf("Error allocating memory for the cfg.\n");
+                    exit(1);
+                }
+            }
+            memset(&functions[totalFunctions], 0, sizeof(CfgFunction));
+            functions[totalFunctions].start = q;
+            stack[top++] = totalFunctions++;
+        }
+
+        functionOfQuad[q] = stack[top - 1];
+
+        if (op == funcend_op) {
+            assert(top > 1);
+            functions[stack[--top]].end = q;
+        }
+    }
+
+    free(stack);
+}
+
+// leaders are function entries and exits, jump targets and what follows a branch or a gap of nested functions
+static void
+find_blocks(unsigned* functionOfQuad) {
+    unsigned char* leader = calloc(totalQuads + 1, 1);
+    unsigned* prev = malloc(sizeof(unsigned) * totalFunctions);
+
+    if (!leader || !prev) {
+        printf("Error allocating memory for the cfg.\n");
+        exit(1);
+    }
+
+    for (unsigned f = 0; f < totalFunctions; f++) {
+        prev[f] = CFG_NONE;
+    }
+
+    for (unsigned q = 1; q < totalQuads; q++) {
+        unsigned f = functionOfQuad[q];
+        IOPCodeType op = quad_getOpcode(q);
+
+        if (prev[f] == CFG_NONE || prev[f] + 1 != q || opt_endsBlock(quad_getOpcode(prev[f])) || op == funcend_op) {
+            leader[q] = 1;
+        }
+        if (opt_isBranch(op)) {
+            unsigned target = quad_getLabel(quad_getAt(q));
+            if (target > 0 && target < totalQuads) {
+                leader[target] = 1;
+            }
+        }
+        prev[f] = q;
+    }
+
+    // the blocks of each function together, in the order of their quads
+    for (unsigned f = 0; f < totalFunctions; f++) {
+        functions[f].firstBlock = totalBlocks;
+
+        for (unsigned q = 1; q < totalQuads; q++) {
+            if (functionOfQuad[q] != f) {
+                continue;
+            }
+            if (leader[q]) {
+                unsigned b = new_block();
+                blocks[b].first = q;
+                blocks[b].function = f;
+            }
+            blocks[totalBlocks - 1].last = q;
+            blockOfQuad[q] = totalBlocks - 1;
+        }
+
+        functions[f].totalBlocks = totalBlocks - functions[f].firstBlock;
+    }
+
+    free(leader);
+    free(prev);
+}
+
+static void
+find_edges() {
+    for (unsigned b = 0; b < totalBlocks; b++) {
+        CfgBlock* block = &blocks[b];
+        CfgFunction* f = &functions[block->function];
+        Quad* last = quad_getAt(block->last);
+        IOPCodeType op = quad_getOpcode(block->last);
+        unsigned next = b + 1 < f->firstBlock + f->totalBlocks ? b + 1 : CFG_NONE;
+
+        if (opt_isBranch(op)) {
+            unsigned target = quad_getLabel(last);
+            if (target > 0 && target < totalQuads) {
+                add_edge(b, blockOfQuad[target]);
+            }
+            if (op != jump_op && next != CFG_NONE) {
+                add_edge(b, next);
+            }
+        }
+        else if (op == ret_op) {
+            add_edge(b, blockOfQuad[f->end]);
+        }
+        else if (op != funcend_op && next != CFG_NONE) {
+            add_edge(b, next);
+        }
+    }
+}
+
+static void
+add_edge(unsigned from, unsigned to) {
+    CfgBlock* source = &blocks[from];
+    CfgBlock* target = &blocks[to];
+
+    for (unsigned i = 0; i < source->totalSuccs; i++) {
+        if (source->succs[i] == to) {
+            return;
+        }
+    }
+    assert(source->totalSuccs < 2);
+    source->succs[source->totalSuccs++] = to;
+
+    if (target->totalPreds == target->predsSize) {
+        target->predsSize = target->predsSize ? target->predsSize * 2 : 2;
+        target->preds = realloc(target->preds, sizeof(unsigned) * target->predsSize);
+        if (!target->preds) {
+            printf("Error allocating memory for the cfg.\n");
+            exit(1);
+        }
+    }
+    target->preds[target->totalPreds++] = from;
+}
+
+// depth-first from the entry, with an explicit stack of blocks and their next successor
+static void
+order_blocks(CfgFunction* f) {
+    unsigned* stack = malloc(sizeof(unsigned) * (f->totalBlocks + 1));
+    unsigned* nextSucc = calloc(f->totalBlocks + 1, sizeof(unsigned));
+    unsigned char* visited = calloc(f->totalBlocks + 1, 1);
+    unsigned top = 0;
+    unsigned count;
+
+    f->rpo = malloc(sizeof(unsigned) * (f->totalBlocks + 1));
+    if (!stack || !nextSucc || !visited || !f->rpo) {
+        printf("Error allocating memory for the cfg.\n");
+        exit(1);
+    }
+
+    for (unsigned b = f->firstBlock; b < f->firstBlock + f->totalBlocks; b++) {
+        blocks[b].rpo = CFG_NONE;
+        blocks[b].idom = CFG_NONE;
+        blocks[b].loop = CFG_NONE;
+        blocks[b].loopDepth = 0;
+    }
+
+    count = f->totalBlocks;
+    if (f->totalBlocks) {
+        stack[top++] = f->firstBlock;
+        visited[0] = 1;
+    }
+
+    while (top) {
+        unsigned b = stack[top - 1];
+        unsigned i = b - f->firstBlock;
+
+        if (nextSucc[i] < blocks[b].totalSuccs) {
+            unsigned s = blocks[b].succs[nextSucc[i]++];
+            if (!visited[s - f->firstBlock]) {
+                visited[s - f->firstBlock] = 1;
+                stack[top++] = s;
+            }
+        }
+        else {
+            f->rpo[--count] = b;
+            top--;
+        }
+    }
+
+    // the postorder filled the end of the array
+    f->totalReachable = f->totalBlocks - count;
+    memmove(f->rpo, f->rpo + count, sizeof(unsigned) * f->totalReachable);
+    for (unsigned i = 0; i < f->totalReachable; i++) {
+        blocks[f->rpo[i]].rpo = i;
+    }
+
+    free(stack);
+    free(nextSucc);
+    free(visited);
+}
+
+// Cooper, Harvey and Kennedy, "A Simple, Fast Dominance Algorithm"
+static void
+find_dominators(CfgFunction* f) {
+    unsigned char changed = 1;
+
+    if (!f->totalReachable) {
+        return;
+    }
+
+    unsigned entry = f->rpo[0];
+    blocks[entry].idom = entry;
+
+    while (changed) {
+        changed = 0;
+
+        for (unsigned i = 1; i < f->totalReachable; i++) {
+            CfgBlock* block = &blocks[f->rpo[i]];
+            unsigned idom = CFG_NONE;
+
+            for (unsigned p = 0; p < block->totalPreds; p++) {
+                unsigned pred = block->preds[p];
+                if (blocks[pred].idom == CFG_NONE) {
+                    continue;
+                }
+                idom = idom == CFG_NONE ? pred : intersect(pred, idom);
+            }
+
+            if (block->idom != idom) {
+                block->idom = idom;
+                changed = 1;
+            }
+        }
+    }
+
+    blocks[entry].idom = CFG_NONE;
+}
+
+static unsigned
+intersect(unsigned b1, unsigned b2) {
+    while (b1 != b2) {
+        while (blocks[b1].rpo > blocks[b2].rpo) {
+            b1 = blocks[b1].idom;
+        }
+        while (blocks[b2].rpo > blocks[b1].rpo) {
+            b2 = blocks[b2].idom;
+        }
+    }
+    return b1;
+}
+
+// a back edge goes to a block dominating its source, the loop is what reaches the source without the header
+static void
+find_loops(CfgFunction* f) {
+    unsigned* worklist = malloc(sizeof(unsigned) * (f->totalBlocks + 1));
+
+    if (!worklist) {
+        printf("Error allocating memory for the cfg.\n");
+        exit(1);
+    }
+
+    for (unsigned i = 0; i < f->totalReachable; i++) {
+        unsigned header = f->rpo[i];
+        CfgLoop* loop = NULL;
+
+        for (unsigned p = 0; p < blocks[header].totalPreds; p++) {
+            unsigned latch = blocks[header].preds[p];
+            unsigned top = 0;
+
+            if (!cfg_dominates(header, latch)) {
+                continue;
+            }
+
+            if (!loop) {
+                if (totalLoops == loopsSize) {
+                    loopsSize = loopsSize ? loopsSize * 2 : 16;
+                    loops = realloc(loops, sizeof(CfgLoop) * loopsSize);
+                    if (!loops) {
+                        printf("Error allocating memory for the cfg.\n");
+                        exit(1);
+                    }
+                }
+                loop = &loops[totalLoops++];
+                loop->header = header;
+                loop->parent = CFG_NONE;
+                loop->depth = 1;
+                loop->totalBlocks = 1;
+                loop->body = calloc(f->totalBlocks, 1);
+                if (!loop->body) {
+                    printf("Error allocating memory for the cfg.\n");
+                    exit(1);
+                }
+                loop->body[header - f->firstBlock] = 1;
+            }
+
+            if (!loop->body[latch - f->firstBlock]) {
+                loop->body[latch - f->firstBlock] = 1;
+                loop->totalBlocks++;
+                worklist[top++] = latch;
+            }
+            while (top) {
+                CfgBlock* block = &blocks[worklist[--top]];
+                for (unsigned q = 0; q < block->totalPreds; q++) {
+                    unsigned pred = block->preds[q];
+                    if (cfg_isReachable(pred) && !loop->body[pred - f->firstBlock]) {
+                        loop->body[pred - f->firstBlock] = 1;
+                        loop->totalBlocks++;
+                        worklist[top++] = pred;
+                    }
+                }
+            }
+        }
+    }
+
+    free(worklist);
+}
+
+// the parent of a loop is the smallest other loop holding its header
+static void
+nest_loops() {
+    for (unsigned l = 0; l < totalLoops; l++) {
+        for (unsigned o = 0; o < totalLoops; o++) {
+            if (o == l || !cfg_isInLoop(loops[l].header, o) || loops[o].totalBlocks <= loops[l].totalBlocks) {
+                continue;
+            }
+            if (loops[l].parent == CFG_NONE || loops[o].totalBlocks < loops[loops[l].parent].totalBlocks) {
+                loops[l].parent = o;
+            }
+        }
+    }
+
+    for (unsigned l = 0; l < totalLoops; l++) {
+        for (unsigned p = loops[l].parent; p != CFG_NONE; p = loops[p].parent) {
+            loops[l].depth++;
+        }
+    }
+
+    for (unsigned b = 0; b < totalBlocks; b++) {
+        for (unsigned l = 0; l < totalLoops; l++) {
+            if (!cfg_isInLoop(b, l)) {
+                continue;
+            }
+            blocks[b].loopDepth++;
+            if (blocks[b].loop == CFG_NONE || loops[l].depth > loops[blocks[b].loop].depth) {
+                blocks[b].loop = l;
+            }
+        }
+    }
+}
+
+static unsigned
+new_block() {
+    if (totalBlocks == blocksSize) {
+        blocksSize = blocksSize ? blocksSize * 2 : 64;
+        blocks = realloc(blocks, sizeof(CfgBlock) * blocksSize);
+        if (!blocks) {
+            printf("Error allocating memory for the cfg.\n");
+            exit(1);
+        }
+    }
+    memset(&blocks[totalBlocks], 0, sizeof(CfgBlock));
+    return totalBlocks++;
+}
+
+static const char*
+function_name(CfgFunction* f) {
+    if (!f->start) {
+        return "(program)";
+    }
+    SymbolTableEntry* entry = icode_getExprEntry(quad_getArg1(quad_getAt(f->start)));
+    return entry ? symtab_getEntryName(entry) : "";
+}
+
+static void
+write_cfg(FILE* out) {
+    fprintf(out, "---------------------------------------------CFG---------------------------------------------\n");
+
+    for (unsigned f = 0; f < totalFunctions; f++) {
+        CfgFunction* function = &functions[f];
+        fprintf(out, "function %s: %u blocks, %u reachable\n",
+            function_name(function), function->totalBlocks, function->totalReachable);
+
+        for (unsigned b = function->firstBlock; b < function->firstBlock + function->totalBlocks; b++) {
+            CfgBlock* block = &blocks[b];
+
+            fprintf(out, "    B%-5u quads %u-%u", b, block->first, block->last);
+            if (!cfg_isReachable(b)) {
+                fprintf(out, " unreachable");
+            }
+            fprintf(out, "\n        preds:");
+            for (unsigned i = 0; i < block->totalPreds; i++) {
+                fprintf(out, " B%u", block->preds[i]);
+            }
+            fprintf(out, "\n        succs:");
+            for (unsigned i = 0; i < block->totalSuccs; i++) {
+                fprintf(out, " B%u", block->succs[i]);
+            }
+            if (block->idom != CFG_NONE) {
+                fprintf(out, "\n        idom: B%u", block->idom);
+            }
+            if (block->loop != CFG_NONE) {
+                fprintf(out, "\n        loop: L%u, depth %u", block->loop, block->loopDepth);
+            }
+            fprintf(out, "\n");
+        }
+
+        for (unsigned l = 0; l < totalLoops; l++) {
+            if (blocks[loops[l].header].function != f) {
+                continue;
+            }
+            fprintf(out, "    L%-5u header B%u, depth %u", l, loops[l].header, loops[l].depth);
+            if (loops[l].parent != CFG_NONE) {
+                fprintf(out, ", in L%u", loops[l].parent);
+            }
+            fprintf(out, "\n        blocks:");
+            for (unsigned b = function->firstBlock; b < function->firstBlock + function->totalBlocks; b++) {
+                if (loops[l].body[b - function->firstBlock]) {
+                    fprintf(out, " B%u", b);
+                }
+            }
+            fprintf(out, "\n");
+        }
+        fprintf(out, "\n");
+    }
+}
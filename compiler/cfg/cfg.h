@@ -0,0 +1,107 @@
+#ifndef CFG_H
+#define CFG_H
+
+#define CFG_NONE ((unsigned) -1)
+
+/*
+ * Control-flow graphs of the quads, one per function and one for the
+ * top-level program, which is function 0. Blocks are numbered across all
+ * functions, those of a function being consecutive, and each covers a
+ * range of consecutive quads. Blocks the entry does not reach have no
+ * dominator and belong to no loop.
+ */
+void
+cfg_build();
+
+void
+cfg_destroy();
+
+void
+cfg_writeToFile(char* filename);
+
+unsigned
+cfg_totalFunctions();
+
+// the funcstart and funcend quads, 0 for the program
+unsigned
+cfg_getFunctionStart(unsigned f);
+
+unsigned
+cfg_getFunctionEnd(unsigned f);
+
+unsigned
+cfg_getFunctionFirstBlock(unsigned f);
+
+unsigned
+cfg_getFunctionTotalBlocks(unsigned f);
+
+// the reachable blocks in reverse postorder, the entry first
+unsigned
+cfg_getFunctionTotalReachable(unsigned f);
+
+unsigned
+cfg_getFunctionRpoBlock(unsigned f, unsigned i);
+
+unsigned
+cfg_totalBlocks();
+
+unsigned
+cfg_getBlockOfQuad(unsigned quad);
+
+unsigned
+cfg_getBlockFunction(unsigned b);
+
+unsigned
+cfg_getFirstQuad(unsigned b);
+
+unsigned
+cfg_getLastQuad(unsigned b);
+
+unsigned
+cfg_totalSuccessors(unsigned b);
+
+unsigned
+cfg_getSuccessor(unsigned b, unsigned i);
+
+unsigned
+cfg_totalPredecessors(unsigned b);
+
+unsigned
+cfg_getPredecessor(unsigned b, unsigned i);
+
+unsigned char
+cfg_isReachable(unsigned b);
+
+unsigned
+cfg_getIdom(unsigned b);
+
+unsigned char
+cfg_dominates(unsigned a, unsigned b);
+
+/*
+ * Natural loops, those of back edges sharing a header merged. A loop's
+ * parent is the innermost loop around it.
+ */
+unsigned
+cfg_totalLoops();
+
+unsigned
+cfg_getLoopHeader(unsigned l);
+
+unsigned
+cfg_getLoopParent(unsigned l);
+
+unsigned
+cfg_getLoopDepth(unsigned l);
+
+unsigned char
+cfg_isInLoop(unsigned b, unsigned l);
+
+// the innermost loop of the block and how many loops it is in
+unsigned
+cfg_getBlockLoop(unsigned b);
+
+unsigned
+cfg_getBlockLoopDepth(unsigned b);
+
+#endif
@@ -17,6 +17,8 @@ typedef struct Expr {
     Expr* index;
     ConstValue constValue;
     Expr* next;
+    int trueList;       // a condition not yet materialized jumps through these
+    int falseList;
 } Expr;
 
 typedef struct Call {
@@ -34,6 +36,7 @@ typedef struct Indexed {
 typedef struct ForPrefix {
     unsigned int test;
     unsigned int enter;
+    unsigned int exit;
 } ForPrefix;
 
 typedef struct Statement {
@@ -292,6 +295,30 @@ icode_getExprNext(Expr* e) {
     return e->next;
 }
 
+void
+icode_setTrueList(Expr* e, int i) {
+    assert(e);
+    e->trueList = i;
+}
+
+void
+icode_setFalseList(Expr* e, int i) {
+    assert(e);
+    e->falseList = i;
+}
+
+int
+icode_getTrueList(Expr* e) {
+    assert(e);
+    return e->trueList;
+}
+
+int
+icode_getFalseList(Expr* e) {
+    assert(e);
+    return e->falseList;
+}
+
 Indexed*
 icode_getIndexedNext(Indexed* indexed) {
     assert(indexed);
@@ -359,7 +386,7 @@ icode_getIndexedValue(Indexed* indexed) {
 }
 
 ForPrefix*
-icode_newForPrefix(unsigned int test, unsigned int enter) {
+icode_newForPrefix(unsigned int test, unsigned int enter, unsigned int exitList) {
     ForPrefix* forPrefix;
 
     forPrefix = malloc(sizeof(ForPrefix));
@@ -371,6 +398,7 @@ icode_newForPrefix(unsigned int test, unsigned int enter) {
 
     forPrefix->test = test;
     forPrefix->enter = enter;
+    forPrefix->exit = exitList;
 
     return forPrefix;
 }
@@ -385,4 +413,10 @@ unsigned int
 icode_getForPrefixEnter(ForPrefix* f) {
     assert(f);
     return f->enter;
+}
+
+unsigned int
+icode_getForPrefixExit(ForPrefix* f) {
+    assert(f);
+    return f->exit;
 }
\ No newline at end of file
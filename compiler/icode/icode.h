@@ -8,7 +8,8 @@ typedef enum {
     assign_op, tablecreate_op, tablegetelem_op, tablesetelem_op,
     jump_op, if_eq_op, if_noteq_op, if_greater_op, if_greatereq_op, if_less_op, if_lesseq_op,
     not_op, or_op, and_op,
-    param_op, call_op, getretval_op, funcstart_op, ret_op, funcend_op
+    param_op, call_op, getretval_op, funcstart_op, ret_op, funcend_op,
+    nop_op      // a quad an optimization removed, it generates nothing
 } IOPCodeType;
 
 typedef enum {
@@ -116,6 +117,18 @@ icode_getExprIndex(Expr* e);
 Expr*
 icode_getExprNext(Expr* e);
 
+void
+icode_setTrueList(Expr* e, int i);
+
+void
+icode_setFalseList(Expr* e, int i);
+
+int
+icode_getTrueList(Expr* e);
+
+int
+icode_getFalseList(Expr* e);
+
 Indexed*
 icode_getIndexedNext(Indexed* indexed);
 
@@ -141,7 +154,7 @@ Expr*
 icode_getIndexedValue(Indexed* indexed);
 
 ForPrefix*
-icode_newForPrefix(unsigned int test, unsigned int enter);
+icode_newForPrefix(unsigned int test, unsigned int enter, unsigned int exitList);
 
 unsigned int
 icode_getForPrefixTest(ForPrefix* f);
@@ -149,4 +162,7 @@ icode_getForPrefixTest(ForPrefix* f);
 unsigned int
 icode_getForPrefixEnter(ForPrefix* f);
 
+unsigned int
+icode_getForPrefixExit(ForPrefix* f);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,607 @@
+#include "ccp.h"
+#include "opt.h"
+#include "../cfg/cfg.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <string.h>
+#include <math.h>
+
+// functions with more variables times blocks than this are left as they are
+#define CCP_MAX_CELLS   (1u << 20)
+
+/*
+ * The value of a variable: NULL while no executable path has defined it,
+ * a constant expression, or BOTTOM once it may hold different values.
+ */
+static char bottomValue;
+#define BOTTOM  ((Expr*) &bottomValue)
+
+typedef struct CcpFunction {
+    unsigned firstBlock;
+    unsigned totalBlocks;
+    OptVariables* vars;
+    unsigned totalVars;
+
+    unsigned* visible;          // the variables calls may change
+    unsigned totalVisible;
+
+    Expr** out;                 // by block, the values leaving it
+    unsigned char* executable;  // by block
+    unsigned char* visited;
+    unsigned char* edges;       // by block, a bit per executable successor
+
+    unsigned* worklist;
+    unsigned char* inWorklist;
+    unsigned totalWork;
+} CcpFunction;
+
+/* ------------------------------------------ Static Declarations ------------------------------------------ */
+static void
+propagate_function(unsigned f);
+
+static void
+solve(CcpFunction* cf);
+
+static void
+rewrite(CcpFunction* cf);
+
+static void
+flow_into(CcpFunction* cf, unsigned b, Expr** state);
+
+static void
+transfer(CcpFunction* cf, Quad* q, Expr** state);
+
+static unsigned
+executable_successors(CcpFunction* cf, unsigned b, Expr** state);
+
+static void
+push_block(CcpFunction* cf, unsigned b);
+
+static Expr*
+value_of(CcpFunction* cf, Expr** state, Expr* e);
+
+static Expr*
+meet(Expr* v1, Expr* v2);
+
+static unsigned char
+same_value(Expr* v1, Expr* v2);
+
+static unsigned char
+is_constant_value(Expr* v);
+
+static Expr*
+fold_expression(IOPCodeType op, Expr* v1, Expr* v2);
+
+static unsigned char
+fold_branch(IOPCodeType op, Expr* v1, Expr* v2, unsigned char* taken);
+
+static unsigned char
+to_bool(Expr* v, unsigned char* result);
+
+static unsigned char
+is_substitutable(Quad* q, unsigned operand);
+
+/* ------------------------------------------ Implementation ------------------------------------------ */
+void
+ccp_run() {
+    for (unsigned f = 0; f < cfg_totalFunctions(); f++) {
+        propagate_function(f);
+    }
+}
+
+/* ------------------------------------------ Static Definitions ------------------------------------------ */
+static void
+propagate_function(unsigned f) {
+    CcpFunction cf;
+
+    cf.firstBlock = cfg_getFunctionFirstBlock(f);
+    cf.totalBlocks = cfg_getFunctionTotalBlocks(f);
+    cf.vars = opt_newVariables(f);
+    cf.totalVars = opt_totalVariables(cf.vars);
+
+    if (cf.totalVars && cf.totalBlocks > CCP_MAX_CELLS / cf.totalVars) {
+        opt_freeVariables(cf.vars);
+        return;
+    }
+
+    cf.visible = malloc(sizeof(unsigned) * (cf.totalVars + 1));
+    cf.out = calloc((size_t) cf.totalBlocks * cf.totalVars + 1, sizeof(Expr*));
+    cf.executable = calloc(cf.totalBlocks, 1);
+    cf.visited = calloc(cf.totalBlocks, 1);
+    cf.edges = calloc(cf.totalBlocks, 1);
+    cf.worklist = malloc(sizeof(unsigned) * cf.totalBlocks);
+    cf.inWorklist = calloc(cf.totalBlocks, 1);
+    cf.totalWork = 0;
+
+    if (!cf.visible || !cf.out || !cf.executable || !cf.visited || !cf.edges || !cf.worklist || !cf.inWorklist) {
+        printf("Error allocating memory for constant propagation.\n");
+        exit(1);
+    }
+
+    cf.totalVisible = 0;
+    for (unsigned v = 0; v < cf.totalVars; v++) {
+        if (opt_isVisibleToCalls(opt_getVariableEntry(cf.vars, v))) {
+            cf.visible[cf.totalVisible++] = v;
+        }
+    }
+
+    solve(&cf);
+    rewrite(&cf);
+
+    free(cf.visible);
+    free(cf.out);
+    free(cf.executable);
+    free(cf.visited);
+    free(cf.edges);
+    free(cf.worklist);
+    free(cf.inWorklist);
+    opt_freeVariables(cf.vars);
+}
+
+static void
+solve(CcpFunction* cf) {
+    Expr** state = malloc(sizeof(Expr*) * (cf->totalVars + 1));
+
+    if (!state) {
+        printf("Error allocating memory for constant propagation.\n");
+        exit(1);
+    }
+
+    cf->executable[0] = 1;
+    push_block(cf, cf->firstBlock);
+
+    while (cf->totalWork) {
+        unsigned b = cf->worklist[--cf->totalWork];
+        unsigned local = b - cf->firstBlock;
+        Expr** out = cf->out + (size_t) local * cf->totalVars;
+        unsigned char changed = !cf->visited[local];
+
+        cf->inWorklist[local] = 0;
+        cf->visited[local] = 1;
+
+        flow_into(cf, b, state);
+        for (unsigned i = cfg_getFirstQuad(b); i <= cfg_getLastQuad(b); i++) {
+            transfer(cf, quad_getAt(i), state);
+        }
+
+        for (unsigned v = 0; v < cf->totalVars; v++) {
+            if (!same_value(out[v], state[v])) {
+                out[v] = state[v];
+                changed = 1;
+            }
+        }
+
+        unsigned taken = executable_successors(cf, b, state);
+        for (unsigned i = 0; i < cfg_totalSuccessors(b); i++) {
+            unsigned succ = cfg_getSuccessor(b, i);
+
+            if (!(taken & (1u << i))) {
+                continue;
+            }
+            if (!(cf->edges[local] & (1u << i))) {
+                cf->edges[local] |= 1u << i;
+                cf->executable[succ - cf->firstBlock] = 1;
+                push_block(cf, succ);
+            }
+            else if (changed) {
+                push_block(cf, succ);
+            }
+        }
+    }
+
+    free(state);
+}
+
+static void
+rewrite(CcpFunction* cf) {
+    Expr** state = malloc(sizeof(Expr*) * (cf->totalVars + 1));
+
+    if (!state) {
+        printf("Error allocating memory for constant propagation.\n");
+        exit(1);
+    }
+
+    for (unsigned b = cf->firstBlock; b < cf->firstBlock + cf->totalBlocks; b++) {
+        if (!cf->executable[b - cf->firstBlock]) {
+            for (unsigned i = cfg_getFirstQuad(b); i <= cfg_getLastQuad(b); i++) {
+                IOPCodeType op = quad_getOpcode(i);
+                if (op != funcstart_op && op != funcend_op && op != nop_op) {
+                    opt_removeQuad(i);
+                }
+            }
+            continue;
+        }
+
+        flow_into(cf, b, state);
+        for (unsigned i = cfg_getFirstQuad(b); i <= cfg_getLastQuad(b); i++) {
+            Quad* q = quad_getAt(i);
+            IOPCodeType op = quad_getOpcode(i);
+            unsigned uses = opt_getUses(q);
+            unsigned char taken;
+
+            for (unsigned operand = OPT_ARG1; operand <= OPT_RESULT; operand <<= 1) {
+                Expr* value;
+
+                if (!(uses & operand) || !is_substitutable(q, operand)) {
+                    continue;
+                }
+                value = value_of(cf, state, opt_getOperand(q, operand));
+                if (is_constant_value(value) && opt_isVariable(opt_getOperand(q, operand))) {
+                    opt_setOperand(q, operand, value);
+                }
+            }
+
+            if (opt_getDefinition(q) == OPT_RESULT && op != assign_op) {
+                Expr* value = fold_expression(op, value_of(cf, state, quad_getArg1(q)),
+                                                  value_of(cf, state, quad_getArg2(q)));
+                if (value) {
+                    quad_setOpcode(q, assign_op);
+                    quad_setArg1(q, value);
+                    quad_setArg2(q, NULL);
+                }
+            }
+            else if (opt_isConditional(op) && quad_getLabel(q) != 0 &&
+                     fold_branch(op, value_of(cf, state, quad_getArg1(q)),
+                                     value_of(cf, state, quad_getArg2(q)), &taken)) {
+                if (taken) {
+                    quad_setOpcode(q, jump_op);
+                    quad_setArg1(q, NULL);
+                    quad_setArg2(q, NULL);
+                }
+                else {
+                    opt_removeQuad(i);
+                }
+            }
+
+            transfer(cf, q, state);
+        }
+    }
+
+    free(state);
+}
+
+// the values entering a block, met over its executable incoming edges
+static void
+flow_into(CcpFunction* cf, unsigned b, Expr** state) {
+    if (b == cf->firstBlock) {
+        for (unsigned v = 0; v < cf->totalVars; v++) {
+            state[v] = BOTTOM;
+        }
+        return;
+    }
+
+    for (unsigned v = 0; v < cf->totalVars; v++) {
+        state[v] = NULL;
+    }
+
+    for (unsigned i = 0; i < cfg_totalPredecessors(b); i++) {
+        unsigned pred = cfg_getPredecessor(b, i);
+        unsigned local = pred - cf->firstBlock;
+        Expr** out = cf->out + (size_t) local * cf->totalVars;
+        unsigned char executable = 0;
+
+        for (unsigned s = 0; s < cfg_totalSuccessors(pred); s++) {
+            if (cfg_getSuccessor(pred, s) == b && (cf->edges[local] & (1u << s))) {
+                executable = 1;
+            }
+        }
+
+        if (executable) {
+            for (unsigned v = 0; v < cf->totalVars; v++) {
+                state[v] = meet(state[v], out[v]);
+            }
+        }
+    }
+}
+
+static void
+transfer(CcpFunction* cf, Quad* q, Expr** state) {
+    IOPCodeType op = quad_getOpcode(quad_getIndex(q));
+    unsigned definition = opt_getDefinition(q);
+
+    if (op == call_op && opt_callRunsCode(q)) {
+        for (unsigned i = 0; i < cf->totalVisible; i++) {
+            state[cf->visible[i]] = BOTTOM;
+        }
+        return;
+    }
+
+    if (!definition) {
+        return;
+    }
+
+    unsigned v = opt_getVariable(cf->vars, opt_getOperand(q, definition));
+    if (v == CFG_NONE) {
+        return;
+    }
+
+    Expr* v1 = value_of(cf, state, quad_getArg1(q));
+    Expr* v2 = value_of(cf, state, quad_getArg2(q));
+
+    switch (op) {
+        case assign_op:
+            state[v] = v1;
+            break;
+        case add_op:
+        case sub_op:
+        case mul_op:
+        case div_op:
+        case mod_op:
+        case or_op:
+        case and_op:
+            if (!v1 || !v2) {
+                state[v] = NULL;
+            }
+            else {
+                Expr* value = fold_expression(op, v1, v2);
+                state[v] = value ? value : BOTTOM;
+            }
+            break;
+        case uminus_op:
+        case not_op:
+            if (!v1) {
+                state[v] = NULL;
+            }
+            else {
+                Expr* value = fold_expression(op, v1, NULL);
+                state[v] = value ? value : BOTTOM;
+            }
+            break;
+        default:
+            state[v] = BOTTOM;
+            break;
+    }
+}
+
+// a bit per successor of the block that control may take
+static unsigned
+executable_successors(CcpFunction* cf, unsigned b, Expr** state) {
+    unsigned last = cfg_getLastQuad(b);
+    Quad* q = quad_getAt(last);
+    IOPCodeType op = quad_getOpcode(last);
+    unsigned all = (1u << cfg_totalSuccessors(b)) - 1;
+    unsigned target;
+    unsigned char taken;
+
+    if (!opt_isConditional(op) || quad_getLabel(q) == 0) {
+        return all;
+    }
+
+    Expr* v1 = value_of(cf, state, quad_getArg1(q));
+    Expr* v2 = value_of(cf, state, quad_getArg2(q));
+
+    if (!fold_branch(op, v1, v2, &taken)) {
+        return all;
+    }
+
+    if (taken) {
+        target = quad_getLabel(q) < quad_totalQuads() ? cfg_getBlockOfQuad(quad_getLabel(q)) : CFG_NONE;
+    }
+    else {
+        target = b + 1 < cf->firstBlock + cf->totalBlocks ? b + 1 : CFG_NONE;
+    }
+
+    for (unsigned i = 0; i < cfg_totalSuccessors(b); i++) {
+        if (cfg_getSuccessor(b, i) == target) {
+            return 1u << i;
+        }
+    }
+    return 0;
+}
+
+static void
+push_block(CcpFunction* cf, unsigned b) {
+    unsigned local = b - cf->firstBlock;
+
+    if (!cf->inWorklist[local]) {
+        cf->inWorklist[local] = 1;
+        cf->worklist[cf->totalWork++] = b;
+    }
+}
+
+static Expr*
+value_of(CcpFunction* cf, Expr** state, Expr* e) {
+    if (!e) {
+        return BOTTOM;
+    }
+
+    switch (icode_getExprType(e)) {
+        case constnum_e:
+        case constbool_e:
+        case conststring_e:
+        case nil_e:
+            return e;
+        case programfunc_e:
+        case libraryfunc_e:
+            return BOTTOM;
+        default: {
+            unsigned v = opt_getVariable(cf->vars, e);
+            return v == CFG_NONE ? BOTTOM : state[v];
+        }
+    }
+}
+
+static Expr*
+meet(Expr* v1, Expr* v2) {
+    if (!v1) {
+        return v2;
+    }
+    if (!v2) {
+        return v1;
+    }
+    return same_value(v1, v2) ? v1 : BOTTOM;
+}
+
+static unsigned char
+same_value(Expr* v1, Expr* v2) {
+    if (v1 == v2) {
+        return 1;
+    }
+    if (!is_constant_value(v1) || !is_constant_value(v2) || icode_getExprType(v1) != icode_getExprType(v2)) {
+        return 0;
+    }
+
+    switch (icode_getExprType(v1)) {
+        case constnum_e: {
+            double n1 = icode_getNumConst(v1);
+            double n2 = icode_getNumConst(v2);
+            return n1 == n2 && signbit(n1) == signbit(n2);
+        }
+        case constbool_e:
+            return icode_getBoolConst(v1) == icode_getBoolConst(v2);
+        case conststring_e:
+            return strcmp(icode_getStringConst(v1), icode_getStringConst(v2)) == 0;
+        default:
+            return 1;
+    }
+}
+
+static unsigned char
+is_constant_value(Expr* v) {
+    return v != NULL && v != BOTTOM;
+}
+
+/*
+ * What the avm would compute, or NULL where it would compute something
+ * else than a finite number, or stop with an error.
+ */
+static Expr*
+fold_expression(IOPCodeType op, Expr* v1, Expr* v2) {
+    unsigned char b1, b2;
+    double n1, n2, result;
+
+    if (!is_constant_value(v1)) {
+        return NULL;
+    }
+
+    switch (op) {
+        case not_op:
+            return to_bool(v1, &b1) ? icode_newConstBoolean(!b1) : NULL;
+        case or_op:
+            if (!is_constant_value(v2) || !to_bool(v1, &b1) || !to_bool(v2, &b2)) {
+                return NULL;
+            }
+            return icode_newConstBoolean(b1 || b2);
+        case and_op:
+            if (!is_constant_value(v2) || !to_bool(v1, &b1) || !to_bool(v2, &b2)) {
+                return NULL;
+            }
+            return icode_newConstBoolean(b1 && b2);
+        case uminus_op:
+            if (icode_getExprType(v1) != constnum_e) {
+                return NULL;
+            }
+            result = -icode_getNumConst(v1);
+            return icode_newConstNum(result);
+        case add_op:
+        case sub_op:
+        case mul_op:
+        case div_op:
+        case mod_op:
+            break;
+        default:
+            return NULL;
+    }
+
+    if (!is_constant_value(v2) || icode_getExprType(v1) != constnum_e || icode_getExprType(v2) != constnum_e) {
+        return NULL;
+    }
+
+    n1 = icode_getNumConst(v1);
+    n2 = icode_getNumConst(v2);
+
+    switch (op) {
+        case add_op:    result = n1 + n2; break;
+        case sub_op:    result = n1 - n2; break;
+        case mul_op:    result = n1 * n2; break;
+        case div_op:    result = n1 / n2; break;
+        case mod_op:
+            // the avm takes both as unsigned integers
+            if (!(n1 >= 0 && n1 < 4294967296.0 && n2 >= 1 && n2 < 4294967296.0) ||
+                n1 != (double) (unsigned) n1 || n2 != (double) (unsigned) n2) {
+                return NULL;
+            }
+            result = (unsigned) n1 % (unsigned) n2;
+            break;
+        default:
+            return NULL;
+    }
+
+    return isfinite(result) ? icode_newConstNum(result) : NULL;
+}
+
+static unsigned char
+fold_branch(IOPCodeType op, Expr* v1, Expr* v2, unsigned char* taken) {
+    unsigned char b1, b2, equal;
+
+    if (!is_constant_value(v1) || !is_constant_value(v2)) {
+        return 0;
+    }
+
+    ExprType t1 = icode_getExprType(v1);
+    ExprType t2 = icode_getExprType(v2);
+
+    if (op == if_eq_op || op == if_noteq_op) {
+        if (t1 == constbool_e || t2 == constbool_e) {
+            if (!to_bool(v1, &b1) || !to_bool(v2, &b2)) {
+                return 0;
+            }
+            equal = b1 == b2;
+        }
+        else if (t1 == nil_e || t2 == nil_e) {
+            equal = t1 == nil_e && t2 == nil_e;
+        }
+        else if (t1 != t2) {
+            return 0;
+        }
+        else if (t1 == constnum_e) {
+            equal = icode_getNumConst(v1) == icode_getNumConst(v2);
+        }
+        else {
+            equal = strcmp(icode_getStringConst(v1), icode_getStringConst(v2)) == 0;
+        }
+
+        *taken = op == if_eq_op ? equal : !equal;
+        return 1;
+    }
+
+    if (t1 != constnum_e || t2 != constnum_e) {
+        return 0;
+    }
+
+    double n1 = icode_getNumConst(v1);
+    double n2 = icode_getNumConst(v2);
+
+    switch (op) {
+        case if_greater_op:     *taken = n1 > n2;  break;
+        case if_greatereq_op:   *taken = n1 >= n2; break;
+        case if_less_op:        *taken = n1 < n2;  break;
+        case if_lesseq_op:      *taken = n1 <= n2; break;
+        default:                return 0;
+    }
+    return 1;
+}
+
+static unsigned char
+to_bool(Expr* v, unsigned char* result) {
+    switch (icode_getExprType(v)) {
+        case constnum_e:    *result = icode_getNumConst(v) != 0; return 1;
+        case constbool_e:   *result = icode_getBoolConst(v); return 1;
+        case conststring_e: *result = icode_getStringConst(v)[0] != 0; return 1;
+        case nil_e:         *result = 0; return 1;
+        default:            return 0;
+    }
+}
+
+// tables and called functions stay in their variables, constants only fail there
+static unsigned char
+is_substitutable(Quad* q, unsigned operand) {
+    IOPCodeType op = quad_getOpcode(quad_getIndex(q));
+
+    if (operand != OPT_ARG1) {
+        return 1;
+    }
+    return op != tablegetelem_op && op != tablesetelem_op && op != call_op;
+}
@@ -0,0 +1,14 @@
+#ifndef CCP_H
+#define CCP_H
+
+/*
+ * Conditional constant propagation over the blocks of every function.
+ * Variables known to hold the same constant on every executable path are
+ * replaced by it, expressions over constants are folded into assigns,
+ * branches on constants become jumps or go away, and the quads of blocks
+ * no executable edge reaches are removed.
+ */
+void
+ccp_run();
+
+#endif
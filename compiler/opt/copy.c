@@ -0,0 +1,406 @@
+#include "copy.h"
+#include "opt.h"
+#include "liveness.h"
+#include "../cfg/cfg.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <string.h>
+
+// functions with more blocks times words of copies than this are left as they are
+#define COPY_MAX_WORDS  (1u << 20)
+
+typedef unsigned long CopySet;
+
+#define WORD_BITS   (sizeof(CopySet) * 8)
+
+typedef struct CopyFunction {
+    unsigned function;
+    unsigned firstBlock;
+    unsigned totalBlocks;
+    OptVariables* vars;
+    unsigned totalVars;
+
+    unsigned totalCopies;
+    unsigned* copyQuad;         // by copy
+    unsigned* copyDest;         // the variables copied to and from
+    Expr** copySource;          // as the assign read it when the copies were found
+    unsigned* copyOfQuad;       // by quad, CFG_NONE if not a copy
+
+    unsigned* involving;        // by variable, the copies to or from it
+    unsigned* involvingStart;
+
+    unsigned* visible;
+    unsigned totalVisible;
+
+    unsigned words;
+    CopySet* in;                // by block, the copies holding on entry
+    CopySet* out;
+} CopyFunction;
+
+/* ------------------------------------------ Static Declarations ------------------------------------------ */
+static void
+propagate_function(unsigned f, unsigned* copyOfQuad);
+
+static void
+find_copies(CopyFunction* cf);
+
+static void
+solve(CopyFunction* cf);
+
+static void
+rewrite(CopyFunction* cf);
+
+static void
+flow_into(CopyFunction* cf, unsigned b, CopySet* set);
+
+static void
+transfer(CopyFunction* cf, Quad* q, CopySet* set);
+
+static void
+kill_variable(CopyFunction* cf, unsigned v, CopySet* set);
+
+static Expr*
+available_source(CopyFunction* cf, Expr* e, CopySet* set);
+
+static void
+coalesce_function(unsigned f);
+
+static unsigned char
+reads_variable(Quad* q, SymbolTableEntry* entry);
+
+/* ------------------------------------------ Implementation ------------------------------------------ */
+void
+copy_propagate() {
+    unsigned* copyOfQuad = opt_allocate(sizeof(unsigned) * quad_totalQuads());
+
+    memset(copyOfQuad, 0xff, sizeof(unsigned) * quad_totalQuads());
+
+    for (unsigned f = 0; f < cfg_totalFunctions(); f++) {
+        propagate_function(f, copyOfQuad);
+    }
+
+    free(copyOfQuad);
+}
+
+void
+copy_coalesce() {
+    for (unsigned f = 0; f < cfg_totalFunctions(); f++) {
+        coalesce_function(f);
+    }
+}
+
+/* ------------------------------------------ Static Definitions ------------------------------------------ */
+static void
+propagate_function(unsigned f, unsigned* copyOfQuad) {
+    CopyFunction cf;
+
+    memset(&cf, 0, sizeof(CopyFunction));
+    cf.function = f;
+    cf.firstBlock = cfg_getFunctionFirstBlock(f);
+    cf.totalBlocks = cfg_getFunctionTotalBlocks(f);
+    cf.vars = opt_newVariables(f);
+    cf.totalVars = opt_totalVariables(cf.vars);
+    cf.copyOfQuad = copyOfQuad;
+
+    find_copies(&cf);
+
+    cf.words = (cf.totalCopies + WORD_BITS - 1) / WORD_BITS;
+    if (cf.totalCopies && cf.totalBlocks <= COPY_MAX_WORDS / cf.words) {
+        cf.in = opt_allocate(sizeof(CopySet) * cf.totalBlocks * cf.words);
+        cf.out = opt_allocate(sizeof(CopySet) * cf.totalBlocks * cf.words);
+
+        solve(&cf);
+        rewrite(&cf);
+
+        free(cf.in);
+        free(cf.out);
+    }
+
+    for (unsigned c = 0; c < cf.totalCopies; c++) {
+        copyOfQuad[cf.copyQuad[c]] = CFG_NONE;
+    }
+
+    free(cf.copyQuad);
+    free(cf.copyDest);
+    free(cf.copySource);
+    free(cf.involving);
+    free(cf.involvingStart);
+    free(cf.visible);
+    opt_freeVariables(cf.vars);
+}
+
+// the assigns from a variable to another in the reachable blocks
+static void
+find_copies(CopyFunction* cf) {
+    unsigned* counts = opt_allocate(sizeof(unsigned) * (cf->totalVars + 1));
+    unsigned size = 0;
+
+    memset(counts, 0, sizeof(unsigned) * (cf->totalVars + 1));
+
+    for (unsigned r = 0; r < cfg_getFunctionTotalReachable(cf->function); r++) {
+        unsigned b = cfg_getFunctionRpoBlock(cf->function, r);
+
+        for (unsigned i = cfg_getFirstQuad(b); i <= cfg_getLastQuad(b); i++) {
+            Quad* q = quad_getAt(i);
+            unsigned dest, source;
+
+            if (quad_getOpcode(i) != assign_op) {
+                continue;
+            }
+            dest = opt_getVariable(cf->vars, quad_getResult(q));
+            source = opt_getVariable(cf->vars, quad_getArg1(q));
+            if (dest == CFG_NONE || source == CFG_NONE || dest == source) {
+                continue;
+            }
+
+            if (cf->totalCopies == size) {
+                size = size ? size * 2 : 32;
+                cf->copyQuad = realloc(cf->copyQuad, sizeof(unsigned) * size);
+                cf->copyDest = realloc(cf->copyDest, sizeof(unsigned) * size * 2);
+                cf->copySource = realloc(cf->copySource, sizeof(Expr*) * size);
+                if (!cf->copyQuad || !cf->copyDest || !cf->copySource) {
+                    printf("Error allocating memory for copy propagation.\n");
+                    exit(1);
+                }
+            }
+
+            cf->copyOfQuad[i] = cf->totalCopies;
+            cf->copyQuad[cf->totalCopies] = i;
+            cf->copyDest[cf->totalCopies * 2] = dest;
+            cf->copyDest[cf->totalCopies * 2 + 1] = source;
+            cf->copySource[cf->totalCopies] = quad_getArg1(q);
+            cf->totalCopies++;
+
+            counts[dest]++;
+            counts[source]++;
+        }
+    }
+
+    cf->involvingStart = opt_allocate(sizeof(unsigned) * (cf->totalVars + 1));
+    cf->involving = opt_allocate(sizeof(unsigned) * (cf->totalCopies * 2 + 1));
+
+    unsigned start = 0;
+    for (unsigned v = 0; v < cf->totalVars; v++) {
+        cf->involvingStart[v] = start;
+        start += counts[v];
+        counts[v] = cf->involvingStart[v];
+    }
+    cf->involvingStart[cf->totalVars] = start;
+
+    for (unsigned c = 0; c < cf->totalCopies; c++) {
+        cf->involving[counts[cf->copyDest[c * 2]]++] = c;
+        cf->involving[counts[cf->copyDest[c * 2 + 1]]++] = c;
+    }
+
+    cf->visible = opt_allocate(sizeof(unsigned) * (cf->totalVars + 1));
+    for (unsigned v = 0; v < cf->totalVars; v++) {
+        if (opt_isVisibleToCalls(opt_getVariableEntry(cf->vars, v))) {
+            cf->visible[cf->totalVisible++] = v;
+        }
+    }
+
+    free(counts);
+}
+
+// forwards in reverse postorder, the copies holding on every incoming path
+static void
+solve(CopyFunction* cf) {
+    unsigned totalReachable = cfg_getFunctionTotalReachable(cf->function);
+    CopySet* set = opt_allocate(sizeof(CopySet) * cf->words);
+    unsigned char changed;
+
+    memset(cf->out, 0xff, sizeof(CopySet) * cf->totalBlocks * cf->words);
+
+    do {
+        changed = 0;
+
+        for (unsigned r = 0; r < totalReachable; r++) {
+            unsigned b = cfg_getFunctionRpoBlock(cf->function, r);
+            CopySet* out = cf->out + (size_t) (b - cf->firstBlock) * cf->words;
+
+            flow_into(cf, b, set);
+            for (unsigned i = cfg_getFirstQuad(b); i <= cfg_getLastQuad(b); i++) {
+                transfer(cf, quad_getAt(i), set);
+            }
+
+            if (memcmp(out, set, sizeof(CopySet) * cf->words) != 0) {
+                memcpy(out, set, sizeof(CopySet) * cf->words);
+                changed = 1;
+            }
+        }
+    } while (changed);
+
+    free(set);
+}
+
+static void
+rewrite(CopyFunction* cf) {
+    CopySet* set = opt_allocate(sizeof(CopySet) * cf->words);
+
+    for (unsigned r = 0; r < cfg_getFunctionTotalReachable(cf->function); r++) {
+        unsigned b = cfg_getFunctionRpoBlock(cf->function, r);
+
+        flow_into(cf, b, set);
+        for (unsigned i = cfg_getFirstQuad(b); i <= cfg_getLastQuad(b); i++) {
+            Quad* q = quad_getAt(i);
+            unsigned uses = opt_getUses(q);
+
+            for (unsigned operand = OPT_ARG1; operand <= OPT_RESULT; operand <<= 1) {
+                if (uses & operand) {
+                    Expr* source = available_source(cf, opt_getOperand(q, operand), set);
+                    if (source) {
+                        opt_setOperand(q, operand, source);
+                    }
+                }
+            }
+            transfer(cf, q, set);
+        }
+    }
+
+    free(set);
+}
+
+static void
+flow_into(CopyFunction* cf, unsigned b, CopySet* set) {
+    unsigned char first = 1;
+
+    memset(set, 0, sizeof(CopySet) * cf->words);
+    if (b == cf->firstBlock) {
+        return;
+    }
+
+    for (unsigned i = 0; i < cfg_totalPredecessors(b); i++) {
+        unsigned pred = cfg_getPredecessor(b, i);
+        CopySet* out = cf->out + (size_t) (pred - cf->firstBlock) * cf->words;
+
+        if (!cfg_isReachable(pred)) {
+            continue;
+        }
+        for (unsigned w = 0; w < cf->words; w++) {
+            set[w] = first ? out[w] : set[w] & out[w];
+        }
+        first = 0;
+    }
+}
+
+static void
+transfer(CopyFunction* cf, Quad* q, CopySet* set) {
+    unsigned definition = opt_getDefinition(q);
+    unsigned c = cf->copyOfQuad[quad_getIndex(q)];
+
+    if (definition) {
+        kill_variable(cf, opt_getVariable(cf->vars, opt_getOperand(q, definition)), set);
+    }
+    if (quad_getOpcode(quad_getIndex(q)) == call_op && opt_callRunsCode(q)) {
+        for (unsigned i = 0; i < cf->totalVisible; i++) {
+            kill_variable(cf, cf->visible[i], set);
+        }
+    }
+    if (c != CFG_NONE) {
+        set[c / WORD_BITS] |= (CopySet) 1 << (c % WORD_BITS);
+    }
+}
+
+static void
+kill_variable(CopyFunction* cf, unsigned v, CopySet* set) {
+    if (v == CFG_NONE) {
+        return;
+    }
+    for (unsigned i = cf->involvingStart[v]; i < cf->involvingStart[v + 1]; i++) {
+        unsigned c = cf->involving[i];
+        set[c / WORD_BITS] &= ~((CopySet) 1 << (c % WORD_BITS));
+    }
+}
+
+// the variable holding the same value as e at the end of the chain of copies, NULL if none
+static Expr*
+available_source(CopyFunction* cf, Expr* e, CopySet* set) {
+    Expr* source = NULL;
+    unsigned v = opt_getVariable(cf->vars, e);
+
+    // a copy holding kills those from its destination, so the chain cannot loop
+    for (unsigned steps = 0; v != CFG_NONE && steps < cf->totalCopies; steps++) {
+        unsigned next = CFG_NONE;
+
+        for (unsigned i = cf->involvingStart[v]; i < cf->involvingStart[v + 1]; i++) {
+            unsigned c = cf->involving[i];
+            if (cf->copyDest[c * 2] == v && (set[c / WORD_BITS] & ((CopySet) 1 << (c % WORD_BITS)))) {
+                source = cf->copySource[c];
+                next = cf->copyDest[c * 2 + 1];
+                break;
+            }
+        }
+        v = next;
+    }
+    return source;
+}
+
+static void
+coalesce_function(unsigned f) {
+    OptVariables* vars = opt_newVariables(f);
+    Liveness* lv = liveness_build(f, vars);
+
+    if (!lv) {
+        opt_freeVariables(vars);
+        return;
+    }
+
+    LiveSet* live = liveness_newSet(lv);
+
+    for (unsigned r = 0; r < cfg_getFunctionTotalReachable(f); r++) {
+        unsigned b = cfg_getFunctionRpoBlock(f, r);
+
+        liveness_getOut(lv, b, live);
+
+        for (unsigned i = cfg_getLastQuad(b) + 1; i-- > cfg_getFirstQuad(b);) {
+            Quad* assign = quad_getAt(i);
+            Expr* dest = quad_getResult(assign);
+            Expr* temp = quad_getArg1(assign);
+            unsigned d = i;
+
+            if (quad_getOpcode(i) != assign_op || !opt_isVariable(dest) || !opt_isVariable(temp) ||
+                icode_getExprEntry(dest) == icode_getExprEntry(temp) ||
+                liveness_contains(live, opt_getVariable(vars, temp))) {
+                liveness_stepBack(lv, assign, live);
+                continue;
+            }
+
+            while (d > cfg_getFirstQuad(b) && quad_getOpcode(d - 1) == nop_op) {
+                d--;
+            }
+
+            Quad* def = d > cfg_getFirstQuad(b) ? quad_getAt(d - 1) : NULL;
+            IOPCodeType op = def ? quad_getOpcode(d - 1) : nop_op;
+
+            // assigns and table reads clear their destination before reading their operands
+            if (!def || opt_getDefinition(def) != OPT_RESULT ||
+                icode_getExprEntry(quad_getResult(def)) != icode_getExprEntry(temp) ||
+                ((op == assign_op || op == tablegetelem_op) && reads_variable(def, icode_getExprEntry(dest)))) {
+                liveness_stepBack(lv, assign, live);
+                continue;
+            }
+
+            quad_setResult(def, dest);
+            opt_removeQuad(i);
+        }
+    }
+
+    free(live);
+    liveness_destroy(lv);
+    opt_freeVariables(vars);
+}
+
+static unsigned char
+reads_variable(Quad* q, SymbolTableEntry* entry) {
+    unsigned uses = opt_getUses(q);
+
+    for (unsigned operand = OPT_ARG1; operand <= OPT_RESULT; operand <<= 1) {
+        Expr* e = opt_getOperand(q, operand);
+        if ((uses & operand) && opt_isVariable(e) && icode_getExprEntry(e) == entry) {
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,20 @@
+#ifndef COPY_H
+#define COPY_H
+
+/*
+ * Copy propagation: where an assign x = y still holds, reads of x read y
+ * instead, following chains of such assigns, so the intermediate copies
+ * die for dead code elimination to remove.
+ */
+void
+copy_propagate();
+
+/*
+ * Coalescing: a value computed into a variable that an assign right after
+ * copies elsewhere, and that nothing reads afterwards, is computed into
+ * the assign's destination directly and the assign is removed.
+ */
+void
+copy_coalesce();
+
+#endif
@@ -0,0 +1,182 @@
+#include "dce.h"
+#include "opt.h"
+#include "liveness.h"
+#include "../cfg/cfg.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <string.h>
+
+/* ------------------------------------------ Static Declarations ------------------------------------------ */
+static void
+remove_unreachable();
+
+static unsigned
+remove_dead_stores(unsigned f);
+
+static unsigned char
+is_removable(unsigned i);
+
+static unsigned char
+rereads_stored_element(unsigned i);
+
+static unsigned char
+same_operand(Expr* e1, Expr* e2);
+
+static unsigned char
+is_constant_of(Expr* e, ExprType type);
+
+/* ------------------------------------------ Implementation ------------------------------------------ */
+void
+dce_run() {
+    unsigned removed;
+
+    remove_unreachable();
+
+    do {
+        removed = 0;
+        for (unsigned f = 0; f < cfg_totalFunctions(); f++) {
+            removed += remove_dead_stores(f);
+        }
+    } while (removed);
+}
+
+/* ------------------------------------------ Static Definitions ------------------------------------------ */
+static void
+remove_unreachable() {
+    for (unsigned b = 0; b < cfg_totalBlocks(); b++) {
+        if (cfg_isReachable(b)) {
+            continue;
+        }
+        for (unsigned i = cfg_getFirstQuad(b); i <= cfg_getLastQuad(b); i++) {
+            IOPCodeType op = quad_getOpcode(i);
+            if (op != funcstart_op && op != funcend_op && op != nop_op) {
+                opt_removeQuad(i);
+            }
+        }
+    }
+}
+
+static unsigned
+remove_dead_stores(unsigned f) {
+    OptVariables* vars = opt_newVariables(f);
+    Liveness* lv = liveness_build(f, vars);
+    unsigned removed = 0;
+
+    if (!lv) {
+        opt_freeVariables(vars);
+        return 0;
+    }
+
+    LiveSet* live = liveness_newSet(lv);
+    unsigned first = cfg_getFunctionFirstBlock(f);
+
+    for (unsigned b = first; b < first + cfg_getFunctionTotalBlocks(f); b++) {
+        if (!cfg_isReachable(b)) {
+            continue;
+        }
+
+        liveness_getOut(lv, b, live);
+
+        for (unsigned i = cfg_getLastQuad(b) + 1; i-- > cfg_getFirstQuad(b);) {
+            Quad* q = quad_getAt(i);
+            unsigned definition = opt_getDefinition(q);
+
+            if (definition && is_removable(i)) {
+                unsigned v = opt_getVariable(vars, opt_getOperand(q, definition));
+
+                if (v != CFG_NONE && !liveness_contains(live, v)) {
+                    opt_removeQuad(i);
+                    removed++;
+                    continue;
+                }
+            }
+            liveness_stepBack(lv, q, live);
+        }
+    }
+
+    free(live);
+    liveness_destroy(lv);
+    opt_freeVariables(vars);
+
+    return removed;
+}
+
+/*
+ * Quads whose only effect is their definition. Arithmetic stops the avm
+ * on anything but numbers, and reading a missing table element does too,
+ * so those stay unless they cannot fail.
+ */
+static unsigned char
+is_removable(unsigned i) {
+    Quad* q = quad_getAt(i);
+
+    switch (quad_getOpcode(i)) {
+        case assign_op:
+        case getretval_op:
+        case tablecreate_op:
+            return 1;
+        case add_op:
+        case sub_op:
+        case mul_op:
+        case div_op:
+        case mod_op:
+            return is_constant_of(quad_getArg1(q), constnum_e) && is_constant_of(quad_getArg2(q), constnum_e);
+        case uminus_op:
+            return is_constant_of(quad_getArg1(q), constnum_e);
+        case tablegetelem_op:
+            return rereads_stored_element(i);
+        default:
+            return 0;
+    }
+}
+
+// the element was just stored, as an assignment to a table item reads it back
+static unsigned char
+rereads_stored_element(unsigned i) {
+    Quad* get = quad_getAt(i);
+    unsigned block = cfg_getBlockOfQuad(i);
+    unsigned j = i;
+
+    while (j > cfg_getFirstQuad(block) && quad_getOpcode(j - 1) == nop_op) {
+        j--;
+    }
+    if (j == cfg_getFirstQuad(block) || quad_getOpcode(j - 1) != tablesetelem_op) {
+        return 0;
+    }
+
+    Quad* set = quad_getAt(j - 1);
+
+    return opt_isVariable(quad_getArg1(get)) && opt_isVariable(quad_getArg1(set)) &&
+           icode_getExprEntry(quad_getArg1(get)) == icode_getExprEntry(quad_getArg1(set)) &&
+           same_operand(quad_getArg2(get), quad_getArg2(set));
+}
+
+static unsigned char
+same_operand(Expr* e1, Expr* e2) {
+    if (e1 == e2) {
+        return 1;
+    }
+    if (!e1 || !e2) {
+        return 0;
+    }
+    if (opt_isVariable(e1) || opt_isVariable(e2)) {
+        return opt_isVariable(e1) && opt_isVariable(e2) && icode_getExprEntry(e1) == icode_getExprEntry(e2);
+    }
+    if (icode_getExprType(e1) != icode_getExprType(e2)) {
+        return 0;
+    }
+
+    switch (icode_getExprType(e1)) {
+        case constnum_e:        return icode_getNumConst(e1) == icode_getNumConst(e2);
+        case conststring_e:     return strcmp(icode_getStringConst(e1), icode_getStringConst(e2)) == 0;
+        case constbool_e:       return icode_getBoolConst(e1) == icode_getBoolConst(e2);
+        default:                return 0;
+    }
+}
+
+static unsigned char
+is_constant_of(Expr* e, ExprType type) {
+    return e && !opt_isVariable(e) && icode_getExprType(e) == type;
+}
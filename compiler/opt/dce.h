@@ -0,0 +1,14 @@
+#ifndef DCE_H
+#define DCE_H
+
+/*
+ * Dead code elimination. The quads of blocks the entry of their function
+ * does not reach are removed, and so are the quads that only write a
+ * variable no later quad reads, when running them can have no other
+ * effect. Removing a quad can leave the ones computing its operands dead
+ * in turn, so this goes on until nothing changes.
+ */
+void
+dce_run();
+
+#endif
@@ -0,0 +1,310 @@
+#include "jumps.h"
+#include "opt.h"
+#include "../cfg/cfg.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <string.h>
+
+// bounds the passes of layout, each of which can move every jump once
+#define JUMPS_MAX_PASSES    64
+
+/*
+ * The quads in the order they will be generated, as a doubly linked list.
+ * Quad 0 heads it and the past-the-end label, totalQuads, ends it.
+ */
+typedef struct Layout {
+    unsigned totalQuads;
+    unsigned* next;
+    unsigned* prev;
+    unsigned* depth;        // by quad, the loop depth of its block
+    unsigned* segment;      // by quad, the run of consecutive quads of one function it is in
+    unsigned* targeted;     // by quad, how many branches jump to it
+} Layout;
+
+/* ------------------------------------------ Static Declarations ------------------------------------------ */
+static void
+new_layout(Layout* l);
+
+static void
+free_layout(Layout* l);
+
+static void
+thread_jumps(Layout* l);
+
+static unsigned char
+place_target(Layout* l, unsigned j);
+
+static void
+remove_redundant_jumps(Layout* l);
+
+static void
+invert_equalities(Layout* l);
+
+static void
+retarget(Layout* l, unsigned q, unsigned label);
+
+static void
+remove_jump(Layout* l, unsigned q);
+
+static void
+unlink_range(Layout* l, unsigned first, unsigned last);
+
+static void
+insert_after(Layout* l, unsigned at, unsigned first, unsigned last);
+
+static unsigned
+skip_nops(Layout* l, unsigned q);
+
+static unsigned
+previous_quad(Layout* l, unsigned q);
+
+/* ------------------------------------------ Implementation ------------------------------------------ */
+void
+jumps_run() {
+    Layout l;
+    unsigned changed;
+    unsigned passes = 0;
+
+    new_layout(&l);
+    thread_jumps(&l);
+
+    do {
+        changed = 0;
+        for (unsigned q = l.next[0], next; q != l.totalQuads; q = next) {
+            next = l.next[q];
+            if (quad_getOpcode(q) == jump_op && place_target(&l, q)) {
+                changed = 1;
+            }
+        }
+    } while (changed && ++passes < JUMPS_MAX_PASSES);
+
+    remove_redundant_jumps(&l);
+    invert_equalities(&l);
+    remove_redundant_jumps(&l);
+
+    unsigned* order = opt_allocate(sizeof(unsigned) * l.totalQuads);
+    unsigned i = 0;
+
+    for (unsigned q = 0; q != l.totalQuads; q = l.next[q]) {
+        order[i++] = q;
+    }
+    assert(i == l.totalQuads);
+
+    quad_reorder(order);
+
+    free(order);
+    free_layout(&l);
+}
+
+/* ------------------------------------------ Static Definitions ------------------------------------------ */
+static void
+new_layout(Layout* l) {
+    unsigned n = quad_totalQuads();
+
+    l->totalQuads = n;
+    l->next = opt_allocate(sizeof(unsigned) * (n + 1));
+    l->prev = opt_allocate(sizeof(unsigned) * (n + 1));
+    l->depth = opt_allocate(sizeof(unsigned) * n);
+    l->segment = opt_allocate(sizeof(unsigned) * n);
+    l->targeted = opt_allocate(sizeof(unsigned) * (n + 1));
+
+    memset(l->targeted, 0, sizeof(unsigned) * (n + 1));
+    l->depth[0] = 0;
+    l->segment[0] = 0;
+
+    for (unsigned q = 0; q <= n; q++) {
+        l->next[q] = q + 1;
+        l->prev[q] = q - 1;
+    }
+
+    for (unsigned q = 1, function = 0; q < n; q++) {
+        unsigned b = cfg_getBlockOfQuad(q);
+
+        l->depth[q] = cfg_isReachable(b) ? cfg_getBlockLoopDepth(b) : 0;
+        l->segment[q] = l->segment[q - 1] + (cfg_getBlockFunction(b) != function);
+        function = cfg_getBlockFunction(b);
+
+        if (opt_isBranch(quad_getOpcode(q))) {
+            l->targeted[quad_getLabel(quad_getAt(q))]++;
+        }
+    }
+}
+
+static void
+free_layout(Layout* l) {
+    free(l->next);
+    free(l->prev);
+    free(l->depth);
+    free(l->segment);
+    free(l->targeted);
+}
+
+// every branch to a nop or to a jump goes where they would lead instead
+static void
+thread_jumps(Layout* l) {
+    for (unsigned q = 1; q < l->totalQuads; q++) {
+        if (!opt_isBranch(quad_getOpcode(q))) {
+            continue;
+        }
+
+        unsigned target = skip_nops(l, quad_getLabel(quad_getAt(q)));
+
+        for (unsigned hops = 0; hops < l->totalQuads && target != l->totalQuads && quad_getOpcode(target) == jump_op; hops++) {
+            unsigned next = skip_nops(l, quad_getLabel(quad_getAt(target)));
+            if (next == target) {
+                break;
+            }
+            target = next;
+        }
+
+        retarget(l, q, target);
+    }
+}
+
+/*
+ * Moves the quads from the target of jump j up to the jump or return ending
+ * them right after j, so that they run without it. Whatever fell into them
+ * where they were falls into j instead, which is only worth it when j is in
+ * a deeper loop: its back edge becomes a fall through and the jump runs once,
+ * on entry to the loop. Code never moves past a nested function, as a call
+ * generated before the function's funcstart would not know its address.
+ */
+static unsigned char
+place_target(Layout* l, unsigned j) {
+    unsigned target = quad_getLabel(quad_getAt(j));
+    unsigned last;
+
+    if (l->targeted[j] || target == l->totalQuads || target == j) {
+        return 0;
+    }
+
+    for (last = target; ; last = l->next[last]) {
+        if (last == l->totalQuads || last == j || l->segment[last] != l->segment[j]) {
+            return 0;
+        }
+
+        IOPCodeType op = quad_getOpcode(last);
+        if (op == funcstart_op || op == funcend_op) {
+            return 0;
+        }
+        if (op == jump_op || op == ret_op) {
+            break;
+        }
+    }
+
+    unsigned before = previous_quad(l, target);
+    unsigned char fallsInto = before == 0 || opt_fallsThrough(before);
+
+    if (before == j || (fallsInto && l->depth[j] <= l->depth[before])) {
+        return 0;
+    }
+
+    unsigned at = l->prev[target];
+    unlink_range(l, target, last);
+
+    if (fallsInto) {
+        unsigned place = l->prev[j];
+
+        unlink_range(l, j, j);
+        insert_after(l, place, target, last);
+        insert_after(l, at, j, j);
+        l->depth[j] = l->depth[before];
+    }
+    else {
+        insert_after(l, j, target, last);
+        remove_jump(l, j);
+    }
+
+    return 1;
+}
+
+// jumps to the quad that follows them anyway
+static void
+remove_redundant_jumps(Layout* l) {
+    for (unsigned q = l->next[0]; q != l->totalQuads; q = l->next[q]) {
+        if (quad_getOpcode(q) == jump_op && quad_getLabel(quad_getAt(q)) == skip_nops(l, l->next[q])) {
+            remove_jump(l, q);
+        }
+    }
+}
+
+/*
+ * A test for equality that branches over a jump branches to where the jump
+ * went on the opposite test. The ordered comparisons are left alone, as with
+ * NaN both a < b and a >= b are false.
+ */
+static void
+invert_equalities(Layout* l) {
+    for (unsigned q = l->next[0]; q != l->totalQuads; q = l->next[q]) {
+        IOPCodeType op = quad_getOpcode(q);
+        if (op != if_eq_op && op != if_noteq_op) {
+            continue;
+        }
+
+        unsigned jump = skip_nops(l, l->next[q]);
+        if (jump == l->totalQuads || quad_getOpcode(jump) != jump_op || l->targeted[jump]) {
+            continue;
+        }
+        if (quad_getLabel(quad_getAt(q)) != skip_nops(l, l->next[jump])) {
+            continue;
+        }
+
+        quad_setOpcode(quad_getAt(q), op == if_eq_op ? if_noteq_op : if_eq_op);
+        retarget(l, q, quad_getLabel(quad_getAt(jump)));
+        remove_jump(l, jump);
+    }
+}
+
+static void
+retarget(Layout* l, unsigned q, unsigned label) {
+    l->targeted[quad_getLabel(quad_getAt(q))]--;
+    l->targeted[label]++;
+    quad_patchLabel(q, label);
+}
+
+static void
+remove_jump(Layout* l, unsigned q) {
+    l->targeted[quad_getLabel(quad_getAt(q))]--;
+    opt_removeQuad(q);
+}
+
+static void
+unlink_range(Layout* l, unsigned first, unsigned last) {
+    unsigned before = l->prev[first];
+    unsigned after = l->next[last];
+
+    l->next[before] = after;
+    l->prev[after] = before;
+}
+
+static void
+insert_after(Layout* l, unsigned at, unsigned first, unsigned last) {
+    unsigned after = l->next[at];
+
+    l->next[at] = first;
+    l->prev[first] = at;
+    l->next[last] = after;
+    l->prev[after] = last;
+}
+
+static unsigned
+skip_nops(Layout* l, unsigned q) {
+    while (q != l->totalQuads && quad_getOpcode(q) == nop_op) {
+        q = l->next[q];
+    }
+    return q;
+}
+
+// the quad before q in the layout that is not a nop, 0 at the start of the program
+static unsigned
+previous_quad(Layout* l, unsigned q) {
+    q = l->prev[q];
+    while (q != 0 && quad_getOpcode(q) == nop_op) {
+        q = l->prev[q];
+    }
+    return q;
+}
+
+// whether running on past q reaches the quad after it, the start of the program falling into the first
\ No newline at end of file
@@ -0,0 +1,15 @@
+#ifndef JUMPS_H
+#define JUMPS_H
+
+/*
+ * Jump optimization and block layout. Jumps to jumps go straight to the
+ * final target, a test for equality over a jump is inverted to branch
+ * where the jump went, and a run of quads a jump leads to is moved right
+ * after that jump when this saves running it, so that loop bodies fall
+ * through into their step and test and a loop branches back only once
+ * per iteration. Moving quads renumbers them, so this runs last.
+ */
+void
+jumps_run();
+
+#endif
@@ -0,0 +1,590 @@
+#include "licm.h"
+#include "opt.h"
+#include "liveness.h"
+#include "../cfg/cfg.h"
+#include "../scope_space/scope_space.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <string.h>
+
+// a variable the loop writes more often than this is as good as written twice
+#define LICM_MANY_DEFINITIONS   2
+
+// the new quads that go in front of a loop header
+typedef struct LicmInsertion {
+    unsigned at;
+    unsigned* quads;
+    unsigned total;
+    unsigned size;
+} LicmInsertion;
+
+// a label that can only be set once the quads are renumbered, to the first quad of an insertion
+typedef struct LicmPatch {
+    unsigned quad;
+    unsigned insertion;
+    unsigned quadOfInsertion;   // or the insertion's start, CFG_NONE
+} LicmPatch;
+
+typedef struct LicmPlan {
+    unsigned totalQuads;        // before any were added
+    unsigned* insertionAt;      // by quad, the insertion in front of it or CFG_NONE
+    LicmInsertion* insertions;
+    unsigned totalInsertions;
+    LicmPatch* patches;
+    unsigned totalPatches;
+} LicmPlan;
+
+typedef struct LicmLoop {
+    unsigned loop;
+    unsigned header;
+    OptVariables* vars;
+
+    unsigned* blocks;
+    unsigned totalBlocks;
+    unsigned* mustRun;          // the latches and exits other than the header, which moved quads must dominate
+    unsigned totalMustRun;
+
+    unsigned char* definitions; // by variable, how many quads of the loop write it
+    unsigned char* hoisted;     // by variable, written by a quad already chosen to move
+    unsigned char runsCode;
+    Expr** storedKeys;          // the keys of the table writes in the loop
+    unsigned totalStores;
+} LicmLoop;
+
+/* ------------------------------------------ Static Declarations ------------------------------------------ */
+static void
+hoist_function(LicmPlan* plan, unsigned f);
+
+static void
+hoist_loop(LicmPlan* plan, unsigned l, OptVariables* vars, Liveness* lv);
+
+static unsigned
+find_preheader(unsigned l);
+
+static unsigned char
+is_guardable(unsigned l);
+
+static void
+analyze_loop(LicmLoop* loop);
+
+static unsigned char
+dominates_must_run(LicmLoop* loop, unsigned b);
+
+static unsigned char
+is_hoistable(LicmLoop* loop, unsigned i, LiveSet* liveIn);
+
+static unsigned char
+is_invariant(LicmLoop* loop, Expr* e);
+
+static unsigned char
+may_stop(unsigned i);
+
+static unsigned char
+may_store_key(LicmLoop* loop, Expr* key);
+
+static unsigned
+new_insertion(LicmPlan* plan, unsigned at);
+
+static unsigned
+insert_quad(LicmPlan* plan, unsigned insertion, IOPCodeType op, Expr* arg1, Expr* arg2, Expr* result, unsigned label, unsigned line);
+
+static void
+add_patch(LicmPlan* plan, unsigned quad, unsigned insertion, unsigned quadOfInsertion);
+
+static void
+apply_plan(LicmPlan* plan);
+
+/* ------------------------------------------ Implementation ------------------------------------------ */
+unsigned
+licm_run() {
+    LicmPlan plan;
+    unsigned moved;
+
+    memset(&plan, 0, sizeof(plan));
+    plan.totalQuads = quad_totalQuads();
+    plan.insertionAt = opt_allocate(sizeof(unsigned) * plan.totalQuads);
+    memset(plan.insertionAt, 0xff, sizeof(unsigned) * plan.totalQuads);
+
+    for (unsigned f = 0; f < cfg_totalFunctions(); f++) {
+        hoist_function(&plan, f);
+    }
+
+    if (plan.totalInsertions) {
+        apply_plan(&plan);
+    }
+    moved = plan.totalInsertions;
+
+    for (unsigned i = 0; i < plan.totalInsertions; i++) {
+        free(plan.insertions[i].quads);
+    }
+    free(plan.insertions);
+    free(plan.patches);
+    free(plan.insertionAt);
+    return moved;
+}
+
+/* ------------------------------------------ Static Definitions ------------------------------------------ */
+static void
+hoist_function(LicmPlan* plan, unsigned f) {
+    unsigned char hasLoops = 0;
+
+    for (unsigned l = 0; l < cfg_totalLoops(); l++) {
+        hasLoops |= cfg_getBlockFunction(cfg_getLoopHeader(l)) == f;
+    }
+    if (!hasLoops) {
+        return;
+    }
+
+    OptVariables* vars = opt_newVariables(f);
+    Liveness* lv = liveness_build(f, vars);
+
+    if (lv) {
+        for (unsigned l = 0; l < cfg_totalLoops(); l++) {
+            if (cfg_getBlockFunction(cfg_getLoopHeader(l)) == f) {
+                hoist_loop(plan, l, vars, lv);
+            }
+        }
+    }
+
+    liveness_destroy(lv);
+    opt_freeVariables(vars);
+}
+
+/*
+ * The quads whose innermost loop is l and that can run in front of it go,
+ * in the order the blocks run, into an insertion in front of the header,
+ * after a copy of the header's test when the header may leave the loop.
+ * Their original places become nops, as jumps may lead there. A quad that
+ * may stop the program only goes when nothing before it in the loop may
+ * stop it or be seen, so that it fails where the loop would have.
+ */
+static void
+hoist_loop(LicmPlan* plan, unsigned l, OptVariables* vars, Liveness* lv) {
+    unsigned header = cfg_getLoopHeader(l);
+    unsigned f = cfg_getBlockFunction(header);
+    unsigned preheader = find_preheader(l);
+
+    if (preheader == CFG_NONE) {
+        return;
+    }
+
+    LicmLoop loop;
+    memset(&loop, 0, sizeof(loop));
+    loop.loop = l;
+    loop.header = header;
+    loop.vars = vars;
+
+    analyze_loop(&loop);
+
+    unsigned char guarded = 0;
+    for (unsigned s = 0; s < cfg_totalSuccessors(header); s++) {
+        guarded |= !cfg_isInLoop(cfg_getSuccessor(header, s), l);
+    }
+
+    unsigned* chosen = NULL;
+    unsigned totalChosen = 0;
+
+    if (!guarded || is_guardable(l)) {
+        LiveSet* liveIn = liveness_newSet(lv);
+
+        liveness_getOut(lv, header, liveIn);
+        for (unsigned i = cfg_getLastQuad(header) + 1; i-- > cfg_getFirstQuad(header);) {
+            liveness_stepBack(lv, quad_getAt(i), liveIn);
+        }
+
+        chosen = opt_allocate(sizeof(unsigned) * quad_totalQuads());
+
+        // set once a quad staying in the loop may stop the program or calls, or an inner loop may not end
+        unsigned char effects = 0;
+
+        for (unsigned r = 0; r < cfg_getFunctionTotalReachable(f); r++) {
+            unsigned b = cfg_getFunctionRpoBlock(f, r);
+
+            if (!cfg_isInLoop(b, l)) {
+                continue;
+            }
+            if (cfg_getBlockLoop(b) != l) {
+                effects = 1;
+                continue;
+            }
+
+            unsigned char movable = b != header && dominates_must_run(&loop, b);
+            for (unsigned i = cfg_getFirstQuad(b); i <= cfg_getLastQuad(b); i++) {
+                // the header's test is run again in front of the moved quads
+                if (b == header && guarded && i == cfg_getLastQuad(b)) {
+                    continue;
+                }
+                if (movable && is_hoistable(&loop, i, liveIn) && !(effects && may_stop(i))) {
+                    loop.hoisted[opt_getVariable(vars, quad_getResult(quad_getAt(i)))] = 1;
+                    chosen[totalChosen++] = i;
+                }
+                else if (may_stop(i) || quad_getOpcode(i) == call_op) {
+                    effects = 1;
+                }
+            }
+        }
+
+        free(liveIn);
+    }
+
+    if (totalChosen) {
+        unsigned first = cfg_getFirstQuad(header);
+        unsigned last = cfg_getLastQuad(header);
+        unsigned insertion = new_insertion(plan, first);
+        unsigned guard = CFG_NONE;
+        unsigned target = quad_getLabel(quad_getAt(last));
+        unsigned char targetInLoop = guarded && target < plan->totalQuads && cfg_isInLoop(cfg_getBlockOfQuad(target), l);
+        unsigned line = quad_getLine(quad_getAt(last));
+
+        // the test again, leaving for where the header would when it fails
+        if (guarded) {
+            Quad* test = quad_getAt(last);
+
+            guard = insert_quad(plan, insertion, quad_getOpcode(last), quad_getArg1(test), quad_getArg2(test), NULL, target, line);
+            if (targetInLoop) {
+                insert_quad(plan, insertion, jump_op, NULL, NULL, NULL, last + 1, line);
+            }
+        }
+
+        for (unsigned c = 0; c < totalChosen; c++) {
+            Quad* q = quad_getAt(chosen[c]);
+            unsigned index = insert_quad(plan, insertion, quad_getOpcode(chosen[c]), quad_getArg1(q), quad_getArg2(q), quad_getResult(q), 0, quad_getLine(q));
+
+            if (c == 0 && guard != CFG_NONE && targetInLoop) {
+                add_patch(plan, guard, insertion, index);
+            }
+            opt_removeQuad(chosen[c]);
+        }
+
+        // and on into the loop past the header, whose test just held
+        if (guarded) {
+            insert_quad(plan, insertion, jump_op, NULL, NULL, NULL, targetInLoop ? target : last + 1, line);
+        }
+
+        unsigned enter = cfg_getLastQuad(preheader);
+        if (opt_isBranch(quad_getOpcode(enter)) && quad_getLabel(quad_getAt(enter)) == first) {
+            add_patch(plan, enter, insertion, CFG_NONE);
+        }
+    }
+
+    free(chosen);
+    free(loop.blocks);
+    free(loop.mustRun);
+    free(loop.definitions);
+    free(loop.hoisted);
+    free(loop.storedKeys);
+}
+
+/*
+ * The one block outside the loop that leads into its header, either by
+ * branching to it or by falling into it, and nothing else falling into the
+ * header where the insertion goes. CFG_NONE if there is no such block.
+ */
+static unsigned
+find_preheader(unsigned l) {
+    unsigned header = cfg_getLoopHeader(l);
+    unsigned first = cfg_getFirstQuad(header);
+    unsigned preheader = CFG_NONE;
+
+    for (unsigned p = 0; p < cfg_totalPredecessors(header); p++) {
+        unsigned pred = cfg_getPredecessor(header, p);
+
+        if (cfg_isInLoop(pred, l)) {
+            continue;
+        }
+        if (preheader != CFG_NONE) {
+            return CFG_NONE;
+        }
+        preheader = pred;
+    }
+
+    if (preheader == CFG_NONE) {
+        return CFG_NONE;
+    }
+
+    unsigned enter = cfg_getLastQuad(preheader);
+    unsigned char branches = opt_isBranch(quad_getOpcode(enter)) && quad_getLabel(quad_getAt(enter)) == first;
+    unsigned char fallsInto = opt_fallsThrough(enter) && enter + 1 == first;
+
+    if (!branches && !fallsInto) {
+        return CFG_NONE;
+    }
+    if (first > 1 && cfg_getBlockOfQuad(first - 1) != preheader && opt_fallsThrough(first - 1)) {
+        return CFG_NONE;
+    }
+
+    return preheader;
+}
+
+// a header that only tests, going on into the loop one way and out of it the other
+static unsigned char
+is_guardable(unsigned l) {
+    unsigned header = cfg_getLoopHeader(l);
+    unsigned last = cfg_getLastQuad(header);
+
+    for (unsigned i = cfg_getFirstQuad(header); i < last; i++) {
+        if (quad_getOpcode(i) != nop_op) {
+            return 0;
+        }
+    }
+
+    return opt_isConditional(quad_getOpcode(last)) && cfg_totalSuccessors(header) == 2 &&
+        cfg_isInLoop(cfg_getSuccessor(header, 0), l) != cfg_isInLoop(cfg_getSuccessor(header, 1), l);
+}
+
+static void
+analyze_loop(LicmLoop* loop) {
+    unsigned f = cfg_getBlockFunction(loop->header);
+    unsigned first = cfg_getFunctionFirstBlock(f);
+    unsigned last = first + cfg_getFunctionTotalBlocks(f);
+    unsigned totalVars = opt_totalVariables(loop->vars);
+
+    loop->blocks = opt_allocate(sizeof(unsigned) * (last - first));
+    loop->mustRun = opt_allocate(sizeof(unsigned) * (last - first));
+    loop->definitions = opt_allocate(totalVars);
+    loop->hoisted = opt_allocate(totalVars);
+    loop->storedKeys = opt_allocate(sizeof(Expr*) * quad_totalQuads());
+
+    memset(loop->definitions, 0, totalVars);
+    memset(loop->hoisted, 0, totalVars);
+
+    for (unsigned b = first; b < last; b++) {
+        if (!cfg_isReachable(b) || !cfg_isInLoop(b, loop->loop)) {
+            continue;
+        }
+        loop->blocks[loop->totalBlocks++] = b;
+
+        unsigned char mustRun = 0;
+        for (unsigned s = 0; s < cfg_totalSuccessors(b); s++) {
+            unsigned succ = cfg_getSuccessor(b, s);
+            mustRun |= succ == loop->header || (!cfg_isInLoop(succ, loop->loop) && b != loop->header);
+        }
+        if (mustRun) {
+            loop->mustRun[loop->totalMustRun++] = b;
+        }
+
+        for (unsigned i = cfg_getFirstQuad(b); i <= cfg_getLastQuad(b); i++) {
+            Quad* q = quad_getAt(i);
+            unsigned definition = opt_getDefinition(q);
+            unsigned v = definition ? opt_getVariable(loop->vars, opt_getOperand(q, definition)) : CFG_NONE;
+
+            if (v != CFG_NONE && loop->definitions[v] < LICM_MANY_DEFINITIONS) {
+                loop->definitions[v]++;
+            }
+            if (quad_getOpcode(i) == call_op && opt_callRunsCode(q)) {
+                loop->runsCode = 1;
+            }
+            if (quad_getOpcode(i) == tablesetelem_op) {
+                loop->storedKeys[loop->totalStores++] = quad_getArg2(q);
+            }
+        }
+    }
+}
+
+static unsigned char
+dominates_must_run(LicmLoop* loop, unsigned b) {
+    for (unsigned m = 0; m < loop->totalMustRun; m++) {
+        if (!cfg_dominates(b, loop->mustRun[m])) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static unsigned char
+is_hoistable(LicmLoop* loop, unsigned i, LiveSet* liveIn) {
+    Quad* q = quad_getAt(i);
+
+    switch (quad_getOpcode(i)) {
+        case add_op:
+        case sub_op:
+        case mul_op:
+        case div_op:
+        case mod_op:
+        case uminus_op:
+            break;
+        case tablegetelem_op:
+            // a table may be reached through any variable, so only its key tells writes apart
+            if (loop->runsCode || may_store_key(loop, quad_getArg2(q))) {
+                return 0;
+            }
+            break;
+        default:
+            return 0;
+    }
+
+    unsigned v = opt_getVariable(loop->vars, quad_getResult(q));
+    if (v == CFG_NONE || loop->definitions[v] != 1 || liveness_contains(liveIn, v)) {
+        return 0;
+    }
+
+    unsigned uses = opt_getUses(q);
+    for (unsigned operand = OPT_ARG1; operand <= OPT_ARG2; operand <<= 1) {
+        if ((uses & operand) && !is_invariant(loop, opt_getOperand(q, operand))) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static unsigned char
+is_invariant(LicmLoop* loop, Expr* e) {
+    if (opt_isConstant(e)) {
+        return 1;
+    }
+
+    unsigned v = opt_getVariable(loop->vars, e);
+    if (v == CFG_NONE) {
+        return 0;
+    }
+    if (loop->definitions[v] == 0) {
+        return !loop->runsCode || !opt_isVisibleToCalls(opt_getVariableEntry(loop->vars, v));
+    }
+    return loop->hoisted[v];
+}
+
+// whether the program may stop at it, as arithmetic does on anything but numbers and a comparison on undef
+static unsigned char
+may_stop(unsigned i) {
+    Quad* q = quad_getAt(i);
+
+    switch (quad_getOpcode(i)) {
+        case add_op:
+        case sub_op:
+        case mul_op:
+        case div_op:
+        case mod_op:
+        case uminus_op: {
+            unsigned uses = opt_getUses(q);
+            for (unsigned operand = OPT_ARG1; operand <= OPT_ARG2; operand <<= 1) {
+                if ((uses & operand) && icode_getExprType(opt_getOperand(q, operand)) != constnum_e) {
+                    return 1;
+                }
+            }
+            return 0;
+        }
+        case tablegetelem_op:
+        case tablesetelem_op:
+            return 1;
+        default:
+            return opt_isConditional(quad_getOpcode(i));
+    }
+}
+
+static unsigned char
+may_store_key(LicmLoop* loop, Expr* key) {
+    for (unsigned s = 0; s < loop->totalStores; s++) {
+        Expr* stored = loop->storedKeys[s];
+        ExprType type = icode_getExprType(key);
+
+        if (!opt_isConstant(key) || !opt_isConstant(stored) || icode_getExprType(stored) != type) {
+            return 1;
+        }
+        if (type == constnum_e && icode_getNumConst(key) == icode_getNumConst(stored)) {
+            return 1;
+        }
+        if (type == conststring_e && strcmp(icode_getStringConst(key), icode_getStringConst(stored)) == 0) {
+            return 1;
+        }
+        if (type != constnum_e && type != conststring_e) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static unsigned
+new_insertion(LicmPlan* plan, unsigned at) {
+    plan->insertions = realloc(plan->insertions, sizeof(LicmInsertion) * (plan->totalInsertions + 1));
+    if (!plan->insertions) {
+        printf("Error allocating memory for loop-invariant code motion.\n");
+        exit(1);
+    }
+
+    LicmInsertion* insertion = &plan->insertions[plan->totalInsertions];
+    memset(insertion, 0, sizeof(LicmInsertion));
+    insertion->at = at;
+
+    assert(plan->insertionAt[at] == CFG_NONE);
+    plan->insertionAt[at] = plan->totalInsertions;
+    return plan->totalInsertions++;
+}
+
+static unsigned
+insert_quad(LicmPlan* plan, unsigned insertion, IOPCodeType op, Expr* arg1, Expr* arg2, Expr* result, unsigned label, unsigned line) {
+    LicmInsertion* ins = &plan->insertions[insertion];
+    unsigned index = quad_nextQuadLabel();
+
+    if (ins->total == ins->size) {
+        ins->size = ins->size ? ins->size * 2 : 8;
+        ins->quads = realloc(ins->quads, sizeof(unsigned) * ins->size);
+        if (!ins->quads) {
+            printf("Error allocating memory for loop-invariant code motion.\n");
+            exit(1);
+        }
+    }
+
+    quad_emit(op, arg1, arg2, result, label, line);
+    ins->quads[ins->total++] = index;
+    return index;
+}
+
+static void
+add_patch(LicmPlan* plan, unsigned quad, unsigned insertion, unsigned quadOfInsertion) {
+    plan->patches = realloc(plan->patches, sizeof(LicmPatch) * (plan->totalPatches + 1));
+    if (!plan->patches) {
+        printf("Error allocating memory for loop-invariant code motion.\n");
+        exit(1);
+    }
+
+    plan->patches[plan->totalPatches].quad = quad;
+    plan->patches[plan->totalPatches].insertion = insertion;
+    plan->patches[plan->totalPatches].quadOfInsertion = quadOfInsertion;
+    plan->totalPatches++;
+}
+
+/*
+ * The new quads were emitted after the last one, where the end of the
+ * program was, so the labels meaning the end move past them first. Then
+ * every insertion takes its place in front of its header.
+ */
+static void
+apply_plan(LicmPlan* plan) {
+    unsigned total = quad_totalQuads();
+
+    for (unsigned i = 1; i < total; i++) {
+        if (opt_isBranch(quad_getOpcode(i)) && quad_getLabel(quad_getAt(i)) == plan->totalQuads) {
+            quad_patchLabel(i, total);
+        }
+    }
+
+    for (unsigned p = 0; p < plan->totalPatches; p++) {
+        LicmPatch* patch = &plan->patches[p];
+        unsigned label = patch->quadOfInsertion;
+
+        if (label == CFG_NONE) {
+            label = plan->insertions[patch->insertion].quads[0];
+        }
+        quad_patchLabel(patch->quad, label);
+    }
+
+    unsigned* order = opt_allocate(sizeof(unsigned) * total);
+    unsigned n = 0;
+
+    order[n++] = 0;
+    for (unsigned i = 1; i < plan->totalQuads; i++) {
+        if (plan->insertionAt[i] != CFG_NONE) {
+            LicmInsertion* insertion = &plan->insertions[plan->insertionAt[i]];
+            for (unsigned k = 0; k < insertion->total; k++) {
+                order[n++] = insertion->quads[k];
+            }
+        }
+        order[n++] = i;
+    }
+    assert(n == total);
+
+    quad_reorder(order);
+    free(order);
+}
@@ -0,0 +1,22 @@
+#ifndef LICM_H
+#define LICM_H
+
+/*
+ * Loop-invariant code motion. Arithmetic whose operands no quad of the
+ * loop writes, and table reads whose table and key are invariant and that
+ * no table write or code-running call in the loop can change, are moved in
+ * front of the loop and run once. A quad is only moved when every iteration
+ * that completes runs it, and its result is written nowhere else in the
+ * loop and not read before it. One that may stop the program only moves
+ * when nothing in the loop before it calls, may stop the program or may
+ * not end, so that it still fails first. A loop that may run no iteration
+ * gets its test repeated in front of the moved quads, so they only run
+ * when it is entered. The quads are renumbered to make room, so the
+ * control flow graph must be built again after it. Returns how many loops
+ * had quads moved in front of them, which may then be invariant in an
+ * outer loop.
+ */
+unsigned
+licm_run();
+
+#endif
@@ -0,0 +1,188 @@
+#include "liveness.h"
+#include "../cfg/cfg.h"
+#include "../scope_space/scope_space.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <string.h>
+
+// functions with more blocks times words of variables than this are not analyzed
+#define LIVENESS_MAX_WORDS  (1u << 20)
+
+#define WORD_BITS   (sizeof(LiveSet) * 8)
+
+typedef struct Liveness {
+    unsigned function;
+    unsigned firstBlock;
+    unsigned totalBlocks;
+    OptVariables* vars;
+    unsigned words;
+
+    LiveSet* visible;
+    LiveSet* formals;
+
+    LiveSet* liveIn;    // by block
+    LiveSet* liveOut;
+} Liveness;
+
+/* ------------------------------------------ Static Declarations ------------------------------------------ */
+static void
+solve(Liveness* lv);
+
+static LiveSet*
+new_set(unsigned words);
+
+/* ------------------------------------------ Implementation ------------------------------------------ */
+Liveness*
+liveness_build(unsigned f, OptVariables* vars) {
+    unsigned totalVars = opt_totalVariables(vars);
+    unsigned words = (totalVars + WORD_BITS - 1) / WORD_BITS;
+    unsigned totalBlocks = cfg_getFunctionTotalBlocks(f);
+
+    if (words && totalBlocks > LIVENESS_MAX_WORDS / words) {
+        return NULL;
+    }
+
+    Liveness* lv = malloc(sizeof(Liveness));
+    if (!lv) {
+        printf("Error allocating memory for liveness.\n");
+        exit(1);
+    }
+
+    lv->function = f;
+    lv->firstBlock = cfg_getFunctionFirstBlock(f);
+    lv->totalBlocks = totalBlocks;
+    lv->vars = vars;
+    lv->words = words;
+    lv->visible = new_set(words);
+    lv->formals = new_set(words);
+    lv->liveIn = new_set(totalBlocks * words);
+    lv->liveOut = new_set(totalBlocks * words);
+
+    for (unsigned v = 0; v < totalVars; v++) {
+        SymbolTableEntry* entry = opt_getVariableEntry(vars, v);
+
+        if (opt_isVisibleToCalls(entry)) {
+            lv->visible[v / WORD_BITS] |= (LiveSet) 1 << (v % WORD_BITS);
+        }
+        if (symtab_getVariableSpace(entry) == FORMALARG) {
+            lv->formals[v / WORD_BITS] |= (LiveSet) 1 << (v % WORD_BITS);
+        }
+    }
+
+    solve(lv);
+    return lv;
+}
+
+void
+liveness_destroy(Liveness* lv) {
+    if (!lv) {
+        return;
+    }
+    free(lv->visible);
+    free(lv->formals);
+    free(lv->liveIn);
+    free(lv->liveOut);
+    free(lv);
+}
+
+LiveSet*
+liveness_newSet(Liveness* lv) {
+    return new_set(lv->words);
+}
+
+void
+liveness_getOut(Liveness* lv, unsigned b, LiveSet* set) {
+    assert(b >= lv->firstBlock && b < lv->firstBlock + lv->totalBlocks);
+    memcpy(set, lv->liveOut + (size_t) (b - lv->firstBlock) * lv->words, sizeof(LiveSet) * lv->words);
+}
+
+void
+liveness_stepBack(Liveness* lv, Quad* q, LiveSet* set) {
+    unsigned definition = opt_getDefinition(q);
+    unsigned uses = opt_getUses(q);
+
+    if (definition) {
+        unsigned v = opt_getVariable(lv->vars, opt_getOperand(q, definition));
+        if (v != CFG_NONE) {
+            set[v / WORD_BITS] &= ~((LiveSet) 1 << (v % WORD_BITS));
+        }
+    }
+
+    for (unsigned operand = OPT_ARG1; operand <= OPT_RESULT; operand <<= 1) {
+        if (uses & operand) {
+            unsigned v = opt_getVariable(lv->vars, opt_getOperand(q, operand));
+            if (v != CFG_NONE) {
+                set[v / WORD_BITS] |= (LiveSet) 1 << (v % WORD_BITS);
+            }
+        }
+    }
+
+    if (quad_getOpcode(quad_getIndex(q)) == call_op) {
+        unsigned char runsCode = opt_callRunsCode(q);
+
+        for (unsigned w = 0; w < lv->words; w++) {
+            set[w] |= lv->formals[w] | (runsCode ? lv->visible[w] : 0);
+        }
+    }
+}
+
+unsigned char
+liveness_contains(LiveSet* set, unsigned v) {
+    return v != CFG_NONE && (set[v / WORD_BITS] & ((LiveSet) 1 << (v % WORD_BITS))) != 0;
+}
+
+/* ------------------------------------------ Static Definitions ------------------------------------------ */
+// backwards over the reachable blocks until the sets stop growing
+static void
+solve(Liveness* lv) {
+    unsigned char changed;
+    unsigned totalReachable = cfg_getFunctionTotalReachable(lv->function);
+    LiveSet* live = new_set(lv->words);
+
+    do {
+        changed = 0;
+
+        for (unsigned r = totalReachable; r-- > 0;) {
+            unsigned b = cfg_getFunctionRpoBlock(lv->function, r);
+            LiveSet* in = lv->liveIn + (size_t) (b - lv->firstBlock) * lv->words;
+            LiveSet* out = lv->liveOut + (size_t) (b - lv->firstBlock) * lv->words;
+
+            if (!cfg_totalSuccessors(b)) {
+                memcpy(out, lv->visible, sizeof(LiveSet) * lv->words);
+            }
+            for (unsigned s = 0; s < cfg_totalSuccessors(b); s++) {
+                LiveSet* succIn = lv->liveIn + (size_t) (cfg_getSuccessor(b, s) - lv->firstBlock) * lv->words;
+                for (unsigned w = 0; w < lv->words; w++) {
+                    out[w] |= succIn[w];
+                }
+            }
+
+            memcpy(live, out, sizeof(LiveSet) * lv->words);
+            for (unsigned i = cfg_getLastQuad(b) + 1; i-- > cfg_getFirstQuad(b);) {
+                liveness_stepBack(lv, quad_getAt(i), live);
+            }
+
+            for (unsigned w = 0; w < lv->words; w++) {
+                if (live[w] & ~in[w]) {
+                    in[w] |= live[w];
+                    changed = 1;
+                }
+            }
+        }
+    } while (changed);
+
+    free(live);
+}
+
+static LiveSet*
+new_set(unsigned words) {
+    LiveSet* set = calloc(words ? words : 1, sizeof(LiveSet));
+
+    if (!set) {
+        printf("Error allocating memory for liveness.\n");
+        exit(1);
+    }
+    return set;
+}
@@ -0,0 +1,36 @@
+#ifndef LIVENESS_H
+#define LIVENESS_H
+
+#include "opt.h"
+
+/*
+ * The variables of a function live leaving each of its reachable blocks,
+ * as sets of the numbers OptVariables gives them. Globals are live when
+ * the function exits and at calls that may run user code, and formal
+ * arguments at every call, since argument() reads them.
+ */
+typedef struct Liveness Liveness;
+
+typedef unsigned long LiveSet;
+
+// NULL for functions too large to analyze
+Liveness*
+liveness_build(unsigned f, OptVariables* vars);
+
+void
+liveness_destroy(Liveness* lv);
+
+LiveSet*
+liveness_newSet(Liveness* lv);
+
+void
+liveness_getOut(Liveness* lv, unsigned b, LiveSet* set);
+
+// from what is live after a quad to what is live before it
+void
+liveness_stepBack(Liveness* lv, Quad* q, LiveSet* set);
+
+unsigned char
+liveness_contains(LiveSet* set, unsigned v);
+
+#endif
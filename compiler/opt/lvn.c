@@ -0,0 +1,344 @@
+#include "lvn.h"
+#include "opt.h"
+#include "../cfg/cfg.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <string.h>
+#include <math.h>
+
+// a block remembers at most this many expressions and constants, the rest get values of their own
+#define LVN_MAX_EXPRESSIONS 512
+#define LVN_MAX_CONSTANTS   512
+
+// the value of no operand, for the second of a unary operator
+#define LVN_NO_VALUE        0
+
+typedef struct LvnExpression {
+    IOPCodeType op;
+    unsigned value1;
+    unsigned value2;
+    Expr* constantKey;          // the key of a table read when it is a constant
+    unsigned value;
+    unsigned holder;            // the variable it was computed into
+    Expr* holderExpr;
+} LvnExpression;
+
+typedef struct LvnFunction {
+    OptVariables* vars;
+    unsigned totalVars;
+    unsigned* visible;
+    unsigned totalVisible;
+
+    unsigned block;             // numbers the blocks, so that values of the last one are not taken for these
+    unsigned* valueOf;          // by variable, the value it holds
+    unsigned* blockOf;          // by variable, the block valueOf was set in
+    unsigned nextValue;
+
+    Expr* constants[LVN_MAX_CONSTANTS];
+    unsigned constantValues[LVN_MAX_CONSTANTS];
+    unsigned totalConstants;
+
+    LvnExpression expressions[LVN_MAX_EXPRESSIONS];
+    unsigned totalExpressions;
+} LvnFunction;
+
+/* ------------------------------------------ Static Declarations ------------------------------------------ */
+static void
+number_function(unsigned f);
+
+static void
+number_block(LvnFunction* lf, unsigned b);
+
+static void
+number_expression(LvnFunction* lf, unsigned i);
+
+static void
+forget_table_reads(LvnFunction* lf, Expr* key);
+
+static void
+forget_visible(LvnFunction* lf);
+
+static unsigned
+value_of(LvnFunction* lf, Expr* e, unsigned char* isConstant);
+
+static void
+set_value(LvnFunction* lf, Expr* e, unsigned value);
+
+static unsigned char
+is_held(LvnFunction* lf, LvnExpression* expression);
+
+static unsigned char
+same_constant(Expr* c1, Expr* c2);
+
+static unsigned char
+same_key(Expr* c1, Expr* c2);
+
+/* ------------------------------------------ Implementation ------------------------------------------ */
+void
+lvn_run() {
+    for (unsigned f = 0; f < cfg_totalFunctions(); f++) {
+        number_function(f);
+    }
+}
+
+/* ------------------------------------------ Static Definitions ------------------------------------------ */
+static void
+number_function(unsigned f) {
+    LvnFunction* lf = opt_allocate(sizeof(LvnFunction));
+
+    lf->vars = opt_newVariables(f);
+    lf->totalVars = opt_totalVariables(lf->vars);
+    lf->visible = opt_allocate(sizeof(unsigned) * lf->totalVars);
+    lf->totalVisible = 0;
+    lf->block = 0;
+    lf->valueOf = opt_allocate(sizeof(unsigned) * lf->totalVars);
+    lf->blockOf = opt_allocate(sizeof(unsigned) * lf->totalVars);
+    lf->nextValue = LVN_NO_VALUE + 1;
+
+    memset(lf->blockOf, 0, sizeof(unsigned) * lf->totalVars);
+
+    for (unsigned v = 0; v < lf->totalVars; v++) {
+        if (opt_isVisibleToCalls(opt_getVariableEntry(lf->vars, v))) {
+            lf->visible[lf->totalVisible++] = v;
+        }
+    }
+
+    unsigned first = cfg_getFunctionFirstBlock(f);
+    for (unsigned b = first; b < first + cfg_getFunctionTotalBlocks(f); b++) {
+        if (cfg_isReachable(b)) {
+            number_block(lf, b);
+        }
+    }
+
+    free(lf->visible);
+    free(lf->valueOf);
+    free(lf->blockOf);
+    opt_freeVariables(lf->vars);
+    free(lf);
+}
+
+static void
+number_block(LvnFunction* lf, unsigned b) {
+    lf->block++;
+    lf->totalConstants = 0;
+    lf->totalExpressions = 0;
+
+    for (unsigned i = cfg_getFirstQuad(b); i <= cfg_getLastQuad(b); i++) {
+        Quad* q = quad_getAt(i);
+
+        switch (quad_getOpcode(i)) {
+            case add_op:
+            case sub_op:
+            case mul_op:
+            case div_op:
+            case mod_op:
+            case uminus_op:
+            case tablegetelem_op:
+                number_expression(lf, i);
+                break;
+            case assign_op:
+                set_value(lf, quad_getResult(q), value_of(lf, quad_getArg1(q), NULL));
+                break;
+            case tablesetelem_op:
+                forget_table_reads(lf, quad_getArg2(q));
+                break;
+            case call_op:
+                if (opt_callRunsCode(q)) {
+                    forget_table_reads(lf, NULL);
+                    forget_visible(lf);
+                }
+                break;
+            default: {
+                unsigned definition = opt_getDefinition(q);
+                if (definition) {
+                    set_value(lf, opt_getOperand(q, definition), lf->nextValue++);
+                }
+                break;
+            }
+        }
+    }
+}
+
+/*
+ * A quad computing what a variable of the block still holds becomes an
+ * assign from it, and is removed if it is that variable. Otherwise its
+ * result holds a new value, which it is remembered to hold.
+ */
+static void
+number_expression(LvnFunction* lf, unsigned i) {
+    Quad* q = quad_getAt(i);
+    IOPCodeType op = quad_getOpcode(i);
+    unsigned char isConstant = 0;
+    unsigned value1 = value_of(lf, quad_getArg1(q), NULL);
+    unsigned value2 = op == uminus_op ? LVN_NO_VALUE : value_of(lf, quad_getArg2(q), &isConstant);
+    Expr* result = quad_getResult(q);
+    unsigned v = opt_getVariable(lf->vars, result);
+
+    if (v == CFG_NONE) {
+        return;
+    }
+
+    for (unsigned e = 0; e < lf->totalExpressions; e++) {
+        LvnExpression* expression = &lf->expressions[e];
+
+        if (expression->op != op || expression->value1 != value1 || expression->value2 != value2 || !is_held(lf, expression)) {
+            continue;
+        }
+
+        if (expression->holder == v) {
+            opt_removeQuad(i);
+        }
+        else {
+            quad_setOpcode(q, assign_op);
+            quad_setArg1(q, expression->holderExpr);
+            quad_setArg2(q, NULL);
+            set_value(lf, result, expression->value);
+        }
+        return;
+    }
+
+    unsigned value = lf->nextValue++;
+    set_value(lf, result, value);
+
+    if (lf->totalExpressions < LVN_MAX_EXPRESSIONS) {
+        LvnExpression* expression = &lf->expressions[lf->totalExpressions++];
+
+        expression->op = op;
+        expression->value1 = value1;
+        expression->value2 = value2;
+        expression->constantKey = op == tablegetelem_op && isConstant ? quad_getArg2(q) : NULL;
+        expression->value = value;
+        expression->holder = v;
+        expression->holderExpr = result;
+    }
+}
+
+/*
+ * The table reads a write to key may change, all of them for NULL. Any two
+ * tables may be the same one, so only a constant key different from the
+ * constant a read used leaves the read alone.
+ */
+static void
+forget_table_reads(LvnFunction* lf, Expr* key) {
+    Expr* constantKey = key && opt_isConstant(key) ? key : NULL;
+    unsigned kept = 0;
+
+    for (unsigned e = 0; e < lf->totalExpressions; e++) {
+        LvnExpression* expression = &lf->expressions[e];
+        unsigned char differentKey = constantKey && expression->constantKey && !same_key(constantKey, expression->constantKey);
+
+        if (expression->op != tablegetelem_op || differentKey) {
+            lf->expressions[kept++] = *expression;
+        }
+    }
+    lf->totalExpressions = kept;
+}
+
+// a called function may have written any global, which then holds a value of its own
+static void
+forget_visible(LvnFunction* lf) {
+    for (unsigned i = 0; i < lf->totalVisible; i++) {
+        lf->blockOf[lf->visible[i]] = 0;
+    }
+}
+
+/*
+ * The value an operand holds. Equal constants hold the same value, and a
+ * variable not written yet in the block one of its own.
+ */
+static unsigned
+value_of(LvnFunction* lf, Expr* e, unsigned char* isConstant) {
+    if (isConstant) {
+        *isConstant = 0;
+    }
+
+    if (opt_isConstant(e)) {
+        for (unsigned c = 0; c < lf->totalConstants; c++) {
+            if (same_constant(lf->constants[c], e)) {
+                if (isConstant) {
+                    *isConstant = 1;
+                }
+                return lf->constantValues[c];
+            }
+        }
+        if (lf->totalConstants == LVN_MAX_CONSTANTS) {
+            return lf->nextValue++;
+        }
+
+        lf->constants[lf->totalConstants] = e;
+        lf->constantValues[lf->totalConstants] = lf->nextValue;
+        lf->totalConstants++;
+
+        if (isConstant) {
+            *isConstant = 1;
+        }
+        return lf->nextValue++;
+    }
+
+    unsigned v = opt_getVariable(lf->vars, e);
+    if (v == CFG_NONE) {
+        return lf->nextValue++;
+    }
+    if (lf->blockOf[v] != lf->block) {
+        lf->blockOf[v] = lf->block;
+        lf->valueOf[v] = lf->nextValue++;
+    }
+    return lf->valueOf[v];
+}
+
+static void
+set_value(LvnFunction* lf, Expr* e, unsigned value) {
+    unsigned v = opt_getVariable(lf->vars, e);
+
+    if (v != CFG_NONE) {
+        lf->blockOf[v] = lf->block;
+        lf->valueOf[v] = value;
+    }
+}
+
+// whether the variable an expression was computed into has not been written since
+static unsigned char
+is_held(LvnFunction* lf, LvnExpression* expression) {
+    unsigned v = expression->holder;
+    return lf->blockOf[v] == lf->block && lf->valueOf[v] == expression->value;
+}
+
+static unsigned char
+same_constant(Expr* c1, Expr* c2) {
+    if (c1 == c2) {
+        return 1;
+    }
+    if (icode_getExprType(c1) != icode_getExprType(c2)) {
+        return 0;
+    }
+
+    switch (icode_getExprType(c1)) {
+        case constnum_e: {
+            double n1 = icode_getNumConst(c1);
+            double n2 = icode_getNumConst(c2);
+            return n1 == n2 && signbit(n1) == signbit(n2);
+        }
+        case constbool_e:
+            return icode_getBoolConst(c1) == icode_getBoolConst(c2);
+        case conststring_e:
+            return strcmp(icode_getStringConst(c1), icode_getStringConst(c2)) == 0;
+        case nil_e:
+            return 1;
+        case programfunc_e:
+        case libraryfunc_e:
+            return icode_getExprEntry(c1) == icode_getExprEntry(c2);
+        default:
+            return 0;
+    }
+}
+
+// tables compare number keys by value, so unlike operands 0 and -0 are the same key
+static unsigned char
+same_key(Expr* c1, Expr* c2) {
+    if (icode_getExprType(c1) == constnum_e && icode_getExprType(c2) == constnum_e) {
+        return icode_getNumConst(c1) == icode_getNumConst(c2);
+    }
+    return same_constant(c1, c2);
+}
@@ -0,0 +1,14 @@
+#ifndef LVN_H
+#define LVN_H
+
+/*
+ * Local value numbering. Within a basic block, arithmetic that computes a
+ * value a variable still holds, and a table read of a key read before with
+ * no table write to a possibly equal key and no code-running call since,
+ * become assigns from that variable, for copy propagation and dead code
+ * elimination to clean up after.
+ */
+void
+lvn_run();
+
+#endif
@@ -0,0 +1,345 @@
+#include "opt.h"
+#include "ccp.h"
+#include "dce.h"
+#include "copy.h"
+#include "slots.h"
+#include "jumps.h"
+#include "licm.h"
+#include "lvn.h"
+#include "types.h"
+#include "../cfg/cfg.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <string.h>
+
+typedef struct OptVariables {
+    SymbolTableEntry** entries;
+    unsigned total;
+    unsigned size;
+
+    // open addressing from entries to their numbers
+    unsigned* slots;
+    unsigned totalSlots;
+} OptVariables;
+
+// library functions that neither run user code nor let other coroutines run
+static const char* pureLibraryFunctions[] = {
+    "print",
+    "flush",
+    "objectmemberkeys",
+    "objecttotalmembers",
+    "objectcopy",
+    "totalarguments",
+    "argument",
+    "typeof",
+    "strtonum",
+    "sqrt",
+    "cos",
+    "sin",
+    "coroutine",
+    "coroutinestatus",
+    "open",
+    "close"
+};
+
+#define TOTAL_PURE_LIBRARY_FUNCTIONS (sizeof(pureLibraryFunctions) / sizeof(pureLibraryFunctions[0]))
+
+/* ------------------------------------------ Static Declarations ------------------------------------------ */
+static void
+add_variable(OptVariables* vars, SymbolTableEntry* entry);
+
+static unsigned
+find_slot(OptVariables* vars, SymbolTableEntry* entry);
+
+static void
+grow_slots(OptVariables* vars);
+
+/* ------------------------------------------ Implementation ------------------------------------------ */
+void
+opt_optimize() {
+    ccp_run();
+    cfg_build();
+    dce_run();
+    cfg_build();
+    lvn_run();
+    copy_propagate();
+    dce_run();
+    copy_coalesce();
+    do {
+        cfg_build();
+    } while (licm_run());
+    slots_allocate();
+    jumps_run();
+    cfg_build();
+    types_infer();
+}
+
+OptVariables*
+opt_newVariables(unsigned f) {
+    OptVariables* vars = calloc(1, sizeof(OptVariables));
+
+    if (!vars) {
+        printf("Error allocating memory for the optimizer.\n");
+        exit(1);
+    }
+
+    unsigned first = cfg_getFunctionFirstBlock(f);
+    unsigned last = first + cfg_getFunctionTotalBlocks(f);
+
+    for (unsigned b = first; b < last; b++) {
+        for (unsigned i = cfg_getFirstQuad(b); i <= cfg_getLastQuad(b); i++) {
+            Quad* q = quad_getAt(i);
+
+            for (unsigned operand = OPT_ARG1; operand <= OPT_RESULT; operand <<= 1) {
+                Expr* e = opt_getOperand(q, operand);
+                if (opt_isVariable(e) && ((opt_getUses(q) | opt_getDefinition(q)) & operand)) {
+                    add_variable(vars, icode_getExprEntry(e));
+                }
+            }
+        }
+    }
+    return vars;
+}
+
+void
+opt_freeVariables(OptVariables* vars) {
+    free(vars->entries);
+    free(vars->slots);
+    free(vars);
+}
+
+unsigned
+opt_totalVariables(OptVariables* vars) {
+    return vars->total;
+}
+
+unsigned
+opt_getVariable(OptVariables* vars, Expr* e) {
+    if (!opt_isVariable(e) || !vars->totalSlots) {
+        return CFG_NONE;
+    }
+    return vars->slots[find_slot(vars, icode_getExprEntry(e))];
+}
+
+SymbolTableEntry*
+opt_getVariableEntry(OptVariables* vars, unsigned v) {
+    assert(v < vars->total);
+    return vars->entries[v];
+}
+
+unsigned char
+opt_isVariable(Expr* e) {
+    if (!e) {
+        return 0;
+    }
+
+    switch (icode_getExprType(e)) {
+        case var_e:
+        case tableitem_e:
+        case arithmexpr_e:
+        case boolexpr_e:
+        case assignexpr_e:
+        case newtable_e:
+            return icode_getExprEntry(e) != NULL;
+        default:
+            return 0;
+    }
+}
+
+unsigned char
+opt_isConstant(Expr* e) {
+    return e && !opt_isVariable(e);
+}
+
+unsigned char
+opt_isVisibleToCalls(SymbolTableEntry* entry) {
+    return symtab_getVariableSpace(entry) == PROGRAMVAR && symtab_getEntryName(entry)[0] != '_';
+}
+
+unsigned char
+opt_callRunsCode(Quad* q) {
+    Expr* function = quad_getArg1(q);
+
+    if (icode_getExprType(function) != libraryfunc_e) {
+        return 1;
+    }
+
+    const char* name = symtab_getEntryName(icode_getExprEntry(function));
+    for (unsigned i = 0; i < TOTAL_PURE_LIBRARY_FUNCTIONS; i++) {
+        if (strcmp(name, pureLibraryFunctions[i]) == 0) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+Expr*
+opt_getOperand(Quad* q, unsigned operand) {
+    switch (operand) {
+        case OPT_ARG1:      return quad_getArg1(q);
+        case OPT_ARG2:      return quad_getArg2(q);
+        case OPT_RESULT:    return quad_getResult(q);
+        default:            assert(0); return NULL;
+    }
+}
+
+void
+opt_setOperand(Quad* q, unsigned operand, Expr* e) {
+    switch (operand) {
+        case OPT_ARG1:      quad_setArg1(q, e); break;
+        case OPT_ARG2:      quad_setArg2(q, e); break;
+        case OPT_RESULT:    quad_setResult(q, e); break;
+        default:            assert(0);
+    }
+}
+
+unsigned
+opt_getDefinition(Quad* q) {
+    switch (quad_getOpcode(quad_getIndex(q))) {
+        case add_op:
+        case sub_op:
+        case mul_op:
+        case div_op:
+        case mod_op:
+        case uminus_op:
+        case assign_op:
+        case tablegetelem_op:
+        case not_op:
+        case or_op:
+        case and_op:
+        case getretval_op:
+            return OPT_RESULT;
+        case tablecreate_op:
+            return OPT_ARG1;
+        default:
+            return 0;
+    }
+}
+
+unsigned
+opt_getUses(Quad* q) {
+    switch (quad_getOpcode(quad_getIndex(q))) {
+        case add_op:
+        case sub_op:
+        case mul_op:
+        case div_op:
+        case mod_op:
+        case or_op:
+        case and_op:
+        case tablegetelem_op:
+        case if_eq_op:
+        case if_noteq_op:
+        case if_greater_op:
+        case if_greatereq_op:
+        case if_less_op:
+        case if_lesseq_op:
+            return OPT_ARG1 | OPT_ARG2;
+        case uminus_op:
+        case assign_op:
+        case not_op:
+        case param_op:
+        case call_op:
+            return OPT_ARG1;
+        case tablesetelem_op:
+            return OPT_ARG1 | OPT_ARG2 | OPT_RESULT;
+        case ret_op:
+            return quad_getResult(q) ? OPT_RESULT : 0;
+        default:
+            return 0;
+    }
+}
+
+void
+opt_removeQuad(unsigned i) {
+    Quad* q = quad_getAt(i);
+
+    assert(quad_getOpcode(i) != funcstart_op && quad_getOpcode(i) != funcend_op);
+
+    quad_setOpcode(q, nop_op);
+    quad_setArg1(q, NULL);
+    quad_setArg2(q, NULL);
+    quad_setResult(q, NULL);
+    quad_patchLabel(i, 0);
+}
+
+unsigned char
+opt_isConditional(IOPCodeType op) {
+    return op >= if_eq_op && op <= if_lesseq_op;
+}
+
+unsigned char
+opt_isBranch(IOPCodeType op) {
+    return op == jump_op || opt_isConditional(op);
+}
+
+unsigned char
+opt_endsBlock(IOPCodeType op) {
+    return opt_isBranch(op) || op == ret_op || op == funcend_op;
+}
+
+unsigned char
+opt_fallsThrough(unsigned i) {
+    IOPCodeType op = quad_getOpcode(i);
+    return op != jump_op && op != ret_op && op != funcend_op;
+}
+
+void*
+opt_allocate(size_t size) {
+    void* p = malloc(size ? size : 1);
+
+    if (!p) {
+        printf("Error allocating memory for the optimizer.\n");
+        exit(1);
+    }
+    return p;
+}
+
+/* ------------------------------------------ Static Definitions ------------------------------------------ */
+static void
+add_variable(OptVariables* vars, SymbolTableEntry* entry) {
+    if (vars->total * 2 >= vars->totalSlots) {
+        grow_slots(vars);
+    }
+
+    unsigned slot = find_slot(vars, entry);
+    if (vars->slots[slot] != CFG_NONE) {
+        return;
+    }
+
+    if (vars->total == vars->size) {
+        vars->size = vars->size ? vars->size * 2 : 32;
+        vars->entries = realloc(vars->entries, sizeof(SymbolTableEntry*) * vars->size);
+        if (!vars->entries) {
+            printf("Error allocating memory for the optimizer.\n");
+            exit(1);
+        }
+    }
+    vars->entries[vars->total] = entry;
+    vars->slots[slot] = vars->total++;
+}
+
+static unsigned
+find_slot(OptVariables* vars, SymbolTableEntry* entry) {
+    unsigned mask = vars->totalSlots - 1;
+    unsigned slot = (unsigned) (((size_t) entry >> 4) * 2654435761u) & mask;
+
+    while (vars->slots[slot] != CFG_NONE && vars->entries[vars->slots[slot]] != entry) {
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+static void
+grow_slots(OptVariables* vars) {
+    free(vars->slots);
+
+    vars->totalSlots = vars->totalSlots ? vars->totalSlots * 2 : 64;
+    vars->slots = opt_allocate(sizeof(unsigned) * vars->totalSlots);
+    memset(vars->slots, 0xff, sizeof(unsigned) * vars->totalSlots);
+
+    for (unsigned v = 0; v < vars->total; v++) {
+        vars->slots[find_slot(vars, vars->entries[v])] = v;
+    }
+}
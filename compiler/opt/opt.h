@@ -0,0 +1,96 @@
+#ifndef OPT_H
+#define OPT_H
+
+#include "../icode/icode.h"
+#include "../quad/quad.h"
+#include "../symbol_table/symbol_table.h"
+
+#include <stddef.h>
+
+// the operands of a quad, as bits
+#define OPT_ARG1    1
+#define OPT_ARG2    2
+#define OPT_RESULT  4
+
+/*
+ * The optimizations over the quads, run with the control-flow graphs
+ * built and before target code generation. A removed quad becomes a
+ * nop_op, so that the labels of the others keep their meaning; the
+ * graphs are built again after every pass.
+ */
+void
+opt_optimize();
+
+/*
+ * What the passes share. The variables of a function are numbered densely
+ * for the dataflow problems, in the order the quads use them.
+ */
+typedef struct OptVariables OptVariables;
+
+OptVariables*
+opt_newVariables(unsigned f);
+
+void
+opt_freeVariables(OptVariables* vars);
+
+unsigned
+opt_totalVariables(OptVariables* vars);
+
+// the number of the variable an operand reads or writes, CFG_NONE for constants
+unsigned
+opt_getVariable(OptVariables* vars, Expr* e);
+
+SymbolTableEntry*
+opt_getVariableEntry(OptVariables* vars, unsigned v);
+
+unsigned char
+opt_isVariable(Expr* e);
+
+unsigned char
+opt_isConstant(Expr* e);
+
+// globals a called function may read or write, which temporaries never are
+unsigned char
+opt_isVisibleToCalls(SymbolTableEntry* entry);
+
+// a call to a user function, or to a library function that may run one
+unsigned char
+opt_callRunsCode(Quad* q);
+
+Expr*
+opt_getOperand(Quad* q, unsigned operand);
+
+void
+opt_setOperand(Quad* q, unsigned operand, Expr* e);
+
+// the operand a quad writes to, 0 if none, and the operands it reads
+unsigned
+opt_getDefinition(Quad* q);
+
+unsigned
+opt_getUses(Quad* q);
+
+void
+opt_removeQuad(unsigned i);
+
+// a conditional jump
+unsigned char
+opt_isConditional(IOPCodeType op);
+
+// a jump or a conditional jump, going to its label
+unsigned char
+opt_isBranch(IOPCodeType op);
+
+// a branch, return or function end, after which a new basic block starts
+unsigned char
+opt_endsBlock(IOPCodeType op);
+
+// whether control may go on from quad i to the next one
+unsigned char
+opt_fallsThrough(unsigned i);
+
+// memory for the passes, which stop the compiler when there is none
+void*
+opt_allocate(size_t size);
+
+#endif
@@ -0,0 +1,211 @@
+#include "slots.h"
+#include "opt.h"
+#include "liveness.h"
+#include "../cfg/cfg.h"
+#include "../scope_space/scope_space.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <string.h>
+
+// functions with more locals than this keep the slots the parser gave them
+#define SLOTS_MAX_LOCALS    4096
+
+typedef struct SlotsFunction {
+    OptVariables* vars;
+    Liveness* lv;
+
+    unsigned totalLocals;
+    unsigned* localOf;          // by variable, its number among the locals or CFG_NONE
+    unsigned* variableOf;       // by local
+    unsigned char* interferes;  // a bit matrix by local
+} SlotsFunction;
+
+/* ------------------------------------------ Static Declarations ------------------------------------------ */
+static void
+allocate_function(unsigned f);
+
+static void
+find_interference(SlotsFunction* sf, unsigned f);
+
+static void
+interfere_with_live(SlotsFunction* sf, unsigned local, LiveSet* live);
+
+static void
+add_interference(SlotsFunction* sf, unsigned l1, unsigned l2);
+
+static unsigned char
+is_interfering(SlotsFunction* sf, unsigned l1, unsigned l2);
+
+/* ------------------------------------------ Implementation ------------------------------------------ */
+void
+slots_allocate() {
+    // function 0 is the program, whose variables are globals
+    for (unsigned f = 1; f < cfg_totalFunctions(); f++) {
+        allocate_function(f);
+    }
+}
+
+/* ------------------------------------------ Static Definitions ------------------------------------------ */
+static void
+allocate_function(unsigned f) {
+    SlotsFunction sf;
+    SymbolTableEntry* function = icode_getExprEntry(quad_getArg1(quad_getAt(cfg_getFunctionStart(f))));
+
+    sf.vars = opt_newVariables(f);
+    sf.totalLocals = 0;
+
+    unsigned totalVars = opt_totalVariables(sf.vars);
+    sf.localOf = opt_allocate(sizeof(unsigned) * (totalVars + 1));
+    sf.variableOf = opt_allocate(sizeof(unsigned) * (totalVars + 1));
+
+    for (unsigned v = 0; v < totalVars; v++) {
+        if (symtab_getVariableSpace(opt_getVariableEntry(sf.vars, v)) == FUNCTIONLOCAL) {
+            sf.variableOf[sf.totalLocals++] = v;
+        }
+    }
+
+    sf.lv = sf.totalLocals && sf.totalLocals <= SLOTS_MAX_LOCALS ? liveness_build(f, sf.vars) : NULL;
+    if (!sf.lv) {
+        free(sf.localOf);
+        free(sf.variableOf);
+        opt_freeVariables(sf.vars);
+        return;
+    }
+
+    // the parser's order, so that slots stay in declaration order where nothing is shared
+    for (unsigned i = 1; i < sf.totalLocals; i++) {
+        unsigned v = sf.variableOf[i];
+        unsigned offset = symtab_getVariableOffset(opt_getVariableEntry(sf.vars, v));
+        unsigned j = i;
+
+        while (j > 0 && symtab_getVariableOffset(opt_getVariableEntry(sf.vars, sf.variableOf[j - 1])) > offset) {
+            sf.variableOf[j] = sf.variableOf[j - 1];
+            j--;
+        }
+        sf.variableOf[j] = v;
+    }
+
+    memset(sf.localOf, 0xff, sizeof(unsigned) * (totalVars + 1));
+    for (unsigned l = 0; l < sf.totalLocals; l++) {
+        sf.localOf[sf.variableOf[l]] = l;
+    }
+
+    sf.interferes = opt_allocate(((size_t) sf.totalLocals * sf.totalLocals + 7) / 8);
+    memset(sf.interferes, 0, ((size_t) sf.totalLocals * sf.totalLocals + 7) / 8);
+
+    find_interference(&sf, f);
+
+    // greedily, the lowest slot no interfering local already has
+    unsigned* slotOf = opt_allocate(sizeof(unsigned) * sf.totalLocals);
+    unsigned char* taken = opt_allocate(sf.totalLocals);
+    unsigned totalSlots = 0;
+
+    for (unsigned l = 0; l < sf.totalLocals; l++) {
+        unsigned slot = 0;
+
+        memset(taken, 0, sf.totalLocals);
+        for (unsigned other = 0; other < l; other++) {
+            if (is_interfering(&sf, l, other)) {
+                taken[slotOf[other]] = 1;
+            }
+        }
+        while (taken[slot]) {
+            slot++;
+        }
+
+        slotOf[l] = slot;
+        if (slot + 1 > totalSlots) {
+            totalSlots = slot + 1;
+        }
+    }
+
+    if (totalSlots < symtab_getFunctionLocalSize(function)) {
+        for (unsigned l = 0; l < sf.totalLocals; l++) {
+            symtab_setVariableOffset(opt_getVariableEntry(sf.vars, sf.variableOf[l]), slotOf[l]);
+        }
+        symtab_setFunctionLocal(function, totalSlots);
+    }
+
+    free(slotOf);
+    free(taken);
+    free(sf.interferes);
+    free(sf.localOf);
+    free(sf.variableOf);
+    liveness_destroy(sf.lv);
+    opt_freeVariables(sf.vars);
+}
+
+static void
+find_interference(SlotsFunction* sf, unsigned f) {
+    LiveSet* live = liveness_newSet(sf->lv);
+
+    for (unsigned r = 0; r < cfg_getFunctionTotalReachable(f); r++) {
+        unsigned b = cfg_getFunctionRpoBlock(f, r);
+
+        liveness_getOut(sf->lv, b, live);
+
+        for (unsigned i = cfg_getLastQuad(b) + 1; i-- > cfg_getFirstQuad(b);) {
+            Quad* q = quad_getAt(i);
+            unsigned definition = opt_getDefinition(q);
+            unsigned v = definition ? opt_getVariable(sf->vars, opt_getOperand(q, definition)) : CFG_NONE;
+            unsigned local = v != CFG_NONE ? sf->localOf[v] : CFG_NONE;
+
+            if (local != CFG_NONE) {
+                interfere_with_live(sf, local, live);
+            }
+
+            liveness_stepBack(sf->lv, q, live);
+
+            // a table read clears its destination before reading its operands
+            if (local != CFG_NONE && quad_getOpcode(i) == tablegetelem_op) {
+                for (unsigned operand = OPT_ARG1; operand <= OPT_ARG2; operand <<= 1) {
+                    unsigned used = opt_getVariable(sf->vars, opt_getOperand(q, operand));
+                    if (used != CFG_NONE && sf->localOf[used] != CFG_NONE && sf->localOf[used] != local) {
+                        add_interference(sf, local, sf->localOf[used]);
+                    }
+                }
+            }
+        }
+
+        // what is live on entry to the function may be read before being written
+        if (b == cfg_getFunctionFirstBlock(f)) {
+            for (unsigned l = 0; l < sf->totalLocals; l++) {
+                if (liveness_contains(live, sf->variableOf[l])) {
+                    for (unsigned other = 0; other < sf->totalLocals; other++) {
+                        if (other != l) {
+                            add_interference(sf, l, other);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    free(live);
+}
+
+static void
+interfere_with_live(SlotsFunction* sf, unsigned local, LiveSet* live) {
+    for (unsigned l = 0; l < sf->totalLocals; l++) {
+        if (l != local && liveness_contains(live, sf->variableOf[l])) {
+            add_interference(sf, local, l);
+        }
+    }
+}
+
+static void
+add_interference(SlotsFunction* sf, unsigned l1, unsigned l2) {
+    size_t bit1 = (size_t) l1 * sf->totalLocals + l2;
+    size_t bit2 = (size_t) l2 * sf->totalLocals + l1;
+
+    sf->interferes[bit1 / 8] |= 1 << (bit1 % 8);
+    sf->interferes[bit2 / 8] |= 1 << (bit2 % 8);
+}
+
+static unsigned char
+is_interfering(SlotsFunction* sf, unsigned l1, unsigned l2) {
+    size_t bit = (size_t) l1 * sf->totalLocals + l2;
+    return (sf->interferes[bit / 8] >> (bit % 8)) & 1;
+}
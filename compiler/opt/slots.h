@@ -0,0 +1,14 @@
+#ifndef SLOTS_H
+#define SLOTS_H
+
+/*
+ * Packs the local variables of every function into few stack slots, two
+ * sharing a slot when neither is live where the other is written, and
+ * shrinks the function's frame to match. Locals that may be read before
+ * they are written keep a slot of their own, so they still read undef.
+ * Runs last, as nothing after it may lengthen a live range.
+ */
+void
+slots_allocate();
+
+#endif
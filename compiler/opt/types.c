@@ -0,0 +1,254 @@
+#include "types.h"
+#include "opt.h"
+#include "../cfg/cfg.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <string.h>
+
+// functions with more blocks times words of variables than this are left unmarked
+#define TYPES_MAX_WORDS (1u << 20)
+
+typedef unsigned long TypesSet;
+
+#define WORD_BITS   (sizeof(TypesSet) * 8)
+
+typedef struct TypesFunction {
+    unsigned function;
+    unsigned firstBlock;
+    unsigned totalBlocks;
+    OptVariables* vars;
+    unsigned totalVars;
+
+    unsigned* visible;
+    unsigned totalVisible;
+
+    unsigned words;
+    TypesSet* out;              // by block, the variables known to hold numbers on exit
+} TypesFunction;
+
+/* ------------------------------------------ Static Declarations ------------------------------------------ */
+static void
+infer_function(unsigned f);
+
+static void
+solve(TypesFunction* tf);
+
+static void
+mark(TypesFunction* tf);
+
+static void
+flow_into(TypesFunction* tf, unsigned b, TypesSet* set);
+
+static void
+transfer(TypesFunction* tf, Quad* q, TypesSet* set);
+
+static unsigned char
+is_number(TypesFunction* tf, Expr* e, TypesSet* set);
+
+static void
+set_number(unsigned v, unsigned char number, TypesSet* set);
+
+/* ------------------------------------------ Implementation ------------------------------------------ */
+void
+types_infer() {
+    for (unsigned f = 0; f < cfg_totalFunctions(); f++) {
+        infer_function(f);
+    }
+}
+
+/* ------------------------------------------ Static Definitions ------------------------------------------ */
+static void
+infer_function(unsigned f) {
+    TypesFunction tf;
+
+    memset(&tf, 0, sizeof(TypesFunction));
+    tf.function = f;
+    tf.firstBlock = cfg_getFunctionFirstBlock(f);
+    tf.totalBlocks = cfg_getFunctionTotalBlocks(f);
+    tf.vars = opt_newVariables(f);
+    tf.totalVars = opt_totalVariables(tf.vars);
+
+    tf.visible = opt_allocate(sizeof(unsigned) * (tf.totalVars + 1));
+    for (unsigned v = 0; v < tf.totalVars; v++) {
+        if (opt_isVisibleToCalls(opt_getVariableEntry(tf.vars, v))) {
+            tf.visible[tf.totalVisible++] = v;
+        }
+    }
+
+    tf.words = (tf.totalVars + WORD_BITS - 1) / WORD_BITS;
+    if (tf.words == 0) {
+        tf.words = 1;
+    }
+
+    if (tf.totalBlocks <= TYPES_MAX_WORDS / tf.words) {
+        tf.out = opt_allocate(sizeof(TypesSet) * tf.totalBlocks * tf.words);
+
+        solve(&tf);
+        mark(&tf);
+
+        free(tf.out);
+    }
+
+    free(tf.visible);
+    opt_freeVariables(tf.vars);
+}
+
+// forwards in reverse postorder, the variables holding numbers on every incoming path
+static void
+solve(TypesFunction* tf) {
+    unsigned totalReachable = cfg_getFunctionTotalReachable(tf->function);
+    TypesSet* set = opt_allocate(sizeof(TypesSet) * tf->words);
+    unsigned char changed;
+
+    memset(tf->out, 0xff, sizeof(TypesSet) * tf->totalBlocks * tf->words);
+
+    do {
+        changed = 0;
+
+        for (unsigned r = 0; r < totalReachable; r++) {
+            unsigned b = cfg_getFunctionRpoBlock(tf->function, r);
+            TypesSet* out = tf->out + (size_t) (b - tf->firstBlock) * tf->words;
+
+            flow_into(tf, b, set);
+            for (unsigned i = cfg_getFirstQuad(b); i <= cfg_getLastQuad(b); i++) {
+                transfer(tf, quad_getAt(i), set);
+            }
+
+            if (memcmp(out, set, sizeof(TypesSet) * tf->words) != 0) {
+                memcpy(out, set, sizeof(TypesSet) * tf->words);
+                changed = 1;
+            }
+        }
+    } while (changed);
+
+    free(set);
+}
+
+static void
+mark(TypesFunction* tf) {
+    TypesSet* set = opt_allocate(sizeof(TypesSet) * tf->words);
+
+    for (unsigned r = 0; r < cfg_getFunctionTotalReachable(tf->function); r++) {
+        unsigned b = cfg_getFunctionRpoBlock(tf->function, r);
+
+        flow_into(tf, b, set);
+        for (unsigned i = cfg_getFirstQuad(b); i <= cfg_getLastQuad(b); i++) {
+            Quad* q = quad_getAt(i);
+
+            switch (quad_getOpcode(i)) {
+                case uminus_op:
+                    quad_setNumeric(q, is_number(tf, quad_getArg1(q), set));
+                    break;
+                case add_op:
+                case sub_op:
+                case mul_op:
+                case div_op:
+                case mod_op:
+                case if_eq_op:
+                case if_noteq_op:
+                case if_greater_op:
+                case if_greatereq_op:
+                case if_less_op:
+                case if_lesseq_op:
+                    quad_setNumeric(q, is_number(tf, quad_getArg1(q), set) && is_number(tf, quad_getArg2(q), set));
+                    break;
+                default:
+                    quad_setNumeric(q, 0);
+                    break;
+            }
+            transfer(tf, q, set);
+        }
+    }
+
+    free(set);
+}
+
+static void
+flow_into(TypesFunction* tf, unsigned b, TypesSet* set) {
+    unsigned char first = 1;
+
+    // nothing is known of the arguments and globals a function starts with
+    memset(set, 0, sizeof(TypesSet) * tf->words);
+    if (b == tf->firstBlock) {
+        return;
+    }
+
+    for (unsigned i = 0; i < cfg_totalPredecessors(b); i++) {
+        unsigned pred = cfg_getPredecessor(b, i);
+        TypesSet* out = tf->out + (size_t) (pred - tf->firstBlock) * tf->words;
+
+        if (!cfg_isReachable(pred)) {
+            continue;
+        }
+        for (unsigned w = 0; w < tf->words; w++) {
+            set[w] = first ? out[w] : set[w] & out[w];
+        }
+        first = 0;
+    }
+}
+
+/*
+ * Arithmetic stops the program unless its operands are numbers, so past it
+ * its result is one. What a called function may write is unknown after it.
+ */
+static void
+transfer(TypesFunction* tf, Quad* q, TypesSet* set) {
+    unsigned definition = opt_getDefinition(q);
+
+    if (definition) {
+        unsigned v = opt_getVariable(tf->vars, opt_getOperand(q, definition));
+        unsigned char number;
+
+        switch (quad_getOpcode(quad_getIndex(q))) {
+            case add_op:
+            case sub_op:
+            case mul_op:
+            case div_op:
+            case mod_op:
+            case uminus_op:
+                number = 1;
+                break;
+            case assign_op:
+                number = is_number(tf, quad_getArg1(q), set);
+                break;
+            default:
+                number = 0;
+                break;
+        }
+        set_number(v, number, set);
+    }
+
+    if (quad_getOpcode(quad_getIndex(q)) == call_op && opt_callRunsCode(q)) {
+        for (unsigned i = 0; i < tf->totalVisible; i++) {
+            set_number(tf->visible[i], 0, set);
+        }
+    }
+}
+
+static unsigned char
+is_number(TypesFunction* tf, Expr* e, TypesSet* set) {
+    if (!e) {
+        return 0;
+    }
+    if (icode_getExprType(e) == constnum_e) {
+        return 1;
+    }
+
+    unsigned v = opt_getVariable(tf->vars, e);
+    return v != CFG_NONE && (set[v / WORD_BITS] >> (v % WORD_BITS)) & 1;
+}
+
+static void
+set_number(unsigned v, unsigned char number, TypesSet* set) {
+    if (v == CFG_NONE) {
+        return;
+    }
+    if (number) {
+        set[v / WORD_BITS] |= (TypesSet) 1 << (v % WORD_BITS);
+    }
+    else {
+        set[v / WORD_BITS] &= ~((TypesSet) 1 << (v % WORD_BITS));
+    }
+}
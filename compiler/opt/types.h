@@ -0,0 +1,16 @@
+#ifndef TYPES_H
+#define TYPES_H
+
+/*
+ * Type inference. Forwards over the quads of every function, a variable is
+ * known to hold a number where every path to it last wrote it with
+ * arithmetic, which fails on anything else, or with an assign from a
+ * number. The arithmetic and comparisons whose operands are all known to
+ * be numbers are marked numeric, for target code generation to emit them
+ * as opcodes specialized for numbers. Marks by quad number, so this runs
+ * after the quads stop moving.
+ */
+void
+types_infer();
+
+#endif
@@ -0,0 +1,2244 @@
+/* A Bison parser, made by GNU Bison 3.8.2.  */
+
+/* Bison implementation for Yacc-like parsers in C
+
+   Copyright (C) 1984, 1989-1990, 2000-2015, 2018-2021 Free Software Foundation,
+   Inc.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.  */
+
+/* As a special exception, you may create a larger work that contains
+   part or all of the Bison parser skeleton and distribute that work
+   under terms of your choice, so long as that work isn't itself a
+   parser generator using the skeleton or a modified version thereof
+   as a parser skeleton.  Alternatively, if you modify or redistribute
+   the parser skeleton itself, you may (at your option) remove this
+   special exception, which will cause the skeleton and the resulting
+   Bison output files to be licensed under the GNU General Public
+   License without this special exception.
+
+   This special exception was added by the Free Software Foundation in
+   version 2.2 of Bison.  */
+
+/* C LALR(1) parser skeleton written by Richard Stallman, by
+   simplifying the original so-called "semantic" parser.  */
+
+/* DO NOT RELY ON FEATURES THAT ARE NOT DOCUMENTED in the manual,
+   especially those whose name start with YY_ or yy_.  They are
+   private implementation details that can be changed or removed.  */
+
+/* All symbols defined below should begin with yy or YY, to avoid
+   infringing on user name space.  This should be done even for local
+   variables, as they might otherwise be expanded by user macros.
+   There are some unavoidable exceptions within include files to
+   define necessary library symbols; they are noted "INFRINGES ON
+   USER NAME SPACE" below.  */
+
+/* Identify Bison output, and Bison version.  */
+#define YYBISON 30802
+
+/* Bison version string.  */
+#define YYBISON_VERSION "3.8.2"
+
+/* Skeleton name.  */
+#define YYSKELETON_NAME "yacc.c"
+
+/* Pure parsers.  */
+#define YYPURE 0
+
+/* Push parsers.  */
+#define YYPUSH 0
+
+/* Pull parsers.  */
+#define YYPULL 1
+
+
+
+
+/* First part of user prologue.  */
+#line 1 "parser.y"
+
+
+#include "parser_util/parser_util.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+int yyerror(char* errorMessage);
+int yylex(void);
+
+extern FILE* yyin;
+extern char* yytext;
+extern int yylineno;
+
+
+#line 87 "parser.tab.c"
+
+# ifndef YY_CAST
+#  ifdef __cplusplus
+#   define YY_CAST(Type, Val) static_cast<Type> (Val)
+#   define YY_REINTERPRET_CAST(Type, Val) reinterpret_cast<Type> (Val)
+#  else
+#   define YY_CAST(Type, Val) ((Type) (Val))
+#   define YY_REINTERPRET_CAST(Type, Val) ((Type) (Val))
+#  endif
+# endif
+# ifndef YY_NULLPTR
+#  if defined __cplusplus
+#   if 201103L <= __cplusplus
+#    define YY_NULLPTR nullptr
+#   else
+#    define YY_NULLPTR 0
+#   endif
+#  else
+#   define YY_NULLPTR ((void*)0)
+#  endif
+# endif
+
+#include "parser.tab.h"
+/* Symbol kind.  */
+enum yysymbol_kind_t
+{
+  YYSYMBOL_YYEMPTY = -2,
+  YYSYMBOL_YYEOF = 0,                      /* "end of file"  */
+  YYSYMBOL_YYerror = 1,                    /* error  */
+  YYSYMBOL_YYUNDEF = 2,                    /* "invalid token"  */
+  YYSYMBOL_IF = 3,                         /* IF  */
+  YYSYMBOL_ELSE = 4,                       /* ELSE  */
+  YYSYMBOL_WHILE = 5,                      /* WHILE  */
+  YYSYMBOL_FOR = 6,                        /* FOR  */
+  YYSYMBOL_FUNCTION = 7,                   /* FUNCTION  */
+  YYSYMBOL_RETURN = 8,                     /* RETURN  */
+  YYSYMBOL_BREAK = 9,                      /* BREAK  */
+  YYSYMBOL_CONTINUE = 10,                  /* CONTINUE  */
+  YYSYMBOL_AND = 11,                       /* AND  */
+  YYSYMBOL_NOT = 12,                       /* NOT  */
+  YYSYMBOL_OR = 13,                        /* OR  */
+  YYSYMBOL_LOCAL = 14,                     /* LOCAL  */
+  YYSYMBOL_TRUE = 15,                      /* TRUE  */
+  YYSYMBOL_FALSE = 16,                     /* FALSE  */
+  YYSYMBOL_NIL = 17,                       /* NIL  */
+  YYSYMBOL_EQUAL = 18,                     /* EQUAL  */
+  YYSYMBOL_PLUS = 19,                      /* PLUS  */
+  YYSYMBOL_MINUS = 20,                     /* MINUS  */
+  YYSYMBOL_MULTIPLY = 21,                  /* MULTIPLY  */
+  YYSYMBOL_DIVIDE = 22,                    /* DIVIDE  */
+  YYSYMBOL_MODULO = 23,                    /* MODULO  */
+  YYSYMBOL_ASSIGN = 24,                    /* ASSIGN  */
+  YYSYMBOL_NOT_EQUAL = 25,                 /* NOT_EQUAL  */
+  YYSYMBOL_PLUS_PLUS = 26,                 /* PLUS_PLUS  */
+  YYSYMBOL_MINUS_MINUS = 27,               /* MINUS_MINUS  */
+  YYSYMBOL_GREATER = 28,                   /* GREATER  */
+  YYSYMBOL_GREATER_EQUAL = 29,             /* GREATER_EQUAL  */
+  YYSYMBOL_LESS = 30,                      /* LESS  */
+  YYSYMBOL_LESS_EQUAL = 31,                /* LESS_EQUAL  */
+  YYSYMBOL_LEFT_CURLY_BRACKET = 32,        /* LEFT_CURLY_BRACKET  */
+  YYSYMBOL_RIGHT_CURLY_BRACKET = 33,       /* RIGHT_CURLY_BRACKET  */
+  YYSYMBOL_LEFT_SQUARE_BRACKET = 34,       /* LEFT_SQUARE_BRACKET  */
+  YYSYMBOL_RIGHT_SQUARE_BRACKET = 35,      /* RIGHT_SQUARE_BRACKET  */
+  YYSYMBOL_LEFT_PARENTHESIS = 36,          /* LEFT_PARENTHESIS  */
+  YYSYMBOL_RIGHT_PARENTHESIS = 37,         /* RIGHT_PARENTHESIS  */
+  YYSYMBOL_COLON = 38,                     /* COLON  */
+  YYSYMBOL_SEMICOLON = 39,                 /* SEMICOLON  */
+  YYSYMBOL_COMMA = 40,                     /* COMMA  */
+  YYSYMBOL_DOUBLE_COLON = 41,              /* DOUBLE_COLON  */
+  YYSYMBOL_DOT = 42,                       /* DOT  */
+  YYSYMBOL_DOT_DOT = 43,                   /* DOT_DOT  */
+  YYSYMBOL_COMMENT = 44,                   /* COMMENT  */
+  YYSYMBOL_INTEGER = 45,                   /* INTEGER  */
+  YYSYMBOL_REAL = 46,                      /* REAL  */
+  YYSYMBOL_STRING = 47,                    /* STRING  */
+  YYSYMBOL_IDENTIFIER = 48,                /* IDENTIFIER  */
+  YYSYMBOL_UMINUS = 49,                    /* UMINUS  */
+  YYSYMBOL_YYACCEPT = 50,                  /* $accept  */
+  YYSYMBOL_program = 51,                   /* program  */
+  YYSYMBOL_stmts = 52,                     /* stmts  */
+  YYSYMBOL_stmt = 53,                      /* stmt  */
+  YYSYMBOL_expr = 54,                      /* expr  */
+  YYSYMBOL_primary = 55,                   /* primary  */
+  YYSYMBOL_lvalue = 56,                    /* lvalue  */
+  YYSYMBOL_member = 57,                    /* member  */
+  YYSYMBOL_call = 58,                      /* call  */
+  YYSYMBOL_callsuffix = 59,                /* callsuffix  */
+  YYSYMBOL_normcall = 60,                  /* normcall  */
+  YYSYMBOL_methodcall = 61,                /* methodcall  */
+  YYSYMBOL_elist = 62,                     /* elist  */
+  YYSYMBOL_objectdef = 63,                 /* objectdef  */
+  YYSYMBOL_indexed = 64,                   /* indexed  */
+  YYSYMBOL_indexedelem = 65,               /* indexedelem  */
+  YYSYMBOL_block = 66,                     /* block  */
+  YYSYMBOL_67_1 = 67,                      /* $@1  */
+  YYSYMBOL_68_2 = 68,                      /* $@2  */
+  YYSYMBOL_funcblockstart = 69,            /* funcblockstart  */
+  YYSYMBOL_funcblockend = 70,              /* funcblockend  */
+  YYSYMBOL_funcname = 71,                  /* funcname  */
+  YYSYMBOL_funcprefix = 72,                /* funcprefix  */
+  YYSYMBOL_funcargs = 73,                  /* funcargs  */
+  YYSYMBOL_funcbody = 74,                  /* funcbody  */
+  YYSYMBOL_funcdef = 75,                   /* funcdef  */
+  YYSYMBOL_funcblock = 76,                 /* funcblock  */
+  YYSYMBOL_const = 77,                     /* const  */
+  YYSYMBOL_idlist = 78,                    /* idlist  */
+  YYSYMBOL_ifstmt = 79,                    /* ifstmt  */
+  YYSYMBOL_ifprefix = 80,                  /* ifprefix  */
+  YYSYMBOL_elseprefix = 81,                /* elseprefix  */
+  YYSYMBOL_loopstart = 82,                 /* loopstart  */
+  YYSYMBOL_loopend = 83,                   /* loopend  */
+  YYSYMBOL_loopstmt = 84,                  /* loopstmt  */
+  YYSYMBOL_whilestmt = 85,                 /* whilestmt  */
+  YYSYMBOL_whilestart = 86,                /* whilestart  */
+  YYSYMBOL_whilecond = 87,                 /* whilecond  */
+  YYSYMBOL_forstmt = 88,                   /* forstmt  */
+  YYSYMBOL_forprefix = 89,                 /* forprefix  */
+  YYSYMBOL_N = 90,                         /* N  */
+  YYSYMBOL_M = 91,                         /* M  */
+  YYSYMBOL_returnstmt = 92                 /* returnstmt  */
+};
+typedef enum yysymbol_kind_t yysymbol_kind_t;
+
+
+
+
+#ifdef short
+# undef short
+#endif
+
+/* On compilers that do not define __PTRDIFF_MAX__ etc., make sure
+   <limits.h> and (if available) <stdint.h> are included
+   so that the code can choose integer types of a good width.  */
+
+#ifndef __PTRDIFF_MAX__
+# include <limits.h> /* INFRINGES ON USER NAME SPACE */
+# if defined __STDC_VERSION__ && 199901 <= __STDC_VERSION__
+#  include <stdint.h> /* INFRINGES ON USER NAME SPACE */
+#  define YY_STDINT_H
+# endif
+#endif
+
+/* Narrow types that promote to a signed type and that can represent a
+   signed or unsigned integer of at least N bits.  In tables they can
+   save space and decrease cache pressure.  Promoting to a signed type
+   helps avoid bugs in integer arithmetic.  */
+
+#ifdef __INT_LEAST8_MAX__
+typedef __INT_LEAST8_TYPE__ yytype_int8;
+#elif defined YY_STDINT_H
+typedef int_least8_t yytype_int8;
+#else
+typedef signed char yytype_int8;
+#endif
+
+#ifdef __INT_LEAST16_MAX__
+typedef __INT_LEAST16_TYPE__ yytype_int16;
+#elif defined YY_STDINT_H
+typedef int_least16_t yytype_int16;
+#else
+typedef short yytype_int16;
+#endif
+
+/* Work around bug in HP-UX 11.23, which defines these macros
+   incorrectly for preprocessor constants.  This workaround can likely
+   be removed in 2023, as HPE has promised support for HP-UX 11.23
+   (aka HP-UX 11i v2) only through the end of 2022; see Table 2 of
+   <https://h20195.www2.hpe.com/V2/getpdf.aspx/4AA4-7673ENW.pdf>.  */
+#ifdef __hpux
+# undef UINT_LEAST8_MAX
+# undef UINT_LEAST16_MAX
+# define UINT_LEAST8_MAX 255
+# define UINT_LEAST16_MAX 65535
+#endif
+
+#if defined __UINT_LEAST8_MAX__ && __UINT_LEAST8_MAX__ <= __INT_MAX__
+typedef __UINT_LEAST8_TYPE__ yytype_uint8;
+#elif (!defined __UINT_LEAST8_MAX__ && defined YY_STDINT_H \
+       && UINT_LEAST8_MAX <= INT_MAX)
+typedef uint_least8_t yytype_uint8;
+#elif !defined __UINT_LEAST8_MAX__ && UCHAR_MAX <= INT_MAX
+typedef unsigned char yytype_uint8;
+#else
+typedef short yytype_uint8;
+#endif
+
+#if defined __UINT_LEAST16_MAX__ && __UINT_LEAST16_MAX__ <= __INT_MAX__
+typedef __UINT_LEAST16_TYPE__ yytype_uint16;
+#elif (!defined __UINT_LEAST16_MAX__ && defined YY_STDINT_H \
+       && UINT_LEAST16_MAX <= INT_MAX)
+typedef uint_least16_t yytype_uint16;
+#elif !defined __UINT_LEAST16_MAX__ && USHRT_MAX <= INT_MAX
+typedef unsigned short yytype_uint16;
+#else
+typedef int yytype_uint16;
+#endif
+
+#ifndef YYPTRDIFF_T
+# if defined __PTRDIFF_TYPE__ && defined __PTRDIFF_MAX__
+#  define YYPTRDIFF_T __PTRDIFF_TYPE__
+#  define YYPTRDIFF_MAXIMUM __PTRDIFF_MAX__
+# elif defined PTRDIFF_MAX
+#  ifndef ptrdiff_t
+#   include <stddef.h> /* INFRINGES ON USER NAME SPACE */
+#  endif
+#  define YYPTRDIFF_T ptrdiff_t
+#  define YYPTRDIFF_MAXIMUM PTRDIFF_MAX
+# else
+#  define YYPTRDIFF_T long
+#  define YYPTRDIFF_MAXIMUM LONG_MAX
+# endif
+#endif
+
+#ifndef YYSIZE_T
+# ifdef __SIZE_TYPE__
+#  define YYSIZE_T __SIZE_TYPE__
+# elif defined size_t
+#  define YYSIZE_T size_t
+# elif defined __STDC_VERSION__ && 199901 <= __STDC_VERSION__
+#  include <stddef.h> /* INFRINGES ON USER NAME SPACE */
+#  define YYSIZE_T size_t
+# else
+#  define YYSIZE_T unsigned
+# endif
+#endif
+
+#define YYSIZE_MAXIMUM                                  \
+  YY_CAST (YYPTRDIFF_T,                                 \
+           (YYPTRDIFF_MAXIMUM < YY_CAST (YYSIZE_T, -1)  \
+            ? YYPTRDIFF_MAXIMUM                         \
+            : YY_CAST (YYSIZE_T, -1)))
+
+#define YYSIZEOF(X) YY_CAST (YYPTRDIFF_T, sizeof (X))
+
+
+/* Stored state numbers (used for stacks). */
+typedef yytype_uint8 yy_state_t;
+
+/* State numbers in computations.  */
+typedef int yy_state_fast_t;
+
+#ifndef YY_
+# if defined YYENABLE_NLS && YYENABLE_NLS
+#  if ENABLE_NLS
+#   include <libintl.h> /* INFRINGES ON USER NAME SPACE */
+#   define YY_(Msgid) dgettext ("bison-runtime", Msgid)
+#  endif
+# endif
+# ifndef YY_
+#  define YY_(Msgid) Msgid
+# endif
+#endif
+
+
+#ifndef YY_ATTRIBUTE_PURE
+# if defined __GNUC__ && 2 < __GNUC__ + (96 <= __GNUC_MINOR__)
+#  define YY_ATTRIBUTE_PURE __attribute__ ((__pure__))
+# else
+#  define YY_ATTRIBUTE_PURE
+# endif
+#endif
+
+#ifndef YY_ATTRIBUTE_UNUSED
+# if defined __GNUC__ && 2 < __GNUC__ + (7 <= __GNUC_MINOR__)
+#  define YY_ATTRIBUTE_UNUSED __attribute__ ((__unused__))
+# else
+#  define YY_ATTRIBUTE_UNUSED
+# endif
+#endif
+
+/* Suppress unused-variable warnings by "using" E.  */
+#if ! defined lint || defined __GNUC__
+# define YY_USE(E) ((void) (E))
+#else
+# define YY_USE(E) /* empty */
+#endif
+
+/* Suppress an incorrect diagnostic about yylval being uninitialized.  */
+#if defined __GNUC__ && ! defined __ICC && 406 <= __GNUC__ * 100 + __GNUC_MINOR__
+# if __GNUC__ * 100 + __GNUC_MINOR__ < 407
+#  define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                           \
+    _Pragma ("GCC diagnostic push")                                     \
+    _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")
+# else
+#  define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                           \
+    _Pragma ("GCC diagnostic push")                                     \
+    _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")              \
+    _Pragma ("GCC diagnostic ignored \"-Wmaybe-uninitialized\"")
+# endif
+# define YY_IGNORE_MAYBE_UNINITIALIZED_END      \
+    _Pragma ("GCC diagnostic pop")
+#else
+# define YY_INITIAL_VALUE(Value) Value
+#endif
+#ifndef YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+# define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+# define YY_IGNORE_MAYBE_UNINITIALIZED_END
+#endif
+#ifndef YY_INITIAL_VALUE
+# define YY_INITIAL_VALUE(Value) /* Nothing. */
+#endif
+
+#if defined __cplusplus && defined __GNUC__ && ! defined __ICC && 6 <= __GNUC__
+# define YY_IGNORE_USELESS_CAST_BEGIN                          \
+    _Pragma ("GCC diagnostic push")                            \
+    _Pragma ("GCC diagnostic ignored \"-Wuseless-cast\"")
+# define YY_IGNORE_USELESS_CAST_END            \
+    _Pragma ("GCC diagnostic pop")
+#endif
+#ifndef YY_IGNORE_USELESS_CAST_BEGIN
+# define YY_IGNORE_USELESS_CAST_BEGIN
+# define YY_IGNORE_USELESS_CAST_END
+#endif
+
+
+#define YY_ASSERT(E) ((void) (0 && (E)))
+
+#if !defined yyoverflow
+
+/* The parser invokes alloca or malloc; define the necessary symbols.  */
+
+# ifdef YYSTACK_USE_ALLOCA
+#  if YYSTACK_USE_ALLOCA
+#   ifdef __GNUC__
+#    define YYSTACK_ALLOC __builtin_alloca
+#   elif defined __BUILTIN_VA_ARG_INCR
+#    include <alloca.h> /* INFRINGES ON USER NAME SPACE */
+#   elif defined _AIX
+#    define YYSTACK_ALLOC __alloca
+#   elif defined _MSC_VER
+#    include <malloc.h> /* INFRINGES ON USER NAME SPACE */
+#    define alloca _alloca
+#   else
+#    define YYSTACK_ALLOC alloca
+#    if ! defined _ALLOCA_H && ! defined EXIT_SUCCESS
+#     include <stdlib.h> /* INFRINGES ON USER NAME SPACE */
+      /* Use EXIT_SUCCESS as a witness for stdlib.h.  */
+#     ifndef EXIT_SUCCESS
+#      define EXIT_SUCCESS 0
+#     endif
+#    endif
+#   endif
+#  endif
+# endif
+
+# ifdef YYSTACK_ALLOC
+   /* Pacify GCC's 'empty if-body' warning.  */
+#  define YYSTACK_FREE(Ptr) do { /* empty */; } while (0)
+#  ifndef YYSTACK_ALLOC_MAXIMUM
+    /* The OS might guarantee only one guard page at the bottom of the stack,
+       and a page size can be as small as 4096 bytes.  So we cannot safely
+       invoke alloca (N) if N exceeds 4096.  Use a slightly smaller number
+       to allow for a few compiler-allocated temporary stack slots.  */
+#   define YYSTACK_ALLOC_MAXIMUM 4032 /* reasonable circa 2006 */
+#  endif
+# else
+#  define YYSTACK_ALLOC YYMALLOC
+#  define YYSTACK_FREE YYFREE
+#  ifndef YYSTACK_ALLOC_MAXIMUM
+#   define YYSTACK_ALLOC_MAXIMUM YYSIZE_MAXIMUM
+#  endif
+#  if (defined __cplusplus && ! defined EXIT_SUCCESS \
+       && ! ((defined YYMALLOC || defined malloc) \
+             && (defined YYFREE || defined free)))
+#   include <stdlib.h> /* INFRINGES ON USER NAME SPACE */
+#   ifndef EXIT_SUCCESS
+#    define EXIT_SUCCESS 0
+#   endif
+#  endif
+#  ifndef YYMALLOC
+#   define YYMALLOC malloc
+#   if ! defined malloc && ! defined EXIT_SUCCESS
+void *malloc (YYSIZE_T); /* INFRINGES ON USER NAME SPACE */
+#   endif
+#  endif
+#  ifndef YYFREE
+#   define YYFREE free
+#   if ! defined free && ! defined EXIT_SUCCESS
+void free (void *); /* INFRINGES ON USER NAME SPACE */
+#   endif
+#  endif
+# endif
+#endif /* !defined yyoverflow */
+
+#if (! defined yyoverflow \
+     && (! defined __cplusplus \
+         || (defined YYSTYPE_IS_TRIVIAL && YYSTYPE_IS_TRIVIAL)))
+
+/* A type that is properly aligned for any stack member.  */
+union yyalloc
+{
+  yy_state_t yyss_alloc;
+  YYSTYPE yyvs_alloc;
+};
+
+/* The size of the maximum gap between one aligned stack and the next.  */
+# define YYSTACK_GAP_MAXIMUM (YYSIZEOF (union yyalloc) - 1)
+
+/* The size of an array large to enough to hold all stacks, each with
+   N elements.  */
+# define YYSTACK_BYTES(N) \
+     ((N) * (YYSIZEOF (yy_state_t) + YYSIZEOF (YYSTYPE)) \
+      + YYSTACK_GAP_MAXIMUM)
+
+# define YYCOPY_NEEDED 1
+
+/* Relocate STACK from its old location to the new one.  The
+   local variables YYSIZE and YYSTACKSIZE give the old and new number of
+   elements in the stack, and YYPTR gives the new location of the
+   stack.  Advance YYPTR to a properly aligned location for the next
+   stack.  */
+# define YYSTACK_RELOCATE(Stack_alloc, Stack)                           \
+    do                                                                  \
+      {                                                                 \
+        YYPTRDIFF_T yynewbytes;                                         \
+        YYCOPY (&yyptr->Stack_alloc, Stack, yysize);                    \
+        Stack = &yyptr->Stack_alloc;                                    \
+        yynewbytes = yystacksize * YYSIZEOF (*Stack) + YYSTACK_GAP_MAXIMUM; \
+        yyptr += yynewbytes / YYSIZEOF (*yyptr);                        \
+      }                                                                 \
+    while (0)
+
+#endif
+
+#if defined YYCOPY_NEEDED && YYCOPY_NEEDED
+/* Copy COUNT objects from SRC to DST.  The source and destination do
+   not overlap.  */
+# ifndef YYCOPY
+#  if defined __GNUC__ && 1 < __GNUC__
+#   define YYCOPY(Dst, Src, Count) \
+      __builtin_memcpy (Dst, Src, YY_CAST (YYSIZE_T, (Count)) * sizeof (*(Src)))
+#  else
+#   define YYCOPY(Dst, Src, Count)              \
+      do                                        \
+        {                                       \
+          YYPTRDIFF_T yyi;                      \
+          for (yyi = 0; yyi < (Count); yyi++)   \
+            (Dst)[yyi] = (Src)[yyi];            \
+        }                                       \
+      while (0)
+#  endif
+# endif
+#endif /* !YYCOPY_NEEDED */
+
+/* YYFINAL -- State number of the termination state.  */
+#define YYFINAL  71
+/* YYLAST -- Last index in YYTABLE.  */
+#define YYLAST   759
+
+/* YYNTOKENS -- Number of terminals.  */
+#define YYNTOKENS  50
+/* YYNNTS -- Number of nonterminals.  */
+#define YYNNTS  43
+/* YYNRULES -- Number of rules.  */
+#define YYNRULES  106
+/* YYNSTATES -- Number of states.  */
+#define YYNSTATES  192
+
+/* YYMAXUTOK -- Last valid token kind.  */
+#define YYMAXUTOK   304
+
+
+/* YYTRANSLATE(TOKEN-NUM) -- Symbol number corresponding to TOKEN-NUM
+   as returned by yylex, with out-of-bounds checking.  */
+#define YYTRANSLATE(YYX)                                \
+  (0 <= (YYX) && (YYX) <= YYMAXUTOK                     \
+   ? YY_CAST (yysymbol_kind_t, yytranslate[YYX])        \
+   : YYSYMBOL_YYUNDEF)
+
+/* YYTRANSLATE[TOKEN-NUM] -- Symbol number corresponding to TOKEN-NUM
+   as returned by yylex.  */
+static const yytype_int8 yytranslate[] =
+{
+       0,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     1,     2,     3,     4,
+       5,     6,     7,     8,     9,    10,    11,    12,    13,    14,
+      15,    16,    17,    18,    19,    20,    21,    22,    23,    24,
+      25,    26,    27,    28,    29,    30,    31,    32,    33,    34,
+      35,    36,    37,    38,    39,    40,    41,    42,    43,    44,
+      45,    46,    47,    48,    49
+};
+
+#if YYDEBUG
+/* YYRLINE[YYN] -- Source line where rule number YYN was defined.  */
+static const yytype_uint8 yyrline[] =
+{
+       0,    66,    66,    67,    72,    73,    77,    78,    79,    80,
+      81,    82,    83,    84,    85,    86,    90,    91,    92,    93,
+      94,    95,    96,    97,    98,    99,   100,   101,   102,   103,
+     104,   105,   106,   107,   108,   109,   110,   111,   115,   116,
+     117,   118,   119,   123,   124,   125,   126,   130,   131,   132,
+     133,   137,   138,   139,   140,   143,   143,   144,   144,   145,
+     148,   149,   153,   154,   155,   158,   158,   159,   162,   162,
+     165,   165,   169,   170,   172,   172,   173,   174,   175,   176,
+     177,   177,   180,   181,   182,   183,   184,   185,   189,   190,
+     191,   195,   196,   199,   200,   202,   203,   204,   206,   207,
+     208,   211,   212,   213,   214,   216,   217
+};
+#endif
+
+/** Accessing symbol of state STATE.  */
+#define YY_ACCESSING_SYMBOL(State) YY_CAST (yysymbol_kind_t, yystos[State])
+
+#if YYDEBUG || 0
+/* The user-facing name of the symbol whose (internal) number is
+   YYSYMBOL.  No bounds checking.  */
+static const char *yysymbol_name (yysymbol_kind_t yysymbol) YY_ATTRIBUTE_UNUSED;
+
+/* YYTNAME[SYMBOL-NUM] -- String name of the symbol SYMBOL-NUM.
+   First, the terminals, then, starting at YYNTOKENS, nonterminals.  */
+static const char *const yytname[] =
+{
+  "\"end of file\"", "error", "\"invalid token\"", "IF", "ELSE", "WHILE",
+  "FOR", "FUNCTION", "RETURN", "BREAK", "CONTINUE", "AND", "NOT", "OR",
+  "LOCAL", "TRUE", "FALSE", "NIL", "EQUAL", "PLUS", "MINUS", "MULTIPLY",
+  "DIVIDE", "MODULO", "ASSIGN", "NOT_EQUAL", "PLUS_PLUS", "MINUS_MINUS",
+  "GREATER", "GREATER_EQUAL", "LESS", "LESS_EQUAL", "LEFT_CURLY_BRACKET",
+  "RIGHT_CURLY_BRACKET", "LEFT_SQUARE_BRACKET", "RIGHT_SQUARE_BRACKET",
+  "LEFT_PARENTHESIS", "RIGHT_PARENTHESIS", "COLON", "SEMICOLON", "COMMA",
+  "DOUBLE_COLON", "DOT", "DOT_DOT", "COMMENT", "INTEGER", "REAL", "STRING",
+  "IDENTIFIER", "UMINUS", "$accept", "program", "stmts", "stmt", "expr",
+  "primary", "lvalue", "member", "call", "callsuffix", "normcall",
+  "methodcall", "elist", "objectdef", "indexed", "indexedelem", "block",
+  "$@1", "$@2", "funcblockstart", "funcblockend", "funcname", "funcprefix",
+  "funcargs", "funcbody", "funcdef", "funcblock", "const", "idlist",
+  "ifstmt", "ifprefix", "elseprefix", "loopstart", "loopend", "loopstmt",
+  "whilestmt", "whilestart", "whilecond", "forstmt", "forprefix", "N", "M",
+  "returnstmt", YY_NULLPTR
+};
+
+static const char *
+yysymbol_name (yysymbol_kind_t yysymbol)
+{
+  return yytname[yysymbol];
+}
+#endif
+
+#define YYPACT_NINF (-161)
+
+#define yypact_value_is_default(Yyn) \
+  ((Yyn) == YYPACT_NINF)
+
+#define YYTABLE_NINF (-71)
+
+#define yytable_value_is_error(Yyn) \
+  ((Yyn) == YYTABLE_NINF)
+
+/* YYPACT[STATE-NUM] -- Index in YYTABLE of the portion describing
+   STATE-NUM.  */
+static const yytype_int16 yypact[] =
+{
+     255,    -6,  -161,     6,     0,   352,     7,    20,   463,    53,
+    -161,  -161,  -161,   463,    47,    47,    74,   315,   292,  -161,
+      61,  -161,  -161,  -161,  -161,   110,   255,  -161,   107,  -161,
+     116,  -161,    64,  -161,  -161,  -161,  -161,  -161,  -161,   255,
+    -161,    75,  -161,  -161,  -161,   463,   463,  -161,  -161,  -161,
+     494,  -161,  -161,  -161,  -161,  -161,   106,    60,    64,    60,
+     255,    81,   463,  -161,   685,   -30,   -29,  -161,   559,    79,
+    -161,  -161,  -161,   463,   463,   463,   463,   463,   463,   463,
+     463,   463,   463,   463,   463,   463,  -161,   463,  -161,  -161,
+     463,   389,    71,    73,  -161,  -161,  -161,   463,   426,    83,
+      87,   129,   463,  -161,   463,   580,   -25,  -161,    97,    17,
+    -161,   538,  -161,   463,  -161,   109,  -161,   103,   714,   700,
+     728,    68,    68,  -161,  -161,  -161,   728,   294,   294,   294,
+     294,   685,   622,  -161,   -21,  -161,   108,   643,  -161,   -19,
+    -161,    99,  -161,  -161,   255,   601,   255,  -161,    -2,  -161,
+    -161,   103,  -161,   463,   685,  -161,   463,  -161,  -161,   463,
+    -161,  -161,  -161,    -1,   113,  -161,  -161,  -161,  -161,  -161,
+     463,   664,    15,    44,  -161,   101,   163,  -161,  -161,   255,
+     516,  -161,  -161,  -161,  -161,  -161,   209,  -161,  -161,  -161,
+    -161,  -161
+};
+
+/* YYDEFACT[STATE-NUM] -- Default reduction number in state STATE-NUM.
+   Performed when YYTABLE does not specify something else to do.  Zero
+   means the default is an error.  */
+static const yytype_int8 yydefact[] =
+{
+       3,     0,    99,     0,    75,     0,     0,     0,     0,     0,
+      86,    87,    85,     0,     0,     0,    68,     0,     0,    15,
+       0,    82,    83,    84,    43,     0,     2,     4,     0,    37,
+      38,    46,    39,    40,    13,   104,    14,    42,     7,     0,
+       8,     0,     9,   103,    10,     0,     0,    74,    76,   106,
+       0,    11,    12,    32,    44,    31,     0,    33,     0,    35,
+       0,     0,     0,    64,    60,     0,     0,    65,     0,     0,
+      45,     1,     5,     0,     0,     0,     0,     0,     0,     0,
+       0,     0,     0,     0,     0,     0,     6,     0,    34,    36,
+       0,     0,     0,     0,    53,    55,    56,     0,     0,     0,
+       0,    91,     0,    95,     0,     0,     0,   105,     0,     0,
+      71,     0,    62,     0,    63,     0,    30,    41,    28,    29,
+      26,    17,    18,    19,    20,    21,    27,    22,    23,    24,
+      25,    16,     0,    58,     0,    47,     0,     0,    52,     0,
+      49,    90,    72,    94,     0,     0,     0,    98,     0,    93,
+     104,     0,    69,     0,    61,    66,     0,    48,    57,     0,
+      50,    51,    88,     0,     0,    79,    92,   100,    96,   103,
+       0,     0,     0,     0,    77,     0,     0,    73,    97,     0,
+       0,    67,    54,    59,    89,    81,     0,    78,   103,   102,
+      80,   101
+};
+
+/* YYPGOTO[NTERM-NUM].  */
+static const yytype_int16 yypgoto[] =
+{
+    -161,  -161,   -59,   -22,    -5,  -161,    52,  -161,    90,  -161,
+    -161,  -161,   -44,  -161,  -161,    38,  -161,  -161,  -161,  -161,
+    -161,  -161,  -161,  -161,  -161,   -11,  -161,  -161,  -161,  -161,
+    -161,  -161,  -161,  -161,  -161,  -161,  -161,  -161,  -161,  -161,
+    -160,     5,  -161
+};
+
+/* YYDEFGOTO[NTERM-NUM].  */
+static const yytype_uint8 yydefgoto[] =
+{
+       0,    25,    26,    27,    28,    29,    30,    31,    32,    94,
+      95,    96,    65,    33,    66,    67,    34,    60,    61,   164,
+     187,    48,    35,   142,   165,    36,   177,    37,   163,    38,
+      39,   144,   146,   178,   147,    40,    41,   103,    42,    43,
+     104,   100,    44
+};
+
+/* YYTABLE[YYPACT[STATE-NUM]] -- What to do in state STATE-NUM.  If
+   positive, shift that token.  If negative, reduce the rule whose
+   number is the opposite.  If YYTABLE_NINF, syntax error.  */
+static const yytype_int16 yytable[] =
+{
+      50,   109,   106,    53,    72,   112,   114,    69,    55,   179,
+     113,   115,    64,    68,   150,   113,   158,   101,   161,   113,
+       1,   113,     2,     3,     4,     5,     6,     7,   191,     8,
+      45,     9,    10,    11,    12,   169,   174,    13,   113,   175,
+     105,    64,    46,    14,    15,   108,    51,   134,    47,    16,
+     152,    17,   182,    18,   139,   113,    19,   111,    20,    52,
+     148,     9,    21,    22,    23,    24,    57,    59,   118,   119,
+     120,   121,   122,   123,   124,   125,   126,   127,   128,   129,
+     130,   183,   131,    56,   113,   132,    64,    72,    20,    78,
+      79,    80,   137,    64,    90,    24,    91,   145,    97,    64,
+      98,    54,    92,    93,    58,    58,    99,   -70,   154,    70,
+      71,   102,   172,     4,   110,   173,   117,   186,    73,   135,
+      74,   136,   166,   141,   168,    75,    76,    77,    78,    79,
+      80,   140,    81,   143,   151,    82,    83,    84,    85,   156,
+      87,    62,    88,    89,   159,   176,    86,   162,   171,   184,
+      90,    64,    91,   155,    64,   170,     0,   188,    92,    93,
+       0,     0,     0,     0,    72,   180,     1,     0,     2,     3,
+       4,     5,     6,     7,     0,     8,     0,     9,    10,    11,
+      12,     0,     0,    13,     0,     0,     0,     0,     0,    14,
+      15,     0,     0,     0,     0,    16,   185,    17,     0,    18,
+       0,     0,    19,     0,    20,     0,     0,     0,    21,    22,
+      23,    24,     1,     0,     2,     3,     4,     5,     6,     7,
+       0,     8,     0,     9,    10,    11,    12,     0,     0,    13,
+       0,     0,     0,     0,     0,    14,    15,     0,     0,     0,
+       0,    16,   190,    17,     0,    18,     0,     0,    19,     0,
+      20,     0,     0,     0,    21,    22,    23,    24,     1,     0,
+       2,     3,     4,     5,     6,     7,     0,     8,     0,     9,
+      10,    11,    12,     0,     0,    13,     0,     0,     0,     0,
+       0,    14,    15,     0,     0,     0,     0,    16,     0,    17,
+       0,    18,     0,     0,    19,     0,    20,     0,     0,     4,
+      21,    22,    23,    24,     8,     0,     9,    10,    11,    12,
+       0,     0,    13,    76,    77,    78,    79,    80,    14,    15,
+       0,     0,   -71,   -71,   -71,   -71,    17,     8,    18,     9,
+      10,    11,    12,    20,     0,    13,     0,    21,    22,    23,
+      24,    14,    15,     0,     0,     0,     0,    62,     0,    17,
+      63,    18,     0,     0,     0,     0,    20,     0,     0,     0,
+      21,    22,    23,    24,     8,     0,     9,    10,    11,    12,
+       0,     0,    13,     0,     0,     0,     0,     0,    14,    15,
+       0,     0,     0,     0,     0,     0,    17,     0,    18,     0,
+       0,    49,     0,    20,     0,     0,     0,    21,    22,    23,
+      24,     8,     0,     9,    10,    11,    12,     0,     0,    13,
+       0,     0,     0,     0,     0,    14,    15,     0,     0,     0,
+       0,     0,     0,    17,     0,    18,   133,     0,     0,     0,
+      20,     0,     0,     0,    21,    22,    23,    24,     8,     0,
+       9,    10,    11,    12,     0,     0,    13,     0,     0,     0,
+       0,     0,    14,    15,     0,     0,     0,     0,     0,     0,
+      17,     0,    18,   138,     0,     0,     0,    20,     0,     0,
+       0,    21,    22,    23,    24,     8,     0,     9,    10,    11,
+      12,     0,     0,    13,     0,     0,     0,     0,     0,    14,
+      15,     0,     0,     0,     0,     0,     0,    17,     0,    18,
+       0,     0,     0,     0,    20,    73,     0,    74,    21,    22,
+      23,    24,    75,    76,    77,    78,    79,    80,     0,    81,
+       0,     0,    82,    83,    84,    85,     0,    73,     0,    74,
+       0,     0,     0,   107,    75,    76,    77,    78,    79,    80,
+       0,    81,     0,     0,    82,    83,    84,    85,     0,    73,
+       0,    74,     0,     0,     0,   189,    75,    76,    77,    78,
+      79,    80,     0,    81,     0,     0,    82,    83,    84,    85,
+      73,     0,    74,     0,     0,     0,   153,    75,    76,    77,
+      78,    79,    80,     0,    81,     0,     0,    82,    83,    84,
+      85,    73,     0,    74,     0,     0,   116,     0,    75,    76,
+      77,    78,    79,    80,     0,    81,     0,     0,    82,    83,
+      84,    85,    73,     0,    74,     0,     0,   149,     0,    75,
+      76,    77,    78,    79,    80,     0,    81,     0,     0,    82,
+      83,    84,    85,    73,     0,    74,     0,     0,   167,     0,
+      75,    76,    77,    78,    79,    80,     0,    81,     0,     0,
+      82,    83,    84,    85,    73,     0,    74,   157,     0,     0,
+       0,    75,    76,    77,    78,    79,    80,     0,    81,     0,
+       0,    82,    83,    84,    85,    73,     0,    74,   160,     0,
+       0,     0,    75,    76,    77,    78,    79,    80,     0,    81,
+       0,     0,    82,    83,    84,    85,    73,   181,    74,     0,
+       0,     0,     0,    75,    76,    77,    78,    79,    80,     0,
+      81,    73,     0,    82,    83,    84,    85,     0,    75,    76,
+      77,    78,    79,    80,     0,    81,     0,     0,    82,    83,
+      84,    85,    75,    76,    77,    78,    79,    80,     0,    81,
+       0,     0,    82,    83,    84,    85,   -71,    76,    77,    78,
+      79,    80,     0,   -71,     0,     0,    82,    83,    84,    85
+};
+
+static const yytype_int16 yycheck[] =
+{
+       5,    60,    46,     8,    26,    35,    35,    18,    13,   169,
+      40,    40,    17,    18,    39,    40,    37,    39,    37,    40,
+       3,    40,     5,     6,     7,     8,     9,    10,   188,    12,
+      36,    14,    15,    16,    17,    37,    37,    20,    40,    40,
+      45,    46,    36,    26,    27,    56,    39,    91,    48,    32,
+      33,    34,    37,    36,    98,    40,    39,    62,    41,    39,
+     104,    14,    45,    46,    47,    48,    14,    15,    73,    74,
+      75,    76,    77,    78,    79,    80,    81,    82,    83,    84,
+      85,    37,    87,    36,    40,    90,    91,   109,    41,    21,
+      22,    23,    97,    98,    34,    48,    36,   102,    34,   104,
+      36,    48,    42,    43,    14,    15,    42,    33,   113,    48,
+       0,    36,   156,     7,    33,   159,    37,   176,    11,    48,
+      13,    48,   144,    36,   146,    18,    19,    20,    21,    22,
+      23,    48,    25,     4,    37,    28,    29,    30,    31,    36,
+      24,    32,    26,    27,    36,    32,    39,    48,   153,    48,
+      34,   156,    36,   115,   159,   150,    -1,   179,    42,    43,
+      -1,    -1,    -1,    -1,   186,   170,     3,    -1,     5,     6,
+       7,     8,     9,    10,    -1,    12,    -1,    14,    15,    16,
+      17,    -1,    -1,    20,    -1,    -1,    -1,    -1,    -1,    26,
+      27,    -1,    -1,    -1,    -1,    32,    33,    34,    -1,    36,
+      -1,    -1,    39,    -1,    41,    -1,    -1,    -1,    45,    46,
+      47,    48,     3,    -1,     5,     6,     7,     8,     9,    10,
+      -1,    12,    -1,    14,    15,    16,    17,    -1,    -1,    20,
+      -1,    -1,    -1,    -1,    -1,    26,    27,    -1,    -1,    -1,
+      -1,    32,    33,    34,    -1,    36,    -1,    -1,    39,    -1,
+      41,    -1,    -1,    -1,    45,    46,    47,    48,     3,    -1,
+       5,     6,     7,     8,     9,    10,    -1,    12,    -1,    14,
+      15,    16,    17,    -1,    -1,    20,    -1,    -1,    -1,    -1,
+      -1,    26,    27,    -1,    -1,    -1,    -1,    32,    -1,    34,
+      -1,    36,    -1,    -1,    39,    -1,    41,    -1,    -1,     7,
+      45,    46,    47,    48,    12,    -1,    14,    15,    16,    17,
+      -1,    -1,    20,    19,    20,    21,    22,    23,    26,    27,
+      -1,    -1,    28,    29,    30,    31,    34,    12,    36,    14,
+      15,    16,    17,    41,    -1,    20,    -1,    45,    46,    47,
+      48,    26,    27,    -1,    -1,    -1,    -1,    32,    -1,    34,
+      35,    36,    -1,    -1,    -1,    -1,    41,    -1,    -1,    -1,
+      45,    46,    47,    48,    12,    -1,    14,    15,    16,    17,
+      -1,    -1,    20,    -1,    -1,    -1,    -1,    -1,    26,    27,
+      -1,    -1,    -1,    -1,    -1,    -1,    34,    -1,    36,    -1,
+      -1,    39,    -1,    41,    -1,    -1,    -1,    45,    46,    47,
+      48,    12,    -1,    14,    15,    16,    17,    -1,    -1,    20,
+      -1,    -1,    -1,    -1,    -1,    26,    27,    -1,    -1,    -1,
+      -1,    -1,    -1,    34,    -1,    36,    37,    -1,    -1,    -1,
+      41,    -1,    -1,    -1,    45,    46,    47,    48,    12,    -1,
+      14,    15,    16,    17,    -1,    -1,    20,    -1,    -1,    -1,
+      -1,    -1,    26,    27,    -1,    -1,    -1,    -1,    -1,    -1,
+      34,    -1,    36,    37,    -1,    -1,    -1,    41,    -1,    -1,
+      -1,    45,    46,    47,    48,    12,    -1,    14,    15,    16,
+      17,    -1,    -1,    20,    -1,    -1,    -1,    -1,    -1,    26,
+      27,    -1,    -1,    -1,    -1,    -1,    -1,    34,    -1,    36,
+      -1,    -1,    -1,    -1,    41,    11,    -1,    13,    45,    46,
+      47,    48,    18,    19,    20,    21,    22,    23,    -1,    25,
+      -1,    -1,    28,    29,    30,    31,    -1,    11,    -1,    13,
+      -1,    -1,    -1,    39,    18,    19,    20,    21,    22,    23,
+      -1,    25,    -1,    -1,    28,    29,    30,    31,    -1,    11,
+      -1,    13,    -1,    -1,    -1,    39,    18,    19,    20,    21,
+      22,    23,    -1,    25,    -1,    -1,    28,    29,    30,    31,
+      11,    -1,    13,    -1,    -1,    -1,    38,    18,    19,    20,
+      21,    22,    23,    -1,    25,    -1,    -1,    28,    29,    30,
+      31,    11,    -1,    13,    -1,    -1,    37,    -1,    18,    19,
+      20,    21,    22,    23,    -1,    25,    -1,    -1,    28,    29,
+      30,    31,    11,    -1,    13,    -1,    -1,    37,    -1,    18,
+      19,    20,    21,    22,    23,    -1,    25,    -1,    -1,    28,
+      29,    30,    31,    11,    -1,    13,    -1,    -1,    37,    -1,
+      18,    19,    20,    21,    22,    23,    -1,    25,    -1,    -1,
+      28,    29,    30,    31,    11,    -1,    13,    35,    -1,    -1,
+      -1,    18,    19,    20,    21,    22,    23,    -1,    25,    -1,
+      -1,    28,    29,    30,    31,    11,    -1,    13,    35,    -1,
+      -1,    -1,    18,    19,    20,    21,    22,    23,    -1,    25,
+      -1,    -1,    28,    29,    30,    31,    11,    33,    13,    -1,
+      -1,    -1,    -1,    18,    19,    20,    21,    22,    23,    -1,
+      25,    11,    -1,    28,    29,    30,    31,    -1,    18,    19,
+      20,    21,    22,    23,    -1,    25,    -1,    -1,    28,    29,
+      30,    31,    18,    19,    20,    21,    22,    23,    -1,    25,
+      -1,    -1,    28,    29,    30,    31,    18,    19,    20,    21,
+      22,    23,    -1,    25,    -1,    -1,    28,    29,    30,    31
+};
+
+/* YYSTOS[STATE-NUM] -- The symbol kind of the accessing symbol of
+   state STATE-NUM.  */
+static const yytype_int8 yystos[] =
+{
+       0,     3,     5,     6,     7,     8,     9,    10,    12,    14,
+      15,    16,    17,    20,    26,    27,    32,    34,    36,    39,
+      41,    45,    46,    47,    48,    51,    52,    53,    54,    55,
+      56,    57,    58,    63,    66,    72,    75,    77,    79,    80,
+      85,    86,    88,    89,    92,    36,    36,    48,    71,    39,
+      54,    39,    39,    54,    48,    54,    36,    56,    58,    56,
+      67,    68,    32,    35,    54,    62,    64,    65,    54,    75,
+      48,     0,    53,    11,    13,    18,    19,    20,    21,    22,
+      23,    25,    28,    29,    30,    31,    39,    24,    26,    27,
+      34,    36,    42,    43,    59,    60,    61,    34,    36,    42,
+      91,    53,    36,    87,    90,    54,    62,    39,    75,    52,
+      33,    54,    35,    40,    35,    40,    37,    37,    54,    54,
+      54,    54,    54,    54,    54,    54,    54,    54,    54,    54,
+      54,    54,    54,    37,    62,    48,    48,    54,    37,    62,
+      48,    36,    73,     4,    81,    54,    82,    84,    62,    37,
+      39,    37,    33,    38,    54,    65,    36,    35,    37,    36,
+      35,    37,    48,    78,    69,    74,    53,    37,    53,    37,
+      91,    54,    62,    62,    37,    40,    32,    76,    83,    90,
+      54,    33,    37,    37,    48,    33,    52,    70,    53,    39,
+      33,    90
+};
+
+/* YYR1[RULE-NUM] -- Symbol kind of the left-hand side of rule RULE-NUM.  */
+static const yytype_int8 yyr1[] =
+{
+       0,    50,    51,    51,    52,    52,    53,    53,    53,    53,
+      53,    53,    53,    53,    53,    53,    54,    54,    54,    54,
+      54,    54,    54,    54,    54,    54,    54,    54,    54,    54,
+      54,    54,    54,    54,    54,    54,    54,    54,    55,    55,
+      55,    55,    55,    56,    56,    56,    56,    57,    57,    57,
+      57,    58,    58,    58,    58,    59,    59,    60,    60,    61,
+      62,    62,    63,    63,    63,    64,    64,    65,    67,    66,
+      68,    66,    69,    70,    71,    71,    72,    73,    74,    75,
+      76,    76,    77,    77,    77,    77,    77,    77,    78,    78,
+      78,    79,    79,    80,    81,    82,    83,    84,    85,    86,
+      87,    88,    89,    90,    91,    92,    92
+};
+
+/* YYR2[RULE-NUM] -- Number of symbols on the right-hand side of rule RULE-NUM.  */
+static const yytype_int8 yyr2[] =
+{
+       0,     2,     1,     0,     1,     2,     2,     1,     1,     1,
+       1,     2,     2,     1,     1,     1,     3,     3,     3,     3,
+       3,     3,     3,     3,     3,     3,     3,     3,     3,     3,
+       3,     2,     2,     2,     2,     2,     2,     1,     1,     1,
+       1,     3,     1,     1,     2,     2,     1,     3,     4,     3,
+       4,     4,     3,     2,     6,     1,     1,     3,     2,     5,
+       1,     3,     3,     3,     2,     1,     3,     5,     0,     4,
+       0,     3,     0,     0,     1,     0,     2,     3,     3,     4,
+       3,     2,     1,     1,     1,     1,     1,     1,     1,     3,
+       0,     2,     4,     4,     1,     0,     0,     3,     3,     1,
+       3,     7,     7,     0,     0,     3,     2
+};
+
+
+enum { YYENOMEM = -2 };
+
+#define yyerrok         (yyerrstatus = 0)
+#define yyclearin       (yychar = YYEMPTY)
+
+#define YYACCEPT        goto yyacceptlab
+#define YYABORT         goto yyabortlab
+#define YYERROR         goto yyerrorlab
+#define YYNOMEM         goto yyexhaustedlab
+
+
+#define YYRECOVERING()  (!!yyerrstatus)
+
+#define YYBACKUP(Token, Value)                                    \
+  do                                                              \
+    if (yychar == YYEMPTY)                                        \
+      {                                                           \
+        yychar = (Token);                                         \
+        yylval = (Value);                                         \
+        YYPOPSTACK (yylen);                                       \
+        yystate = *yyssp;                                         \
+        goto yybackup;                                            \
+      }                                                           \
+    else                                                          \
+      {                                                           \
+        yyerror (YY_("syntax error: cannot back up")); \
+        YYERROR;                                                  \
+      }                                                           \
+  while (0)
+
+/* Backward compatibility with an undocumented macro.
+   Use YYerror or YYUNDEF. */
+#define YYERRCODE YYUNDEF
+
+
+/* Enable debugging if requested.  */
+#if YYDEBUG
+
+# ifndef YYFPRINTF
+#  include <stdio.h> /* INFRINGES ON USER NAME SPACE */
+#  define YYFPRINTF fprintf
+# endif
+
+# define YYDPRINTF(Args)                        \
+do {                                            \
+  if (yydebug)                                  \
+    YYFPRINTF Args;                             \
+} while (0)
+
+
+
+
+# define YY_SYMBOL_PRINT(Title, Kind, Value, Location)                    \
+do {                                                                      \
+  if (yydebug)                                                            \
+    {                                                                     \
+      YYFPRINTF (stderr, "%s ", Title);                                   \
+      yy_symbol_print (stderr,                                            \
+                  Kind, Value); \
+      YYFPRINTF (stderr, "\n");                                           \
+    }                                                                     \
+} while (0)
+
+
+/*-----------------------------------.
+| Print this symbol's value on YYO.  |
+`-----------------------------------*/
+
+static void
+yy_symbol_value_print (FILE *yyo,
+                       yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep)
+{
+  FILE *yyoutput = yyo;
+  YY_USE (yyoutput);
+  if (!yyvaluep)
+    return;
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  YY_USE (yykind);
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
+}
+
+
+/*---------------------------.
+| Print this symbol on YYO.  |
+`---------------------------*/
+
+static void
+yy_symbol_print (FILE *yyo,
+                 yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep)
+{
+  YYFPRINTF (yyo, "%s %s (",
+             yykind < YYNTOKENS ? "token" : "nterm", yysymbol_name (yykind));
+
+  yy_symbol_value_print (yyo, yykind, yyvaluep);
+  YYFPRINTF (yyo, ")");
+}
+
+/*------------------------------------------------------------------.
+| yy_stack_print -- Print the state stack from its BOTTOM up to its |
+| TOP (included).                                                   |
+`------------------------------------------------------------------*/
+
+static void
+yy_stack_print (yy_state_t *yybottom, yy_state_t *yytop)
+{
+  YYFPRINTF (stderr, "Stack now");
+  for (; yybottom <= yytop; yybottom++)
+    {
+      int yybot = *yybottom;
+      YYFPRINTF (stderr, " %d", yybot);
+    }
+  YYFPRINTF (stderr, "\n");
+}
+
+# define YY_STACK_PRINT(Bottom, Top)                            \
+do {                                                            \
+  if (yydebug)                                                  \
+    yy_stack_print ((Bottom), (Top));                           \
+} while (0)
+
+
+/*------------------------------------------------.
+| Report that the YYRULE is going to be reduced.  |
+`------------------------------------------------*/
+
+static void
+yy_reduce_print (yy_state_t *yyssp, YYSTYPE *yyvsp,
+                 int yyrule)
+{
+  int yylno = yyrline[yyrule];
+  int yynrhs = yyr2[yyrule];
+  int yyi;
+  YYFPRINTF (stderr, "Reducing stack by rule %d (line %d):\n",
+             yyrule - 1, yylno);
+  /* The symbols being reduced.  */
+  for (yyi = 0; yyi < yynrhs; yyi++)
+    {
+      YYFPRINTF (stderr, "   $%d = ", yyi + 1);
+      yy_symbol_print (stderr,
+                       YY_ACCESSING_SYMBOL (+yyssp[yyi + 1 - yynrhs]),
+                       &yyvsp[(yyi + 1) - (yynrhs)]);
+      YYFPRINTF (stderr, "\n");
+    }
+}
+
+# define YY_REDUCE_PRINT(Rule)          \
+do {                                    \
+  if (yydebug)                          \
+    yy_reduce_print (yyssp, yyvsp, Rule); \
+} while (0)
+
+/* Nonzero means print parse trace.  It is left uninitialized so that
+   multiple parsers can coexist.  */
+int yydebug;
+#else /* !YYDEBUG */
+# define YYDPRINTF(Args) ((void) 0)
+# define YY_SYMBOL_PRINT(Title, Kind, Value, Location)
+# define YY_STACK_PRINT(Bottom, Top)
+# define YY_REDUCE_PRINT(Rule)
+#endif /* !YYDEBUG */
+
+
+/* YYINITDEPTH -- initial size of the parser's stacks.  */
+#ifndef YYINITDEPTH
+# define YYINITDEPTH 200
+#endif
+
+/* YYMAXDEPTH -- maximum size the stacks can grow to (effective only
+   if the built-in stack extension method is used).
+
+   Do not make this value too large; the results are undefined if
+   YYSTACK_ALLOC_MAXIMUM < YYSTACK_BYTES (YYMAXDEPTH)
+   evaluated with infinite-precision integer arithmetic.  */
+
+#ifndef YYMAXDEPTH
+# define YYMAXDEPTH 10000
+#endif
+
+
+
+
+
+
+/*-----------------------------------------------.
+| Release the memory associated to this symbol.  |
+`-----------------------------------------------*/
+
+static void
+yydestruct (const char *yymsg,
+            yysymbol_kind_t yykind, YYSTYPE *yyvaluep)
+{
+  YY_USE (yyvaluep);
+  if (!yymsg)
+    yymsg = "Deleting";
+  YY_SYMBOL_PRINT (yymsg, yykind, yyvaluep, yylocationp);
+
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  YY_USE (yykind);
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
+}
+
+
+/* Lookahead token kind.  */
+int yychar;
+
+/* The semantic value of the lookahead symbol.  */
+YYSTYPE yylval;
+/* Number of syntax errors so far.  */
+int yynerrs;
+
+
+
+
+/*----------.
+| yyparse.  |
+`----------*/
+
+int
+yyparse (void)
+{
+    yy_state_fast_t yystate = 0;
+    /* Number of tokens to shift before error messages enabled.  */
+    int yyerrstatus = 0;
+
+    /* Refer to the stacks through separate pointers, to allow yyoverflow
+       to reallocate them elsewhere.  */
+
+    /* Their size.  */
+    YYPTRDIFF_T yystacksize = YYINITDEPTH;
+
+    /* The state stack: array, bottom, top.  */
+    yy_state_t yyssa[YYINITDEPTH];
+    yy_state_t *yyss = yyssa;
+    yy_state_t *yyssp = yyss;
+
+    /* The semantic value stack: array, bottom, top.  */
+    YYSTYPE yyvsa[YYINITDEPTH];
+    YYSTYPE *yyvs = yyvsa;
+    YYSTYPE *yyvsp = yyvs;
+
+  int yyn;
+  /* The return value of yyparse.  */
+  int yyresult;
+  /* Lookahead symbol kind.  */
+  yysymbol_kind_t yytoken = YYSYMBOL_YYEMPTY;
+  /* The variables used to return semantic value and location from the
+     action routines.  */
+  YYSTYPE yyval;
+
+
+
+#define YYPOPSTACK(N)   (yyvsp -= (N), yyssp -= (N))
+
+  /* The number of symbols on the RHS of the reduced rule.
+     Keep to zero when no symbol should be popped.  */
+  int yylen = 0;
+
+  YYDPRINTF ((stderr, "Starting parse\n"));
+
+  yychar = YYEMPTY; /* Cause a token to be read.  */
+
+  goto yysetstate;
+
+
+/*------------------------------------------------------------.
+| yynewstate -- push a new state, which is found in yystate.  |
+`------------------------------------------------------------*/
+yynewstate:
+  /* In all cases, when you get here, the value and location stacks
+     have just been pushed.  So pushing a state here evens the stacks.  */
+  yyssp++;
+
+
+/*--------------------------------------------------------------------.
+| yysetstate -- set current state (the top of the stack) to yystate.  |
+`--------------------------------------------------------------------*/
+yysetstate:
+  YYDPRINTF ((stderr, "Entering state %d\n", yystate));
+  YY_ASSERT (0 <= yystate && yystate < YYNSTATES);
+  YY_IGNORE_USELESS_CAST_BEGIN
+  *yyssp = YY_CAST (yy_state_t, yystate);
+  YY_IGNORE_USELESS_CAST_END
+  YY_STACK_PRINT (yyss, yyssp);
+
+  if (yyss + yystacksize - 1 <= yyssp)
+#if !defined yyoverflow && !defined YYSTACK_RELOCATE
+    YYNOMEM;
+#else
+    {
+      /* Get the current used size of the three stacks, in elements.  */
+      YYPTRDIFF_T yysize = yyssp - yyss + 1;
+
+# if defined yyoverflow
+      {
+        /* Give user a chance to reallocate the stack.  Use copies of
+           these so that the &'s don't force the real ones into
+           memory.  */
+        yy_state_t *yyss1 = yyss;
+        YYSTYPE *yyvs1 = yyvs;
+
+        /* Each stack pointer address is followed by the size of the
+           data in use in that stack, in bytes.  This used to be a
+           conditional around just the two extra args, but that might
+           be undefined if yyoverflow is a macro.  */
+        yyoverflow (YY_("memory exhausted"),
+                    &yyss1, yysize * YYSIZEOF (*yyssp),
+                    &yyvs1, yysize * YYSIZEOF (*yyvsp),
+                    &yystacksize);
+        yyss = yyss1;
+        yyvs = yyvs1;
+      }
+# else /* defined YYSTACK_RELOCATE */
+      /* Extend the stack our own way.  */
+      if (YYMAXDEPTH <= yystacksize)
+        YYNOMEM;
+      yystacksize *= 2;
+      if (YYMAXDEPTH < yystacksize)
+        yystacksize = YYMAXDEPTH;
+
+      {
+        yy_state_t *yyss1 = yyss;
+        union yyalloc *yyptr =
+          YY_CAST (union yyalloc *,
+                   YYSTACK_ALLOC (YY_CAST (YYSIZE_T, YYSTACK_BYTES (yystacksize))));
+        if (! yyptr)
+          YYNOMEM;
+        YYSTACK_RELOCATE (yyss_alloc, yyss);
+        YYSTACK_RELOCATE (yyvs_alloc, yyvs);
+#  undef YYSTACK_RELOCATE
+        if (yyss1 != yyssa)
+          YYSTACK_FREE (yyss1);
+      }
+# endif
+
+      yyssp = yyss + yysize - 1;
+      yyvsp = yyvs + yysize - 1;
+
+      YY_IGNORE_USELESS_CAST_BEGIN
+      YYDPRINTF ((stderr, "Stack size increased to %ld\n",
+                  YY_CAST (long, yystacksize)));
+      YY_IGNORE_USELESS_CAST_END
+
+      if (yyss + yystacksize - 1 <= yyssp)
+        YYABORT;
+    }
+#endif /* !defined yyoverflow && !defined YYSTACK_RELOCATE */
+
+
+  if (yystate == YYFINAL)
+    YYACCEPT;
+
+  goto yybackup;
+
+
+/*-----------.
+| yybackup.  |
+`-----------*/
+yybackup:
+  /* Do appropriate processing given the current state.  Read a
+     lookahead token if we need one and don't already have one.  */
+
+  /* First try to decide what to do without reference to lookahead token.  */
+  yyn = yypact[yystate];
+  if (yypact_value_is_default (yyn))
+    goto yydefault;
+
+  /* Not known => get a lookahead token if don't already have one.  */
+
+  /* YYCHAR is either empty, or end-of-input, or a valid lookahead.  */
+  if (yychar == YYEMPTY)
+    {
+      YYDPRINTF ((stderr, "Reading a token\n"));
+      yychar = yylex ();
+    }
+
+  if (yychar <= YYEOF)
+    {
+      yychar = YYEOF;
+      yytoken = YYSYMBOL_YYEOF;
+      YYDPRINTF ((stderr, "Now at end of input.\n"));
+    }
+  else if (yychar == YYerror)
+    {
+      /* The scanner already issued an error message, process directly
+         to error recovery.  But do not keep the error token as
+         lookahead, it is too special and may lead us to an endless
+         loop in error recovery. */
+      yychar = YYUNDEF;
+      yytoken = YYSYMBOL_YYerror;
+      goto yyerrlab1;
+    }
+  else
+    {
+      yytoken = YYTRANSLATE (yychar);
+      YY_SYMBOL_PRINT ("Next token is", yytoken, &yylval, &yylloc);
+    }
+
+  /* If the proper action on seeing token YYTOKEN is to reduce or to
+     detect an error, take that action.  */
+  yyn += yytoken;
+  if (yyn < 0 || YYLAST < yyn || yycheck[yyn] != yytoken)
+    goto yydefault;
+  yyn = yytable[yyn];
+  if (yyn <= 0)
+    {
+      if (yytable_value_is_error (yyn))
+        goto yyerrlab;
+      yyn = -yyn;
+      goto yyreduce;
+    }
+
+  /* Count tokens shifted since error; after three, turn off error
+     status.  */
+  if (yyerrstatus)
+    yyerrstatus--;
+
+  /* Shift the lookahead token.  */
+  YY_SYMBOL_PRINT ("Shifting", yytoken, &yylval, &yylloc);
+  yystate = yyn;
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  *++yyvsp = yylval;
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
+
+  /* Discard the shifted token.  */
+  yychar = YYEMPTY;
+  goto yynewstate;
+
+
+/*-----------------------------------------------------------.
+| yydefault -- do the default action for the current state.  |
+`-----------------------------------------------------------*/
+yydefault:
+  yyn = yydefact[yystate];
+  if (yyn == 0)
+    goto yyerrlab;
+  goto yyreduce;
+
+
+/*-----------------------------.
+| yyreduce -- do a reduction.  |
+`-----------------------------*/
+yyreduce:
+  /* yyn is the number of a rule to reduce with.  */
+  yylen = yyr2[yyn];
+
+  /* If YYLEN is nonzero, implement the default value of the action:
+     '$$ = $1'.
+
+     Otherwise, the following line sets YYVAL to garbage.
+     This behavior is undocumented and Bison
+     users should not rely upon it.  Assigning to YYVAL
+     unconditionally makes the parser a bit smaller, and it avoids a
+     GCC warning that YYVAL may be used uninitialized.  */
+  yyval = yyvsp[1-yylen];
+
+
+  YY_REDUCE_PRINT (yyn);
+  switch (yyn)
+    {
+  case 2: /* program: stmts  */
+#line 66 "parser.y"
+                            { printf("program\n"); }
+#line 1416 "parser.tab.c"
+    break;
+
+  case 3: /* program: %empty  */
+#line 67 "parser.y"
+                            { printf("empty program\n"); }
+#line 1422 "parser.tab.c"
+    break;
+
+  case 4: /* stmts: stmt  */
+#line 72 "parser.y"
+                            { (yyval.statementVal) = (yyvsp[0].statementVal); }
+#line 1428 "parser.tab.c"
+    break;
+
+  case 5: /* stmts: stmts stmt  */
+#line 73 "parser.y"
+                            { (yyval.statementVal) = parserUtil_handleStatement((yyvsp[-1].statementVal), (yyvsp[0].statementVal)); }
+#line 1434 "parser.tab.c"
+    break;
+
+  case 6: /* stmt: expr SEMICOLON  */
+#line 77 "parser.y"
+                                    { (yyval.statementVal) = parserUtil_handleGeneralStatement(); }
+#line 1440 "parser.tab.c"
+    break;
+
+  case 7: /* stmt: ifstmt  */
+#line 78 "parser.y"
+                                    { (yyval.statementVal) = (yyvsp[0].statementVal); }
+#line 1446 "parser.tab.c"
+    break;
+
+  case 8: /* stmt: whilestmt  */
+#line 79 "parser.y"
+                                    { (yyval.statementVal) = parserUtil_handleGeneralStatement(); }
+#line 1452 "parser.tab.c"
+    break;
+
+  case 9: /* stmt: forstmt  */
+#line 80 "parser.y"
+                                    { (yyval.statementVal) = parserUtil_handleGeneralStatement(); }
+#line 1458 "parser.tab.c"
+    break;
+
+  case 10: /* stmt: returnstmt  */
+#line 81 "parser.y"
+                                    { (yyval.statementVal) = parserUtil_handleGeneralStatement(); }
+#line 1464 "parser.tab.c"
+    break;
+
+  case 11: /* stmt: BREAK SEMICOLON  */
+#line 82 "parser.y"
+                                    { (yyval.statementVal) = parserUtil_handleBreak(yylineno); }
+#line 1470 "parser.tab.c"
+    break;
+
+  case 12: /* stmt: CONTINUE SEMICOLON  */
+#line 83 "parser.y"
+                                    { (yyval.statementVal) = parserUtil_handleContinue(yylineno);}
+#line 1476 "parser.tab.c"
+    break;
+
+  case 13: /* stmt: block  */
+#line 84 "parser.y"
+                                    { (yyval.statementVal) = (yyvsp[0].statementVal); }
+#line 1482 "parser.tab.c"
+    break;
+
+  case 14: /* stmt: funcdef  */
+#line 85 "parser.y"
+                                    { (yyval.statementVal) = parserUtil_handleGeneralStatement(); }
+#line 1488 "parser.tab.c"
+    break;
+
+  case 15: /* stmt: SEMICOLON  */
+#line 86 "parser.y"
+                                    { (yyval.statementVal) = parserUtil_handleGeneralStatement(); }
+#line 1494 "parser.tab.c"
+    break;
+
+  case 16: /* expr: lvalue ASSIGN expr  */
+#line 90 "parser.y"
+                                                        { (yyval.exprVal) = parserUtil_handleAssignExpr((yyvsp[-2].exprVal), (yyvsp[0].exprVal), yylineno); }
+#line 1500 "parser.tab.c"
+    break;
+
+  case 17: /* expr: expr PLUS expr  */
+#line 91 "parser.y"
+                                                        { (yyval.exprVal) = parserUtil_handleArithmeticExpr((yyvsp[-2].exprVal), (yyvsp[0].exprVal), add_op, yylineno); }
+#line 1506 "parser.tab.c"
+    break;
+
+  case 18: /* expr: expr MINUS expr  */
+#line 92 "parser.y"
+                                                        { (yyval.exprVal) = parserUtil_handleArithmeticExpr((yyvsp[-2].exprVal), (yyvsp[0].exprVal), sub_op, yylineno); }
+#line 1512 "parser.tab.c"
+    break;
+
+  case 19: /* expr: expr MULTIPLY expr  */
+#line 93 "parser.y"
+                                                        { (yyval.exprVal) = parserUtil_handleArithmeticExpr((yyvsp[-2].exprVal), (yyvsp[0].exprVal), mul_op, yylineno); }
+#line 1518 "parser.tab.c"
+    break;
+
+  case 20: /* expr: expr DIVIDE expr  */
+#line 94 "parser.y"
+                                                        { (yyval.exprVal) = parserUtil_handleArithmeticExpr((yyvsp[-2].exprVal), (yyvsp[0].exprVal), div_op, yylineno); }
+#line 1524 "parser.tab.c"
+    break;
+
+  case 21: /* expr: expr MODULO expr  */
+#line 95 "parser.y"
+                                                        { (yyval.exprVal) = parserUtil_handleArithmeticExpr((yyvsp[-2].exprVal), (yyvsp[0].exprVal), mod_op, yylineno); }
+#line 1530 "parser.tab.c"
+    break;
+
+  case 22: /* expr: expr GREATER expr  */
+#line 96 "parser.y"
+                                                        { (yyval.exprVal) = parserUtil_handleRelationalExpr((yyvsp[-2].exprVal), (yyvsp[0].exprVal), if_greater_op, yylineno); }
+#line 1536 "parser.tab.c"
+    break;
+
+  case 23: /* expr: expr GREATER_EQUAL expr  */
+#line 97 "parser.y"
+                                                        { (yyval.exprVal) = parserUtil_handleRelationalExpr((yyvsp[-2].exprVal), (yyvsp[0].exprVal), if_greatereq_op, yylineno); }
+#line 1542 "parser.tab.c"
+    break;
+
+  case 24: /* expr: expr LESS expr  */
+#line 98 "parser.y"
+                                                        { (yyval.exprVal) = parserUtil_handleRelationalExpr((yyvsp[-2].exprVal), (yyvsp[0].exprVal), if_less_op, yylineno); }
+#line 1548 "parser.tab.c"
+    break;
+
+  case 25: /* expr: expr LESS_EQUAL expr  */
+#line 99 "parser.y"
+                                                        { (yyval.exprVal) = parserUtil_handleRelationalExpr((yyvsp[-2].exprVal), (yyvsp[0].exprVal), if_lesseq_op, yylineno); }
+#line 1554 "parser.tab.c"
+    break;
+
+  case 26: /* expr: expr EQUAL expr  */
+#line 100 "parser.y"
+                                                        { (yyval.exprVal) = parserUtil_handleRelationalExpr((yyvsp[-2].exprVal), (yyvsp[0].exprVal), if_eq_op, yylineno);}
+#line 1560 "parser.tab.c"
+    break;
+
+  case 27: /* expr: expr NOT_EQUAL expr  */
+#line 101 "parser.y"
+                                                        { (yyval.exprVal) = parserUtil_handleRelationalExpr((yyvsp[-2].exprVal), (yyvsp[0].exprVal), if_noteq_op, yylineno); }
+#line 1566 "parser.tab.c"
+    break;
+
+  case 28: /* expr: expr AND expr  */
+#line 102 "parser.y"
+                                                        { (yyval.exprVal) = parserUtil_handleBooleanExpr((yyvsp[-2].exprVal), (yyvsp[0].exprVal), and_op, yylineno); }
+#line 1572 "parser.tab.c"
+    break;
+
+  case 29: /* expr: expr OR expr  */
+#line 103 "parser.y"
+                                                        { (yyval.exprVal) = parserUtil_handleBooleanExpr((yyvsp[-2].exprVal), (yyvsp[0].exprVal), or_op, yylineno); }
+#line 1578 "parser.tab.c"
+    break;
+
+  case 30: /* expr: LEFT_PARENTHESIS expr RIGHT_PARENTHESIS  */
+#line 104 "parser.y"
+                                                        { (yyval.exprVal) = (yyvsp[-1].exprVal); }
+#line 1584 "parser.tab.c"
+    break;
+
+  case 31: /* expr: MINUS expr  */
+#line 105 "parser.y"
+                                                        { (yyval.exprVal) = parserUtil_handleUminusExpr((yyvsp[0].exprVal), yylineno); }
+#line 1590 "parser.tab.c"
+    break;
+
+  case 32: /* expr: NOT expr  */
+#line 106 "parser.y"
+                                                        { (yyval.exprVal) = parserUtil_handleNotExpr((yyvsp[0].exprVal), yylineno); }
+#line 1596 "parser.tab.c"
+    break;
+
+  case 33: /* expr: PLUS_PLUS lvalue  */
+#line 107 "parser.y"
+                                                        { (yyval.exprVal) = parserUtil_handleIncrementLvalue((yyvsp[0].exprVal), yylineno); }
+#line 1602 "parser.tab.c"
+    break;
+
+  case 34: /* expr: lvalue PLUS_PLUS  */
+#line 108 "parser.y"
+                                                        { (yyval.exprVal) = parserUtil_handleLvalueIncrement((yyvsp[-1].exprVal), yylineno); }
+#line 1608 "parser.tab.c"
+    break;
+
+  case 35: /* expr: MINUS_MINUS lvalue  */
+#line 109 "parser.y"
+                                                        { (yyval.exprVal) = parserUtil_handleDecrementLvalue((yyvsp[0].exprVal), yylineno); }
+#line 1614 "parser.tab.c"
+    break;
+
+  case 36: /* expr: lvalue MINUS_MINUS  */
+#line 110 "parser.y"
+                                                        { (yyval.exprVal) = parserUtil_handleLvalueDecrement((yyvsp[-1].exprVal), yylineno); }
+#line 1620 "parser.tab.c"
+    break;
+
+  case 37: /* expr: primary  */
+#line 111 "parser.y"
+                                                        { (yyval.exprVal) = (yyvsp[0].exprVal); }
+#line 1626 "parser.tab.c"
+    break;
+
+  case 38: /* primary: lvalue  */
+#line 115 "parser.y"
+                                                        { (yyval.exprVal) = parserUtil_handlePrimary((yyvsp[0].exprVal), yylineno); }
+#line 1632 "parser.tab.c"
+    break;
+
+  case 39: /* primary: call  */
+#line 116 "parser.y"
+                                                        { (yyval.exprVal) = (yyvsp[0].exprVal); }
+#line 1638 "parser.tab.c"
+    break;
+
+  case 40: /* primary: objectdef  */
+#line 117 "parser.y"
+                                                        { (yyval.exprVal) = (yyvsp[0].exprVal); }
+#line 1644 "parser.tab.c"
+    break;
+
+  case 41: /* primary: LEFT_PARENTHESIS funcdef RIGHT_PARENTHESIS  */
+#line 118 "parser.y"
+                                                        { (yyval.exprVal) = parserUtil_handlePrimaryFuncdef((yyvsp[-1].symbol)); }
+#line 1650 "parser.tab.c"
+    break;
+
+  case 42: /* primary: const  */
+#line 119 "parser.y"
+                                                        { (yyval.exprVal) = (yyvsp[0].exprVal); }
+#line 1656 "parser.tab.c"
+    break;
+
+  case 43: /* lvalue: IDENTIFIER  */
+#line 123 "parser.y"
+                                        { (yyval.exprVal) = parserUtil_handleIdentifier((yyvsp[0].strVal), yylineno); }
+#line 1662 "parser.tab.c"
+    break;
+
+  case 44: /* lvalue: LOCAL IDENTIFIER  */
+#line 124 "parser.y"
+                                        { (yyval.exprVal) = parserUtil_handleLocalIdentifier((yyvsp[0].strVal), yylineno); }
+#line 1668 "parser.tab.c"
+    break;
+
+  case 45: /* lvalue: DOUBLE_COLON IDENTIFIER  */
+#line 125 "parser.y"
+                                        { (yyval.exprVal) = parserUtil_habdleGlobalLookup((yyvsp[0].strVal), yylineno); }
+#line 1674 "parser.tab.c"
+    break;
+
+  case 46: /* lvalue: member  */
+#line 126 "parser.y"
+                                        { (yyval.exprVal) = (yyvsp[0].exprVal); }
+#line 1680 "parser.tab.c"
+    break;
+
+  case 47: /* member: lvalue DOT IDENTIFIER  */
+#line 130 "parser.y"
+                                                                { (yyval.exprVal) = parserUtil_handleLvalueIdentifierTableItem((yyvsp[-2].exprVal), (yyvsp[0].strVal), yylineno); }
+#line 1686 "parser.tab.c"
+    break;
+
+  case 48: /* member: lvalue LEFT_SQUARE_BRACKET expr RIGHT_SQUARE_BRACKET  */
+#line 131 "parser.y"
+                                                                { (yyval.exprVal) = parserUtil_handleLvalueExprTableItem((yyvsp[-3].exprVal), (yyvsp[-1].exprVal), yylineno); }
+#line 1692 "parser.tab.c"
+    break;
+
+  case 49: /* member: call DOT IDENTIFIER  */
+#line 132 "parser.y"
+                                                                { (yyval.exprVal) = parserUtil_handleLvalueIdentifierTableItem((yyvsp[-2].exprVal), (yyvsp[0].strVal), yylineno); }
+#line 1698 "parser.tab.c"
+    break;
+
+  case 50: /* member: call LEFT_SQUARE_BRACKET expr RIGHT_SQUARE_BRACKET  */
+#line 133 "parser.y"
+                                                                { (yyval.exprVal) = parserUtil_handleLvalueExprTableItem((yyvsp[-3].exprVal), (yyvsp[-1].exprVal), yylineno); }
+#line 1704 "parser.tab.c"
+    break;
+
+  case 51: /* call: call LEFT_PARENTHESIS elist RIGHT_PARENTHESIS  */
+#line 137 "parser.y"
+                                                                                                { (yyval.exprVal) = parserUtil_handleCall((yyvsp[-3].exprVal), (yyvsp[-1].exprVal), yylineno); }
+#line 1710 "parser.tab.c"
+    break;
+
+  case 52: /* call: call LEFT_PARENTHESIS RIGHT_PARENTHESIS  */
+#line 138 "parser.y"
+                                                                                                { (yyval.exprVal) = parserUtil_handleCall((yyvsp[-2].exprVal), NULL, yylineno); }
+#line 1716 "parser.tab.c"
+    break;
+
+  case 53: /* call: lvalue callsuffix  */
+#line 139 "parser.y"
+                                                                                                { (yyval.exprVal) = parserUtil_handleCallSuffix((yyvsp[-1].exprVal), (yyvsp[0].callVal), yylineno); }
+#line 1722 "parser.tab.c"
+    break;
+
+  case 54: /* call: LEFT_PARENTHESIS funcdef RIGHT_PARENTHESIS LEFT_PARENTHESIS elist RIGHT_PARENTHESIS  */
+#line 140 "parser.y"
+                                                                                                { (yyval.exprVal) = parserUtil_handleCallFuncdef((yyvsp[-4].symbol), (yyvsp[-1].exprVal), yylineno); }
+#line 1728 "parser.tab.c"
+    break;
+
+  case 55: /* callsuffix: normcall  */
+#line 143 "parser.y"
+                          { (yyval.callVal) = (yyvsp[0].callVal); }
+#line 1734 "parser.tab.c"
+    break;
+
+  case 56: /* callsuffix: methodcall  */
+#line 143 "parser.y"
+                                                    { (yyval.callVal) = (yyvsp[0].callVal); }
+#line 1740 "parser.tab.c"
+    break;
+
+  case 57: /* normcall: LEFT_PARENTHESIS elist RIGHT_PARENTHESIS  */
+#line 144 "parser.y"
+                                                          { (yyval.callVal) = parserUtil_handleNormCall((yyvsp[-1].exprVal)); }
+#line 1746 "parser.tab.c"
+    break;
+
+  case 58: /* normcall: LEFT_PARENTHESIS RIGHT_PARENTHESIS  */
+#line 144 "parser.y"
+                                                                                                                                        { (yyval.callVal) = parserUtil_handleNormCall(NULL); }
+#line 1752 "parser.tab.c"
+    break;
+
+  case 59: /* methodcall: DOT_DOT IDENTIFIER LEFT_PARENTHESIS elist RIGHT_PARENTHESIS  */
+#line 145 "parser.y"
+                                                                                                                                        { (yyval.callVal) = parserUtil_handleMethodCall((yyvsp[-3].strVal), (yyvsp[-1].exprVal)); }
+#line 1758 "parser.tab.c"
+    break;
+
+  case 60: /* elist: expr  */
+#line 148 "parser.y"
+                                { (yyval.exprVal) = (yyvsp[0].exprVal); }
+#line 1764 "parser.tab.c"
+    break;
+
+  case 61: /* elist: elist COMMA expr  */
+#line 149 "parser.y"
+                                { (yyval.exprVal) = parserUtil_handleElist((yyvsp[-2].exprVal), (yyvsp[0].exprVal)); }
+#line 1770 "parser.tab.c"
+    break;
+
+  case 62: /* objectdef: LEFT_SQUARE_BRACKET elist RIGHT_SQUARE_BRACKET  */
+#line 153 "parser.y"
+                                                                { (yyval.exprVal) = parserUtil_handleMakeElistTable((yyvsp[-1].exprVal), yylineno); }
+#line 1776 "parser.tab.c"
+    break;
+
+  case 63: /* objectdef: LEFT_SQUARE_BRACKET indexed RIGHT_SQUARE_BRACKET  */
+#line 154 "parser.y"
+                                                                { (yyval.exprVal) = parserUtil_handleMakeIndexedTable((yyvsp[-1].indexedVal), yylineno); }
+#line 1782 "parser.tab.c"
+    break;
+
+  case 64: /* objectdef: LEFT_SQUARE_BRACKET RIGHT_SQUARE_BRACKET  */
+#line 155 "parser.y"
+                                                                { (yyval.exprVal) = parserUtil_handleMakeIndexedTable(NULL, yylineno); }
+#line 1788 "parser.tab.c"
+    break;
+
+  case 65: /* indexed: indexedelem  */
+#line 158 "parser.y"
+                                                                        { (yyval.indexedVal) = (yyvsp[0].indexedVal); }
+#line 1794 "parser.tab.c"
+    break;
+
+  case 66: /* indexed: indexed COMMA indexedelem  */
+#line 158 "parser.y"
+                                                                                                                 { (yyval.indexedVal) = parserUtil_handleIndexed((yyvsp[-2].indexedVal), (yyvsp[0].indexedVal)); }
+#line 1800 "parser.tab.c"
+    break;
+
+  case 67: /* indexedelem: LEFT_CURLY_BRACKET expr COLON expr RIGHT_CURLY_BRACKET  */
+#line 159 "parser.y"
+                                                                        { (yyval.indexedVal) = parserUtil_newIndexed((yyvsp[-3].exprVal), (yyvsp[-1].exprVal)); }
+#line 1806 "parser.tab.c"
+    break;
+
+  case 68: /* $@1: %empty  */
+#line 162 "parser.y"
+                                { parserUtil_handleBlockEntrance(); }
+#line 1812 "parser.tab.c"
+    break;
+
+  case 69: /* block: LEFT_CURLY_BRACKET $@1 stmts RIGHT_CURLY_BRACKET  */
+#line 164 "parser.y"
+                                { parserUtil_handleBlockExit(); (yyval.statementVal) = (yyvsp[-1].statementVal); }
+#line 1818 "parser.tab.c"
+    break;
+
+  case 70: /* $@2: %empty  */
+#line 165 "parser.y"
+                                { parserUtil_handleBlockEntrance(); }
+#line 1824 "parser.tab.c"
+    break;
+
+  case 71: /* block: LEFT_CURLY_BRACKET $@2 RIGHT_CURLY_BRACKET  */
+#line 166 "parser.y"
+                                { parserUtil_handleBlockExit(); (yyval.statementVal) = parserUtil_newStatement(); }
+#line 1830 "parser.tab.c"
+    break;
+
+  case 72: /* funcblockstart: %empty  */
+#line 169 "parser.y"
+                { parserUtil_handleFuncBlockStart(); }
+#line 1836 "parser.tab.c"
+    break;
+
+  case 73: /* funcblockend: %empty  */
+#line 170 "parser.y"
+                { parserUtil_handleFuncBlockEnd(); }
+#line 1842 "parser.tab.c"
+    break;
+
+  case 74: /* funcname: IDENTIFIER  */
+#line 172 "parser.y"
+                                                                { (yyval.strVal) = (yyvsp[0].strVal); }
+#line 1848 "parser.tab.c"
+    break;
+
+  case 75: /* funcname: %empty  */
+#line 172 "parser.y"
+                                                                                             { (yyval.strVal) = parserUtil_generateUnnamedFunctionName(); }
+#line 1854 "parser.tab.c"
+    break;
+
+  case 76: /* funcprefix: FUNCTION funcname  */
+#line 173 "parser.y"
+                                                                { (yyval.symbol) = parserUtil_handleFuncPrefix((yyvsp[0].strVal), yylineno); }
+#line 1860 "parser.tab.c"
+    break;
+
+  case 77: /* funcargs: LEFT_PARENTHESIS idlist RIGHT_PARENTHESIS  */
+#line 174 "parser.y"
+                                                                { parserUtil_handleFuncArgs(); }
+#line 1866 "parser.tab.c"
+    break;
+
+  case 78: /* funcbody: funcblockstart funcblock funcblockend  */
+#line 175 "parser.y"
+                                                                { (yyval.unsignedVal) = parserUtil_handleFuncbody(); }
+#line 1872 "parser.tab.c"
+    break;
+
+  case 79: /* funcdef: funcprefix M funcargs funcbody  */
+#line 176 "parser.y"
+                                                                { (yyval.symbol) = parserUtil_handleFuncdef((yyvsp[-3].symbol), (yyvsp[-2].unsignedVal), (yyvsp[0].unsignedVal), yylineno); }
+#line 1878 "parser.tab.c"
+    break;
+
+  case 82: /* const: INTEGER  */
+#line 180 "parser.y"
+                          { (yyval.exprVal) = parserUtil_newConstnumExpr((yyvsp[0].intVal) * 1.0); }
+#line 1884 "parser.tab.c"
+    break;
+
+  case 83: /* const: REAL  */
+#line 181 "parser.y"
+                          { (yyval.exprVal) = parserUtil_newConstnumExpr((yyvsp[0].realVal)); }
+#line 1890 "parser.tab.c"
+    break;
+
+  case 84: /* const: STRING  */
+#line 182 "parser.y"
+                          { (yyval.exprVal) = parserUtil_newConstString((yyvsp[0].strVal)); }
+#line 1896 "parser.tab.c"
+    break;
+
+  case 85: /* const: NIL  */
+#line 183 "parser.y"
+                          { (yyval.exprVal) = parserUtil_newConstNil(); }
+#line 1902 "parser.tab.c"
+    break;
+
+  case 86: /* const: TRUE  */
+#line 184 "parser.y"
+                          { (yyval.exprVal) = parserUtil_newBoolExpr(1); }
+#line 1908 "parser.tab.c"
+    break;
+
+  case 87: /* const: FALSE  */
+#line 185 "parser.y"
+                          { (yyval.exprVal) = parserUtil_newBoolExpr(0); }
+#line 1914 "parser.tab.c"
+    break;
+
+  case 88: /* idlist: IDENTIFIER  */
+#line 189 "parser.y"
+                                          { parserUtil_handleFormalArgument(yylval.strVal, yylineno); }
+#line 1920 "parser.tab.c"
+    break;
+
+  case 89: /* idlist: idlist COMMA IDENTIFIER  */
+#line 190 "parser.y"
+                                          { parserUtil_handleFormalArgument(yylval.strVal, yylineno); }
+#line 1926 "parser.tab.c"
+    break;
+
+  case 91: /* ifstmt: ifprefix stmt  */
+#line 195 "parser.y"
+                                                  { parserUtil_handleIfPrefixStatement((yyvsp[-1].unsignedVal)); (yyval.statementVal) = (yyvsp[0].statementVal); }
+#line 1932 "parser.tab.c"
+    break;
+
+  case 92: /* ifstmt: ifprefix stmt elseprefix stmt  */
+#line 196 "parser.y"
+                                                  { (yyval.statementVal) = parserUtil_handleIfElsePrefixStatement((yyvsp[-3].unsignedVal), (yyvsp[-2].statementVal), (yyvsp[-1].unsignedVal), (yyvsp[0].statementVal)); }
+#line 1938 "parser.tab.c"
+    break;
+
+  case 93: /* ifprefix: IF LEFT_PARENTHESIS expr RIGHT_PARENTHESIS  */
+#line 199 "parser.y"
+                                                                { (yyval.unsignedVal) = parserUtil_handleIfPrefix((yyvsp[-1].exprVal), yylineno);}
+#line 1944 "parser.tab.c"
+    break;
+
+  case 94: /* elseprefix: ELSE  */
+#line 200 "parser.y"
+                                                                { (yyval.unsignedVal) = parserUtil_handleElse(yylineno); }
+#line 1950 "parser.tab.c"
+    break;
+
+  case 95: /* loopstart: %empty  */
+#line 202 "parser.y"
+                                        { parserUtil_handleLoopStart(); }
+#line 1956 "parser.tab.c"
+    break;
+
+  case 96: /* loopend: %empty  */
+#line 203 "parser.y"
+                                        { parserUtil_handleLoopEnd(); }
+#line 1962 "parser.tab.c"
+    break;
+
+  case 97: /* loopstmt: loopstart stmt loopend  */
+#line 204 "parser.y"
+                                        {  (yyval.statementVal) = (yyvsp[-1].statementVal); }
+#line 1968 "parser.tab.c"
+    break;
+
+  case 98: /* whilestmt: whilestart whilecond loopstmt  */
+#line 206 "parser.y"
+                                                        { parserUtil_handleWhileStatement((yyvsp[-2].unsignedVal), (yyvsp[-1].unsignedVal), (yyvsp[0].statementVal), yylineno);}
+#line 1974 "parser.tab.c"
+    break;
+
+  case 99: /* whilestart: WHILE  */
+#line 207 "parser.y"
+                                                        { (yyval.unsignedVal) = parserUtil_handleWhileStart();}
+#line 1980 "parser.tab.c"
+    break;
+
+  case 100: /* whilecond: LEFT_PARENTHESIS expr RIGHT_PARENTHESIS  */
+#line 208 "parser.y"
+                                                        { (yyval.unsignedVal) = parserUtil_handleWhileCond((yyvsp[-1].exprVal), yylineno);}
+#line 1986 "parser.tab.c"
+    break;
+
+  case 101: /* forstmt: forprefix N elist RIGHT_PARENTHESIS N stmt N  */
+#line 211 "parser.y"
+                                                                        { parserUtil_handleForStatement((yyvsp[-6].forPrefixVal), (yyvsp[-5].unsignedVal), (yyvsp[-2].unsignedVal), (yyvsp[-1].statementVal), (yyvsp[0].unsignedVal)); }
+#line 1992 "parser.tab.c"
+    break;
+
+  case 102: /* forprefix: FOR LEFT_PARENTHESIS elist SEMICOLON M expr SEMICOLON  */
+#line 212 "parser.y"
+                                                                        { (yyval.forPrefixVal) = parserUtil_handleForPrefix((yyvsp[-2].unsignedVal), (yyvsp[-1].exprVal), yylineno);}
+#line 1998 "parser.tab.c"
+    break;
+
+  case 103: /* N: %empty  */
+#line 213 "parser.y"
+   { (yyval.unsignedVal) = parserUtil_handleNrule(yylineno); }
+#line 2004 "parser.tab.c"
+    break;
+
+  case 104: /* M: %empty  */
+#line 214 "parser.y"
+   { (yyval.unsignedVal) = parserUtil_handleMrule(yylineno); }
+#line 2010 "parser.tab.c"
+    break;
+
+  case 105: /* returnstmt: RETURN expr SEMICOLON  */
+#line 216 "parser.y"
+                                  { parserUtil_handleReturn((yyvsp[-1].exprVal), yylineno); }
+#line 2016 "parser.tab.c"
+    break;
+
+  case 106: /* returnstmt: RETURN SEMICOLON  */
+#line 217 "parser.y"
+                               { parserUtil_handleReturn(NULL, yylineno); }
+#line 2022 "parser.tab.c"
+    break;
+
+
+#line 2026 "parser.tab.c"
+
+      default: break;
+    }
+  /* User semantic actions sometimes alter yychar, and that requires
+     that yytoken be updated with the new translation.  We take the
+     approach of translating immediately before every use of yytoken.
+     One alternative is translating here after every semantic action,
+     but that translation would be missed if the semantic action invokes
+     YYABORT, YYACCEPT, or YYERROR immediately after altering yychar or
+     if it invokes YYBACKUP.  In the case of YYABORT or YYACCEPT, an
+     incorrect destructor might then be invoked immediately.  In the
+     case of YYERROR or YYBACKUP, subsequent parser actions might lead
+     to an incorrect destructor call or verbose syntax error message
+     before the lookahead is translated.  */
+  YY_SYMBOL_PRINT ("-> $$ =", YY_CAST (yysymbol_kind_t, yyr1[yyn]), &yyval, &yyloc);
+
+  YYPOPSTACK (yylen);
+  yylen = 0;
+
+  *++yyvsp = yyval;
+
+  /* Now 'shift' the result of the reduction.  Determine what state
+     that goes to, based on the state we popped back to and the rule
+     number reduced by.  */
+  {
+    const int yylhs = yyr1[yyn] - YYNTOKENS;
+    const int yyi = yypgoto[yylhs] + *yyssp;
+    yystate = (0 <= yyi && yyi <= YYLAST && yycheck[yyi] == *yyssp
+               ? yytable[yyi]
+               : yydefgoto[yylhs]);
+  }
+
+  goto yynewstate;
+
+
+/*--------------------------------------.
+| yyerrlab -- here on detecting error.  |
+`--------------------------------------*/
+yyerrlab:
+  /* Make sure we have latest lookahead translation.  See comments at
+     user semantic actions for why this is necessary.  */
+  yytoken = yychar == YYEMPTY ? YYSYMBOL_YYEMPTY : YYTRANSLATE (yychar);
+  /* If not already recovering from an error, report this error.  */
+  if (!yyerrstatus)
+    {
+      ++yynerrs;
+      yyerror (YY_("syntax error"));
+    }
+
+  if (yyerrstatus == 3)
+    {
+      /* If just tried and failed to reuse lookahead token after an
+         error, discard it.  */
+
+      if (yychar <= YYEOF)
+        {
+          /* Return failure if at end of input.  */
+          if (yychar == YYEOF)
+            YYABORT;
+        }
+      else
+        {
+          yydestruct ("Error: discarding",
+                      yytoken, &yylval);
+          yychar = YYEMPTY;
+        }
+    }
+
+  /* Else will try to reuse lookahead token after shifting the error
+     token.  */
+  goto yyerrlab1;
+
+
+/*---------------------------------------------------.
+| yyerrorlab -- error raised explicitly by YYERROR.  |
+`---------------------------------------------------*/
+yyerrorlab:
+  /* Pacify compilers when the user code never invokes YYERROR and the
+     label yyerrorlab therefore never appears in user code.  */
+  if (0)
+    YYERROR;
+  ++yynerrs;
+
+  /* Do not reclaim the symbols of the rule whose action triggered
+     this YYERROR.  */
+  YYPOPSTACK (yylen);
+  yylen = 0;
+  YY_STACK_PRINT (yyss, yyssp);
+  yystate = *yyssp;
+  goto yyerrlab1;
+
+
+/*-------------------------------------------------------------.
+| yyerrlab1 -- common code for both syntax error and YYERROR.  |
+`-------------------------------------------------------------*/
+yyerrlab1:
+  yyerrstatus = 3;      /* Each real token shifted decrements this.  */
+
+  /* Pop stack until we find a state that shifts the error token.  */
+  for (;;)
+    {
+      yyn = yypact[yystate];
+      if (!yypact_value_is_default (yyn))
+        {
+          yyn += YYSYMBOL_YYerror;
+          if (0 <= yyn && yyn <= YYLAST && yycheck[yyn] == YYSYMBOL_YYerror)
+            {
+              yyn = yytable[yyn];
+              if (0 < yyn)
+                break;
+            }
+        }
+
+      /* Pop the current state because it cannot handle the error token.  */
+      if (yyssp == yyss)
+        YYABORT;
+
+
+      yydestruct ("Error: popping",
+                  YY_ACCESSING_SYMBOL (yystate), yyvsp);
+      YYPOPSTACK (1);
+      yystate = *yyssp;
+      YY_STACK_PRINT (yyss, yyssp);
+    }
+
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  *++yyvsp = yylval;
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
+
+
+  /* Shift the error token.  */
+  YY_SYMBOL_PRINT ("Shifting", YY_ACCESSING_SYMBOL (yyn), yyvsp, yylsp);
+
+  yystate = yyn;
+  goto yynewstate;
+
+
+/*-------------------------------------.
+| yyacceptlab -- YYACCEPT comes here.  |
+`-------------------------------------*/
+yyacceptlab:
+  yyresult = 0;
+  goto yyreturnlab;
+
+
+/*-----------------------------------.
+| yyabortlab -- YYABORT comes here.  |
+`-----------------------------------*/
+yyabortlab:
+  yyresult = 1;
+  goto yyreturnlab;
+
+
+/*-----------------------------------------------------------.
+| yyexhaustedlab -- YYNOMEM (memory exhaustion) comes here.  |
+`-----------------------------------------------------------*/
+yyexhaustedlab:
+  yyerror (YY_("memory exhausted"));
+  yyresult = 2;
+  goto yyreturnlab;
+
+
+/*----------------------------------------------------------.
+| yyreturnlab -- parsing is finished, clean up and return.  |
+`----------------------------------------------------------*/
+yyreturnlab:
+  if (yychar != YYEMPTY)
+    {
+      /* Make sure we have latest lookahead translation.  See comments at
+         user semantic actions for why this is necessary.  */
+      yytoken = YYTRANSLATE (yychar);
+      yydestruct ("Cleanup: discarding lookahead",
+                  yytoken, &yylval);
+    }
+  /* Do not reclaim the symbols of the rule whose action triggered
+     this YYABORT or YYACCEPT.  */
+  YYPOPSTACK (yylen);
+  YY_STACK_PRINT (yyss, yyssp);
+  while (yyssp != yyss)
+    {
+      yydestruct ("Cleanup: popping",
+                  YY_ACCESSING_SYMBOL (+*yyssp), yyvsp);
+      YYPOPSTACK (1);
+    }
+#ifndef yyoverflow
+  if (yyss != yyssa)
+    YYSTACK_FREE (yyss);
+#endif
+
+  return yyresult;
+}
+
+#line 221 "parser.y"
+
+
+int main(int argc, char **argv) {
+    if (argc > 1) {
+        if (!(yyin = fopen(argv[1], "r"))) {
+            printf("Cannot read file: %s\n", argv[1]);
+            return 1;
+        }
+    }
+    else {
+        yyin = stdin;
+    }
+
+    parserUtil_initialize();
+    yyparse();
+    parserUtil_finalize();
+    return 0;
+}
+
+int yyerror(char* errorMessage) {
+
+    fprintf(stderr, "Syntax error at line %d: %s\n", yylineno, errorMessage);
+    fprintf(stderr, "  Offending token: '%s'\n", yytext);
+
+    return 1;
+}
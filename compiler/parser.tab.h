@@ -0,0 +1,140 @@
+/* A Bison parser, made by GNU Bison 3.8.2.  */
+
+/* Bison interface for Yacc-like parsers in C
+
+   Copyright (C) 1984, 1989-1990, 2000-2015, 2018-2021 Free Software Foundation,
+   Inc.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.  */
+
+/* As a special exception, you may create a larger work that contains
+   part or all of the Bison parser skeleton and distribute that work
+   under terms of your choice, so long as that work isn't itself a
+   parser generator using the skeleton or a modified version thereof
+   as a parser skeleton.  Alternatively, if you modify or redistribute
+   the parser skeleton itself, you may (at your option) remove this
+   special exception, which will cause the skeleton and the resulting
+   Bison output files to be licensed under the GNU General Public
+   License without this special exception.
+
+   This special exception was added by the Free Software Foundation in
+   version 2.2 of Bison.  */
+
+/* DO NOT RELY ON FEATURES THAT ARE NOT DOCUMENTED in the manual,
+   especially those whose name start with YY_ or yy_.  They are
+   private implementation details that can be changed or removed.  */
+
+#ifndef YY_YY_PARSER_TAB_H_INCLUDED
+# define YY_YY_PARSER_TAB_H_INCLUDED
+/* Debug traces.  */
+#ifndef YYDEBUG
+# define YYDEBUG 0
+#endif
+#if YYDEBUG
+extern int yydebug;
+#endif
+
+/* Token kinds.  */
+#ifndef YYTOKENTYPE
+# define YYTOKENTYPE
+  enum yytokentype
+  {
+    YYEMPTY = -2,
+    YYEOF = 0,                     /* "end of file"  */
+    YYerror = 256,                 /* error  */
+    YYUNDEF = 257,                 /* "invalid token"  */
+    IF = 258,                      /* IF  */
+    ELSE = 259,                    /* ELSE  */
+    WHILE = 260,                   /* WHILE  */
+    FOR = 261,                     /* FOR  */
+    FUNCTION = 262,                /* FUNCTION  */
+    RETURN = 263,                  /* RETURN  */
+    BREAK = 264,                   /* BREAK  */
+    CONTINUE = 265,                /* CONTINUE  */
+    AND = 266,                     /* AND  */
+    NOT = 267,                     /* NOT  */
+    OR = 268,                      /* OR  */
+    LOCAL = 269,                   /* LOCAL  */
+    TRUE = 270,                    /* TRUE  */
+    FALSE = 271,                   /* FALSE  */
+    NIL = 272,                     /* NIL  */
+    EQUAL = 273,                   /* EQUAL  */
+    PLUS = 274,                    /* PLUS  */
+    MINUS = 275,                   /* MINUS  */
+    MULTIPLY = 276,                /* MULTIPLY  */
+    DIVIDE = 277,                  /* DIVIDE  */
+    MODULO = 278,                  /* MODULO  */
+    ASSIGN = 279,                  /* ASSIGN  */
+    NOT_EQUAL = 280,               /* NOT_EQUAL  */
+    PLUS_PLUS = 281,               /* PLUS_PLUS  */
+    MINUS_MINUS = 282,             /* MINUS_MINUS  */
+    GREATER = 283,                 /* GREATER  */
+    GREATER_EQUAL = 284,           /* GREATER_EQUAL  */
+    LESS = 285,                    /* LESS  */
+    LESS_EQUAL = 286,              /* LESS_EQUAL  */
+    LEFT_CURLY_BRACKET = 287,      /* LEFT_CURLY_BRACKET  */
+    RIGHT_CURLY_BRACKET = 288,     /* RIGHT_CURLY_BRACKET  */
+    LEFT_SQUARE_BRACKET = 289,     /* LEFT_SQUARE_BRACKET  */
+    RIGHT_SQUARE_BRACKET = 290,    /* RIGHT_SQUARE_BRACKET  */
+    LEFT_PARENTHESIS = 291,        /* LEFT_PARENTHESIS  */
+    RIGHT_PARENTHESIS = 292,       /* RIGHT_PARENTHESIS  */
+    COLON = 293,                   /* COLON  */
+    SEMICOLON = 294,               /* SEMICOLON  */
+    COMMA = 295,                   /* COMMA  */
+    DOUBLE_COLON = 296,            /* DOUBLE_COLON  */
+    DOT = 297,                     /* DOT  */
+    DOT_DOT = 298,                 /* DOT_DOT  */
+    COMMENT = 299,                 /* COMMENT  */
+    INTEGER = 300,                 /* INTEGER  */
+    REAL = 301,                    /* REAL  */
+    STRING = 302,                  /* STRING  */
+    IDENTIFIER = 303,              /* IDENTIFIER  */
+    UMINUS = 304                   /* UMINUS  */
+  };
+  typedef enum yytokentype yytoken_kind_t;
+#endif
+
+/* Value type.  */
+#if ! defined YYSTYPE && ! defined YYSTYPE_IS_DECLARED
+union YYSTYPE
+{
+#line 17 "parser.y"
+
+    int     intVal;
+    char*   strVal;
+    double  realVal;
+    unsigned unsignedVal;
+    SymbolTableEntry* symbol;
+    Expr* exprVal;
+    Call* callVal;
+    Indexed* indexedVal;
+    ForPrefix* forPrefixVal;
+    Statement* statementVal;
+
+#line 126 "parser.tab.h"
+
+};
+typedef union YYSTYPE YYSTYPE;
+# define YYSTYPE_IS_TRIVIAL 1
+# define YYSTYPE_IS_DECLARED 1
+#endif
+
+
+extern YYSTYPE yylval;
+
+
+int yyparse (void);
+
+
+#endif /* !YY_YY_PARSER_TAB_H_INCLUDED  */
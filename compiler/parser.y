@@ -4,6 +4,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 int yyerror(char* errorMessage);
 int yylex(void);
@@ -74,7 +75,7 @@ stmts:
         ;
 
 stmt:
-        expr SEMICOLON              { $$ = parserUtil_handleGeneralStatement(); }
+        expr SEMICOLON              { $$ = parserUtil_handleExprStatement($1); }
         | ifstmt                    { $$ = $1; }
         | whilestmt                 { $$ = parserUtil_handleGeneralStatement(); }
         | forstmt                   { $$ = parserUtil_handleGeneralStatement(); }
@@ -99,8 +100,10 @@ expr:
         | expr LESS_EQUAL expr                          { $$ = parserUtil_handleRelationalExpr($1, $3, if_lesseq_op, yylineno); }
         | expr EQUAL expr                               { $$ = parserUtil_handleRelationalExpr($1, $3, if_eq_op, yylineno);}
         | expr NOT_EQUAL expr                           { $$ = parserUtil_handleRelationalExpr($1, $3, if_noteq_op, yylineno); }
-        | expr AND expr                                 { $$ = parserUtil_handleBooleanExpr($1, $3, and_op, yylineno); }
-        | expr OR expr                                  { $$ = parserUtil_handleBooleanExpr($1, $3, or_op, yylineno); }
+        | expr AND { $<exprVal>$ = parserUtil_handleBooleanPrefix($1, and_op, yylineno); }
+          expr                                          { $$ = parserUtil_handleBooleanExpr($<exprVal>3, $4, and_op, yylineno); }
+        | expr OR { $<exprVal>$ = parserUtil_handleBooleanPrefix($1, or_op, yylineno); }
+          expr                                          { $$ = parserUtil_handleBooleanExpr($<exprVal>3, $4, or_op, yylineno); }
         | LEFT_PARENTHESIS expr RIGHT_PARENTHESIS       { $$ = $2; }
         | MINUS expr %prec UMINUS                       { $$ = parserUtil_handleUminusExpr($2, yylineno); }
         | NOT expr                                      { $$ = parserUtil_handleNotExpr($2, yylineno); }
@@ -145,8 +148,8 @@ normcall:        LEFT_PARENTHESIS elist RIGHT_PARENTHESIS { $$ = parserUtil_hand
 methodcall:      DOT_DOT IDENTIFIER LEFT_PARENTHESIS elist RIGHT_PARENTHESIS                                                            { $$ = parserUtil_handleMethodCall($2, $4); };
 
 elist:
-        expr                    { $$ = $1; }
-        | elist COMMA expr      { $$ = parserUtil_handleElist($1, $3); }
+        expr                    { $$ = parserUtil_handleExprValue($1, yylineno); }
+        | elist COMMA expr      { $$ = parserUtil_handleElist($1, parserUtil_handleExprValue($3, yylineno)); }
         ;
 
 objectdef:
@@ -156,7 +159,8 @@ objectdef:
             ;
 
 indexed:        indexedelem                                             { $$ = $1; } | indexed COMMA indexedelem { $$ = parserUtil_handleIndexed($1, $3); };
-indexedelem:    LEFT_CURLY_BRACKET expr COLON expr RIGHT_CURLY_BRACKET  { $$ = parserUtil_newIndexed($2, $4); };
+indexedelem:    LEFT_CURLY_BRACKET expr COLON { $<exprVal>$ = parserUtil_handleExprValue($2, yylineno); }
+                expr RIGHT_CURLY_BRACKET                                { $$ = parserUtil_newIndexed($<exprVal>4, $5, yylineno); };
 
 block:
         LEFT_CURLY_BRACKET      { parserUtil_handleBlockEntrance(); } 
@@ -221,9 +225,26 @@ returnstmt: RETURN expr SEMICOLON { parserUtil_handleReturn($2, yylineno); }
 %%
 
 int main(int argc, char **argv) {
-    if (argc > 1) {
-        if (!(yyin = fopen(argv[1], "r"))) {
-            printf("Cannot read file: %s\n", argv[1]);
+    char* sourceFilename = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--aot") == 0 && i + 1 < argc) {
+            parserUtil_setAotFilename(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--dump-cfg") == 0) {
+            parserUtil_setDumpCfg();
+        }
+        else if (strcmp(argv[i], "--no-opt") == 0) {
+            parserUtil_setNoOptimize();
+        }
+        else {
+            sourceFilename = argv[i];
+        }
+    }
+
+    if (sourceFilename) {
+        if (!(yyin = fopen(sourceFilename, "r"))) {
+            printf("Cannot read file: %s\n", sourceFilename);
             return 1;
         }
     }
@@ -3,6 +3,8 @@
 #include "../lc_stack/lc_stack.h"
 #include "../quad/quad.h"
 #include "../tcode/tcode.h"
+#include "../cfg/cfg.h"
+#include "../opt/opt.h"
 #include "parser_util.h"
 
 #include <string.h>
@@ -12,6 +14,7 @@
 
 static const char* libraryFunctions[] = {
     "print",
+    "flush",
     "input",
     "objectmemberkeys",
     "objecttotalmembers",
@@ -22,7 +25,16 @@ static const char* libraryFunctions[] = {
     "strtonum",
     "sqrt",
     "cos",
-    "sin"
+    "sin",
+    "coroutine",
+    "resume",
+    "yield",
+    "coroutinestatus",
+    "open",
+    "close",
+    "readline",
+    "read",
+    "write"
 };
 
 static const int NUM_LIBRARY_FUNCTIONS = sizeof(libraryFunctions) / sizeof(libraryFunctions[0]);
@@ -31,6 +43,10 @@ static unsigned int scope = 0;
 static unsigned int tempCounter = 0;
 static unsigned int funcCounter = 0;
 
+static char* aotFilename = NULL;
+static unsigned char dumpCfg = 0;
+static unsigned char optimize = 1;
+
 #define SCOPE_ENTER()   (scope++)
 #define SCOPE_EXIT()    (scope--)
 
@@ -73,6 +89,15 @@ member_item(Expr* lv, char* identifier, unsigned int line);
 Expr*
 make_call(Expr* lv, Expr* reversed_elist, unsigned int line);
 
+Expr*
+emit_ifjumping(Expr* e, unsigned int line);
+
+Expr*
+make_jumping(Expr* e, unsigned int line);
+
+unsigned char
+isJumping(Expr* e);
+
 Expr*
 assignToTableItem(Expr* lv, Expr* e, unsigned int line);
 
@@ -120,13 +145,41 @@ parserUtil_initialize() {
 
 void
 parserUtil_finalize() {
+    cfg_build();
+    if (optimize) {
+        opt_optimize();
+    }
+    if (dumpCfg) {
+        cfg_writeToFile("cfg.txt");
+    }
     tcode_generateInstructions();
     handlePrints();
     quad_writeQuadsToFile("quads.txt");
     tcode_createBinaryFile("binary_code.abc");
+    if (aotFilename) {
+        tcode_createCFile(aotFilename);
+    }
     handleCleanups();
 }
 
+// also translate the program to C, for an ahead-of-time compiled executable
+void
+parserUtil_setAotFilename(char* filename) {
+    aotFilename = filename;
+}
+
+// also write the control-flow graphs of the quads to cfg.txt
+void
+parserUtil_setDumpCfg() {
+    dumpCfg = 1;
+}
+
+// leave the quads as the parser emitted them
+void
+parserUtil_setNoOptimize() {
+    optimize = 0;
+}
+
 void
 parserUtil_handleBlockEntrance() {
     SCOPE_ENTER();
@@ -313,7 +366,7 @@ parserUtil_handleLvalueExprTableItem(Expr* lv, Expr* e, unsigned int line) {
     tableItem = icode_newExpr(tableitem_e);
     
     icode_setExprEntry(tableItem, icode_getExprEntry(lv));
-    icode_setExprIndex(tableItem, e);
+    icode_setExprIndex(tableItem, emit_ifjumping(e, line));
 
     return tableItem;
 }
@@ -338,6 +391,7 @@ parserUtil_handleAssignExpr(Expr* lv, Expr* e, unsigned int line) {
     Expr* assignExpr;
     
     reportLvalueFunction(lv, line);
+    e = emit_ifjumping(e, line);
 
     if (icode_getExprType(lv) == tableitem_e) {
         assignExpr = assignToTableItem(lv, e, line);
@@ -460,9 +514,10 @@ Expr*
 parserUtil_handleNotExpr(Expr* e, unsigned int line) {
     Expr* term;
 
+    e = make_jumping(e, line);
     term = icode_newExpr(boolexpr_e);
-    icode_setExprEntry(term, newTemp(line));
-    quad_emit(not_op, e, NULL, term, 0, line);
+    icode_setTrueList(term, icode_getFalseList(e));
+    icode_setFalseList(term, icode_getTrueList(e));
 
     return term;
 }
@@ -572,8 +627,8 @@ parserUtil_handleMakeElistTable(Expr* elist, unsigned int line) {
 }
 
 Indexed*
-parserUtil_newIndexed(Expr* key, Expr* value) {
-    return icode_newIndexedElem(key, value);
+parserUtil_newIndexed(Expr* key, Expr* value, unsigned int line) {
+    return icode_newIndexedElem(key, emit_ifjumping(value, line));
 }
 
 Indexed*
@@ -635,7 +690,7 @@ parserUtil_handleRelationalExpr(Expr* expr1, Expr* expr2, IOPCodeType op, unsign
 
     Expr* e;
 
-    if (icode_getExprType(expr1) == constnum_e && icode_getExprType(expr2)) {
+    if (icode_getExprType(expr1) == constnum_e && icode_getExprType(expr2) == constnum_e) {
         e = handleConstNumRelationalExpression(expr1, expr2, op, line);
     }
     else {
@@ -645,24 +700,46 @@ parserUtil_handleRelationalExpr(Expr* expr1, Expr* expr2, IOPCodeType op, unsign
     return e;
 }
 
+Expr*
+parserUtil_handleBooleanPrefix(Expr* expr1, IOPCodeType op, unsigned int line) {
+    expr1 = make_jumping(expr1, line);
+
+    // the second operand is only evaluated on the first operand's true exits for and, false exits for or
+    if (op == and_op) {
+        quad_patchList(icode_getTrueList(expr1), quad_nextQuadLabel());
+        icode_setTrueList(expr1, 0);
+    }
+    else {
+        quad_patchList(icode_getFalseList(expr1), quad_nextQuadLabel());
+        icode_setFalseList(expr1, 0);
+    }
+
+    return expr1;
+}
+
 Expr*
 parserUtil_handleBooleanExpr(Expr* expr1, Expr* expr2, IOPCodeType op, unsigned int line) {
     Expr* e;
 
+    expr2 = make_jumping(expr2, line);
     e = icode_newExpr(boolexpr_e);
-    icode_setExprEntry(e, newTemp(line));
-    quad_emit(op, expr1, expr2, e, 0, line);
+
+    icode_setTrueList(e, quad_mergeList(icode_getTrueList(expr1), icode_getTrueList(expr2)));
+    icode_setFalseList(e, quad_mergeList(icode_getFalseList(expr1), icode_getFalseList(expr2)));
     
     return e;
 }
 
+Expr*
+parserUtil_handleExprValue(Expr* e, unsigned int line) {
+    return emit_ifjumping(e, line);
+}
+
 unsigned int
 parserUtil_handleIfPrefix(Expr* expr, unsigned int line) {
-    unsigned int ifPrefix;
-    quad_emit(if_eq_op, expr, icode_newConstBoolean(1), NULL, quad_nextQuadLabel() + 2, line);
-    ifPrefix = quad_nextQuadLabel();
-    quad_emit(jump_op, NULL, NULL, NULL, 0, line);
-    return ifPrefix;
+    expr = make_jumping(expr, line);
+    quad_patchList(icode_getTrueList(expr), quad_nextQuadLabel());
+    return icode_getFalseList(expr);
 }
 
 unsigned int
@@ -683,7 +760,7 @@ parserUtil_handleIfElsePrefixStatement(unsigned int ifPrefix, Statement* stmt1,
     int breakList1 = 0, breakList2 = 0;
     int contList1 = 0, contList2 = 0;
 
-    quad_patchLabel(ifPrefix, elsePrefix+1);
+    quad_patchList(ifPrefix, elsePrefix+1);
     quad_patchLabel(elsePrefix, quad_nextQuadLabel());
 
     stmt = icode_newStatement();
@@ -711,7 +788,7 @@ parserUtil_handleIfElsePrefixStatement(unsigned int ifPrefix, Statement* stmt1,
 
 void
 parserUtil_handleIfPrefixStatement(unsigned int ifprefix) {
-    quad_patchLabel(ifprefix, quad_nextQuadLabel());
+    quad_patchList(ifprefix, quad_nextQuadLabel());
 }
 
 unsigned int
@@ -721,11 +798,9 @@ parserUtil_handleWhileStart() {
 
 unsigned int
 parserUtil_handleWhileCond(Expr* expr, unsigned int line) {
-    unsigned int whileCond;
-    quad_emit(if_eq_op, expr, icode_newConstBoolean(1), NULL, quad_nextQuadLabel()+2, line);
-    whileCond = quad_nextQuadLabel();
-    quad_emit(jump_op, NULL, NULL, NULL, 0, line);
-    return whileCond;
+    expr = make_jumping(expr, line);
+    quad_patchList(icode_getTrueList(expr), quad_nextQuadLabel());
+    return icode_getFalseList(expr);
 }
 
 void
@@ -734,7 +809,7 @@ parserUtil_handleWhileStatement(unsigned int whileStart, unsigned int whileCond,
     int breakList = 0;
 
     quad_emit(jump_op, NULL, NULL, NULL, whileStart, line);
-    quad_patchLabel(whileCond, quad_nextQuadLabel());
+    quad_patchList(whileCond, quad_nextQuadLabel());
 
     if (stmt != NULL) {
         contList = icode_getContList(stmt);
@@ -750,7 +825,8 @@ parserUtil_handleForStatement(ForPrefix* forPrefix, unsigned int N1, unsigned in
     int contList = 0;
     int breakList = 0;
 
-    quad_patchLabel(icode_getForPrefixEnter(forPrefix), N2 + 1);
+    quad_patchList(icode_getForPrefixEnter(forPrefix), N2 + 1);
+    quad_patchList(icode_getForPrefixExit(forPrefix), quad_nextQuadLabel());
     quad_patchLabel(N1, quad_nextQuadLabel());
     quad_patchLabel(N2, icode_getForPrefixTest(forPrefix));
     quad_patchLabel(N3, N1 + 1);
@@ -767,8 +843,8 @@ parserUtil_handleForStatement(ForPrefix* forPrefix, unsigned int N1, unsigned in
 ForPrefix*
 parserUtil_handleForPrefix(unsigned int M, Expr* expr, unsigned int line) {
     ForPrefix* forPrefix;
-    forPrefix = icode_newForPrefix(M, quad_nextQuadLabel());
-    quad_emit(if_eq_op, expr, icode_newConstBoolean(1), NULL, 0, line);
+    expr = make_jumping(expr, line);
+    forPrefix = icode_newForPrefix(M, icode_getTrueList(expr), icode_getFalseList(expr));
     return forPrefix;
 }
 
@@ -869,6 +945,9 @@ parserUtil_handleReturn(Expr* e, unsigned int line) {
         exit(1);
     }
 
+    if (e) {
+        e = emit_ifjumping(e, line);
+    }
     quad_emit(ret_op, NULL, NULL, e, 0, line);
 }
 
@@ -878,6 +957,16 @@ parserUtil_handleGeneralStatement() {
     return NULL;
 }
 
+void*
+parserUtil_handleExprStatement(Expr* e) {
+    // a condition whose value is not used just continues either way
+    if (isJumping(e)) {
+        quad_patchList(icode_getTrueList(e), quad_nextQuadLabel());
+        quad_patchList(icode_getFalseList(e), quad_nextQuadLabel());
+    }
+    return parserUtil_handleGeneralStatement();
+}
+
 void
 parserUtil_handleLoopStart() {
     lcStack_incrementLoopCounter();
@@ -1056,6 +1145,65 @@ member_item(Expr* lv, char* identifier, unsigned int line) {
     return tableItem;
 }
 
+Expr*
+emit_ifjumping(Expr* e, unsigned int line) {
+
+    if (!isJumping(e)) {
+        return e;
+    }
+
+    Expr* result;
+
+    result = icode_newExpr(boolexpr_e);
+    icode_setExprEntry(result, newTemp(line));
+
+    quad_patchList(icode_getTrueList(e), quad_nextQuadLabel());
+    quad_emit(assign_op, icode_newConstBoolean(1), NULL, result, 0, line);
+    quad_emit(jump_op, NULL, NULL, NULL, quad_nextQuadLabel() + 2, line);
+    quad_patchList(icode_getFalseList(e), quad_nextQuadLabel());
+    quad_emit(assign_op, icode_newConstBoolean(0), NULL, result, 0, line);
+
+    return result;
+}
+
+Expr*
+make_jumping(Expr* e, unsigned int line) {
+
+    if (isJumping(e)) {
+        return e;
+    }
+
+    Expr* jumping;
+    unsigned int nextQuad;
+
+    jumping = icode_newExpr(boolexpr_e);
+    nextQuad = quad_nextQuadLabel();
+
+    if (icode_getExprType(e) == constbool_e) {
+        if (icode_getBoolConst(e)) {
+            icode_setTrueList(jumping, quad_newList(nextQuad));
+        }
+        else {
+            icode_setFalseList(jumping, quad_newList(nextQuad));
+        }
+        quad_emit(jump_op, NULL, NULL, NULL, 0, line);
+    }
+    else {
+        icode_setTrueList(jumping, quad_newList(nextQuad));
+        quad_emit(if_eq_op, e, icode_newConstBoolean(1), NULL, 0, line);
+        icode_setFalseList(jumping, quad_newList(nextQuad + 1));
+        quad_emit(jump_op, NULL, NULL, NULL, 0, line);
+    }
+
+    return jumping;
+}
+
+// a boolean expression without a temp is still a set of jumps to patch
+unsigned char
+isJumping(Expr* e) {
+    return icode_getExprType(e) == boolexpr_e && !icode_getExprEntry(e);
+}
+
 Expr*
 assignToTableItem(Expr* lv, Expr* e, unsigned int line) {
     Expr* index;
@@ -1151,9 +1299,6 @@ handleConstNumRelationalExpression(Expr* e1, Expr* e2, IOPCodeType op, unsigned
             exit(1);
     }
 
-    icode_setExprEntry(e, newTemp(line));
-    quad_emit(op, e1, e2, e, 0, line);
-
     return e;
 }
 
@@ -1162,12 +1307,11 @@ handleRelationalExpression(Expr* e1, Expr* e2, IOPCodeType op, unsigned int line
     Expr* e;
 
     e = icode_newExpr(boolexpr_e);
-    icode_setExprEntry(e, newTemp(line));
 
-    quad_emit(op, e1, e2, NULL, quad_nextQuadLabel()+3, line);
-    quad_emit(assign_op, icode_newConstBoolean(0), NULL, e, 0, line);
-    quad_emit(jump_op, NULL, NULL, NULL, quad_nextQuadLabel()+2, line);
-    quad_emit(assign_op, icode_newConstBoolean(1), NULL, e, 0, line);
+    icode_setTrueList(e, quad_newList(quad_nextQuadLabel()));
+    quad_emit(op, e1, e2, NULL, 0, line);
+    icode_setFalseList(e, quad_newList(quad_nextQuadLabel()));
+    quad_emit(jump_op, NULL, NULL, NULL, 0, line);
 
     return e;
 }
@@ -1189,4 +1333,5 @@ handleCleanups() {
     scopeStack_cleanup();
     scopeSpace_cleanup();
     lcStack_cleanup();
+    cfg_destroy();
 }
\ No newline at end of file
@@ -10,6 +10,15 @@ parserUtil_initialize();
 void
 parserUtil_finalize();
 
+void
+parserUtil_setAotFilename(char* filename);
+
+void
+parserUtil_setDumpCfg();
+
+void
+parserUtil_setNoOptimize();
+
 void
 parserUtil_printSymbolTable();
 
@@ -113,7 +122,7 @@ Expr*
 parserUtil_handleMakeElistTable(Expr* elist, unsigned int line);
 
 Indexed*
-parserUtil_newIndexed(Expr* key, Expr* value);
+parserUtil_newIndexed(Expr* key, Expr* value, unsigned int line);
 
 Indexed*
 parserUtil_handleIndexed(Indexed* indexedList, Indexed* indexed);
@@ -127,9 +136,15 @@ parserUtil_handleArithmeticExpr(Expr* expr1, Expr* expr2, IOPCodeType op, unsign
 Expr*
 parserUtil_handleRelationalExpr(Expr* expr1, Expr* expr2, IOPCodeType op, unsigned int line);
 
+Expr*
+parserUtil_handleBooleanPrefix(Expr* expr1, IOPCodeType op, unsigned int line);
+
 Expr*
 parserUtil_handleBooleanExpr(Expr* expr1, Expr* expr2, IOPCodeType op, unsigned int line);
 
+Expr*
+parserUtil_handleExprValue(Expr* e, unsigned int line);
+
 unsigned int
 parserUtil_handleIfPrefix(Expr* expr, unsigned int line);
 
@@ -181,6 +196,9 @@ parserUtil_handleReturn(Expr* e, unsigned int line);
 void*
 parserUtil_handleGeneralStatement();
 
+void*
+parserUtil_handleExprStatement(Expr* e);
+
 void
 parserUtil_handleLoopStart();
 
@@ -13,6 +13,7 @@ typedef struct Quad {
     unsigned label;
     unsigned line;
     unsigned taddress;
+    unsigned char numeric;  // its operands hold numbers whenever it runs
 } Quad;
 
 Quad* quads = NULL;
@@ -65,6 +66,7 @@ quad_emit(IOPCodeType op, Expr* arg1, Expr* arg2, Expr* result, unsigned label,
     p->label = label;
     p->line = line;
     p->op = op;
+    p->numeric = 0;
 }
 
 void
@@ -151,18 +153,85 @@ quad_getTargetAddress(Quad* q) {
     return q->taddress;
 }
 
+unsigned char
+quad_isNumeric(Quad* q) {
+    assert(q);
+    return q->numeric;
+}
+
+void
+quad_setOpcode(Quad* q, IOPCodeType op) {
+    assert(q);
+    q->op = op;
+}
+
+void
+quad_setArg1(Quad* q, Expr* e) {
+    assert(q);
+    q->arg1 = e;
+}
+
+void
+quad_setArg2(Quad* q, Expr* e) {
+    assert(q);
+    q->arg2 = e;
+}
+
+void
+quad_setResult(Quad* q, Expr* e) {
+    assert(q);
+    q->result = e;
+}
+
 void
 quad_setTargetAddress(Quad* q, unsigned taddress) {
     assert(q);
     q->taddress = taddress;
 }
 
+void
+quad_setNumeric(Quad* q, unsigned char numeric) {
+    assert(q);
+    q->numeric = numeric;
+}
+
 void
 quad_patchLabel(unsigned quadNo, unsigned label) {
     assert(quadNo < currQuad);
     quads[quadNo].label = label;
 }
 
+void
+quad_reorder(unsigned* order) {
+    unsigned* newIndex = malloc(sizeof(unsigned) * (currQuad + 1));
+    Quad* reordered = malloc(sizeof(Quad) * (total ? total : 1));
+
+    if (!newIndex || !reordered) {
+        printf("Error allocating memory to reorder quads.\n");
+        exit(1);
+    }
+
+    assert(order[0] == 0);
+    for (unsigned i = 0; i < currQuad; i++) {
+        newIndex[order[i]] = i;
+        reordered[i] = quads[order[i]];
+    }
+    // a label past the last quad is the end of the program
+    newIndex[currQuad] = currQuad;
+
+    for (unsigned i = 1; i < currQuad; i++) {
+        IOPCodeType op = reordered[i].op;
+        if (op == jump_op || (op >= if_eq_op && op <= if_lesseq_op)) {
+            assert(reordered[i].label <= currQuad);
+            reordered[i].label = newIndex[reordered[i].label];
+        }
+    }
+
+    free(quads);
+    free(newIndex);
+    quads = reordered;
+}
+
 int
 quad_newList(int i) {
     quads[i].label = 0;
@@ -263,6 +332,7 @@ opcode_to_string(IOPCodeType op) {
         case tablegetelem_op:   return "tablegetelem";
         case tablesetelem_op:   return "tablesetelem";
         case jump_op:           return "jump";
+        case nop_op:            return "nop";
         default:                return "unknown";
     }
 }
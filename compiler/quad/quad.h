@@ -48,12 +48,35 @@ quad_getLabel(Quad* q);
 unsigned
 quad_getTargetAddress(Quad* q);
 
+// whether the operands of an arithmetic or relational quad are known to hold numbers whenever it runs
+unsigned char
+quad_isNumeric(Quad* q);
+
+void
+quad_setOpcode(Quad* q, IOPCodeType op);
+
+void
+quad_setArg1(Quad* q, Expr* e);
+
+void
+quad_setArg2(Quad* q, Expr* e);
+
+void
+quad_setResult(Quad* q, Expr* e);
+
 void
 quad_setTargetAddress(Quad* q, unsigned taddress);
 
+void
+quad_setNumeric(Quad* q, unsigned char numeric);
+
 void
 quad_patchLabel(unsigned quadNo, unsigned label);
 
+// moves quad order[i] to position i, order[0] being 0, and renumbers the labels to match
+void
+quad_reorder(unsigned* order);
+
 int
 quad_newList(int i);
 
@@ -214,6 +214,17 @@ symtab_getVariableOffset(SymbolTableEntry* entry) {
     }
 }
 
+void
+symtab_setVariableOffset(SymbolTableEntry* entry, unsigned offset) {
+    if (isVariableSymbol(entry->type)) {
+        entry->value.varValue->offset = offset;
+    }
+    else {
+        printf("Cannot set offset to function symbol.\n");
+        exit(1);
+    }
+}
+
 unsigned int
 symtab_getFunctionAddress(SymbolTableEntry* entry) {
     if (isFunctionSymbol(entry->type)) {
@@ -47,6 +47,9 @@ symtab_getEntryType(SymbolTableEntry* entry);
 unsigned
 symtab_getVariableOffset(SymbolTableEntry* entry);
 
+void
+symtab_setVariableOffset(SymbolTableEntry* entry, unsigned offset);
+
 ScopeSpaceType
 symtab_getVariableSpace(SymbolTableEntry* entry);
 
@@ -3,6 +3,7 @@
 #include "../func_stack/func_stack.h"
 #include "../parser_util/parser_util.h"
 #include "../quad/quad.h"
+#include "../../common/dtoa/dtoa.h"
 
 #include "tcode.h"
 
@@ -10,6 +11,9 @@
 #include <stdlib.h>
 #include <assert.h>
 #include <string.h>
+#include <limits.h>
+#include <math.h>
+#include <ctype.h>
 
 typedef struct vmarg {
     vmarg_t type;
@@ -159,12 +163,18 @@ generate_RETURN(Quad* q);
 static void
 generate_FUNCEND(Quad* q);
 
+static void
+generate_NOP(Quad* q);
+
 static void
 make_operand(Expr* e, vmarg* arg);
 
 static void
 make_numberOperand(vmarg* arg, double val);
 
+static unsigned char
+is_immnumber(double val);
+
 static void
 make_boolOperand(vmarg* arg, unsigned val);
 
@@ -192,6 +202,9 @@ write_instructions(FILE* out);
 static const char*
 vmopcode_to_string(vmopcode op);
 
+static vmopcode
+generic_opcode(vmopcode op);
+
 static char*
 vmarg_to_string(vmarg arg);
 
@@ -231,6 +244,30 @@ writeCode(FILE* file);
 static void
 writeTotalGlobals(FILE* file);
 
+static void
+writeBinary(FILE* file);
+
+static void
+aot_writeImage(FILE* file);
+
+static void
+aot_writeFunction(FILE* file, unsigned owner, unsigned* owners, unsigned char* targets);
+
+static void
+aot_writeInstruction(FILE* file, unsigned i, unsigned owner, unsigned* owners);
+
+static void
+aot_writeJump(FILE* file, unsigned target, unsigned owner, unsigned* owners);
+
+static void
+aot_writeExecutor(FILE* file, const char* executor, unsigned i);
+
+static unsigned char
+aot_memoryOperand(vmarg* arg, char* cell);
+
+static unsigned char
+aot_numberOperand(vmarg* arg, char* test, char* value);
+
 generator_func_t generators[] = {
     generate_ADD,
     generate_SUB,
@@ -257,7 +294,8 @@ generator_func_t generators[] = {
     generate_GETRETVAL,
     generate_FUNCSTART,
     generate_RETURN,
-    generate_FUNCEND
+    generate_FUNCEND,
+    generate_NOP
 };
 
 /* ------------------------------------------ Implementation ------------------------------------------ */
@@ -323,9 +361,11 @@ tcode_printStringConsts() {
 
 void
 tcode_printNumConsts() {
+    char num[DTOA_BUFFER_SIZE];
     printf("Num consts:\n");
     for (int i =0; i < totalNumConsts; i++) {
-        printf("%d: %f\n", i, numConsts[i]);
+        dtoa_format(num, numConsts[i]);
+        printf("%d: %s\n", i, num);
     }
     printf("\n");
 }
@@ -341,11 +381,98 @@ tcode_createBinaryFile(char* filename) {
         exit(1);
     }
 
-    writeMagicNumber(file);
-    writeArrays(file);
-    writeCode(file);
-    writeTotalGlobals(file);
+    writeBinary(file);
+
+    fclose(file);
+}
+
+/*
+ * Ahead-of-time translation of the target code to C. Every user function
+ * becomes a C function, excluding the functions nested in it, and the
+ * top-level code becomes aot_main. Jumps are gotos to labels on their
+ * targets, arithmetic, assignments and comparisons of numbers get an
+ * inline fast path, and everything else calls the avm's executors on the
+ * loaded instruction. The binary is embedded in the C file, as the avm
+ * still needs its constants and instruction operands.
+ *
+ * The result is linked with the avm's runtime library:
+ *     gcc -O2 -I avm/aot program.c avm/libavmrt.a -lm -o program
+ */
+void
+tcode_createCFile(char* filename) {
+    FILE* file;
+    unsigned* owners;
+    unsigned char* targets;
+    unsigned topLevel = currInstruction;
+    unsigned enclosing[USR_FUNCS_SIZE];
+    unsigned funcDepth = 0;
+
+    file = fopen(filename, "w");
+
+    if (!file) {
+        printf("Error opening file to write the C translation.\n");
+        exit(1);
+    }
+
+    owners = malloc(sizeof(unsigned) * (currInstruction + 1));
+    targets = calloc(currInstruction + 1, sizeof(unsigned char));
+
+    if (!owners || !targets) {
+        printf("Error allocating memory for the C translation.\n");
+        exit(1);
+    }
+
+    // the owner of an instruction is the funcenter of the innermost function around it
+    for (unsigned i = 0; i < currInstruction; i++) {
+        instruction* instr = instructions + i;
+        vmopcode op = generic_opcode(instr->opcode);
+
+        if (instr->opcode == funcenter_v) {
+            assert(funcDepth < USR_FUNCS_SIZE);
+            enclosing[funcDepth++] = i;
+        }
+
+        owners[i] = funcDepth ? enclosing[funcDepth - 1] : topLevel;
+
+        if (instr->opcode == funcexit_v) {
+            assert(funcDepth);
+            funcDepth--;
+        }
+        else if (op == jump_v || (op >= jeq_v && op <= jgt_v)) {
+            targets[instr->result.val] = 1;
+        }
+    }
+    owners[currInstruction] = topLevel;
+
+    fprintf(file, "/* Generated by acc --aot. */\n\n");
+    fprintf(file, "#include \"aot_runtime.h\"\n\n");
+
+    aot_writeImage(file);
+
+    for (unsigned i = 0; i < currInstruction; i++) {
+        if (instructions[i].opcode == funcenter_v) {
+            fprintf(file, "static void\naot_func%u(avm_vm* vm);\n\n", i);
+        }
+    }
+
+    fprintf(file, "void\naot_registerfunctions(aot_function* functions) {\n");
+    for (unsigned i = 0; i < currInstruction; i++) {
+        if (instructions[i].opcode == funcenter_v) {
+            fprintf(file, "    functions[%u] = aot_func%u;\n", i, i);
+        }
+    }
+    fprintf(file, "}\n\n");
+
+    aot_writeFunction(file, topLevel, owners, targets);
 
+    for (unsigned i = 0; i < currInstruction; i++) {
+        if (instructions[i].opcode == funcenter_v) {
+            aot_writeFunction(file, i, owners, targets);
+        }
+    }
+
+    free(owners);
+    free(targets);
     fclose(file);
 }
 
@@ -436,8 +563,30 @@ generate_relational(vmopcode op, Quad* quad) {
 
 static void
 make_numberOperand(vmarg* arg, double val) {
-    arg->val = consts_newnumber(val);
-    arg->type = number_a;
+    if (is_immnumber(val)) {
+        arg->val = (unsigned) (int) val;
+        arg->type = immnumber_a;
+    }
+    else {
+        arg->val = consts_newnumber(val);
+        arg->type = number_a;
+    }
+}
+
+/*
+ * Integral numbers that fit in a signed int are stored directly in the
+ * operand field, so the vm never has to index the number consts for them.
+ * Negative zero is excluded because (int) -0.0 loses the sign.
+ */
+static unsigned char
+is_immnumber(double val) {
+    if (!(val >= INT_MIN && val <= INT_MAX)) {
+        return 0;
+    }
+    if (val == 0 && signbit(val)) {
+        return 0;
+    }
+    return val == (double) (int) val;
 }
 
 static void
@@ -458,11 +607,12 @@ reset_operand(vmarg* arg) {
     arg->val = 0;
 }
 
-static void generate_ADD(Quad* q) { generate(add_v, q); }
-static void generate_SUB(Quad* q) { generate(sub_v, q); }
-static void generate_MUL(Quad* q) { generate(mul_v, q); }
-static void generate_DIV(Quad* q) { generate(div_v, q); }
-static void generate_MOD(Quad* q) { generate(mod_v, q); }
+// quads whose operands type inference proved to be numbers get the opcodes specialized for them
+static void generate_ADD(Quad* q) { generate(quad_isNumeric(q) ? add_nn_v : add_v, q); }
+static void generate_SUB(Quad* q) { generate(quad_isNumeric(q) ? sub_nn_v : sub_v, q); }
+static void generate_MUL(Quad* q) { generate(quad_isNumeric(q) ? mul_nn_v : mul_v, q); }
+static void generate_DIV(Quad* q) { generate(quad_isNumeric(q) ? div_nn_v : div_v, q); }
+static void generate_MOD(Quad* q) { generate(quad_isNumeric(q) ? mod_nn_v : mod_v, q); }
 
 static void generate_ASSIGN(Quad* q)        { generate(assign_v, q); } 
 static void generate_NEWTABLE(Quad* q)      { generate(newtable_v, q); }
@@ -470,12 +620,12 @@ static void generate_TABLEGETELEM(Quad* q)  { generate(tablegetelem_v, q); }
 static void generate_TABLESETELEM(Quad* q)  { generate(tablesetelem_v, q); }
 
 static void generate_JUMP(Quad* q)          { generate_relational(jump_v, q); }
-static void generate_IF_EQ(Quad* q)         { generate_relational(jeq_v, q); }
-static void generate_IF_NOTEQ(Quad* q)      { generate_relational(jne_v, q); }
-static void generate_IF_GREATER(Quad* q)    { generate_relational(jgt_v, q); }
-static void generate_IF_GREATEREQ(Quad* q)  { generate_relational(jge_v, q); }
-static void generate_IF_LESS(Quad* q)       { generate_relational(jlt_v, q); }
-static void generate_IF_LESSEQ(Quad* q)     { generate_relational(jle_v, q); }
+static void generate_IF_EQ(Quad* q)         { generate_relational(quad_isNumeric(q) ? jeq_nn_v : jeq_v, q); }
+static void generate_IF_NOTEQ(Quad* q)      { generate_relational(quad_isNumeric(q) ? jne_nn_v : jne_v, q); }
+static void generate_IF_GREATER(Quad* q)    { generate_relational(quad_isNumeric(q) ? jgt_nn_v : jgt_v, q); }
+static void generate_IF_GREATEREQ(Quad* q)  { generate_relational(quad_isNumeric(q) ? jge_nn_v : jge_v, q); }
+static void generate_IF_LESS(Quad* q)       { generate_relational(quad_isNumeric(q) ? jlt_nn_v : jlt_v, q); }
+static void generate_IF_LESSEQ(Quad* q)     { generate_relational(quad_isNumeric(q) ? jle_nn_v : jle_v, q); }
 
 static void
 generate_NOT(Quad* q) {
@@ -751,6 +901,12 @@ generate_FUNCEND(Quad* q) {
     funcStack_freeRetList(rlist);
 }
 
+// jumps to a removed quad land on what follows it
+static void
+generate_NOP(Quad* q) {
+    quad_setTargetAddress(q, currInstruction);
+}
+
 static void
 generate_UMINUS(Quad* quad) {
 
@@ -761,7 +917,7 @@ generate_UMINUS(Quad* quad) {
     arg1 = quad_getArg1(quad);
     result = quad_getResult(quad);
 
-    instr.opcode = mul_v;
+    instr.opcode = quad_isNumeric(quad) ? mul_nn_v : mul_v;
     instr.srcLine = quad_getLine(quad);
 
     make_operand(arg1, &instr.arg1);
@@ -823,9 +979,7 @@ make_operand(Expr* e, vmarg* arg) {
             break;
         }
         case constnum_e: {
-            double n = icode_getNumConst(e);
-            arg->val = consts_newnumber(n);
-            arg->type = number_a;
+            make_numberOperand(arg, icode_getNumConst(e));
             break;
         }
         case nil_e: {
@@ -981,7 +1135,12 @@ vmarg_to_string(vmarg arg) {
         exit(1);
     }
 
-    snprintf(result, 64, "[%s, %u]", type_str, arg.val);
+    if (arg.type == immnumber_a) {
+        snprintf(result, 64, "[%s, %d]", type_str, (int) arg.val);
+    }
+    else {
+        snprintf(result, 64, "[%s, %u]", type_str, arg.val);
+    }
     return result;
 }
 
@@ -1075,10 +1234,42 @@ vmopcode_to_string(vmopcode op) {
         case tablegetelem_v: return "tablegetelem_v";
         case tablesetelem_v: return "tablesetelem_v";
         case nop_v:          return "nop_v";
+        case add_nn_v:       return "add_nn_v";
+        case sub_nn_v:       return "sub_nn_v";
+        case mul_nn_v:       return "mul_nn_v";
+        case div_nn_v:       return "div_nn_v";
+        case mod_nn_v:       return "mod_nn_v";
+        case jle_nn_v:       return "jle_nn_v";
+        case jge_nn_v:       return "jge_nn_v";
+        case jlt_nn_v:       return "jlt_nn_v";
+        case jgt_nn_v:       return "jgt_nn_v";
+        case jeq_nn_v:       return "jeq_nn_v";
+        case jne_nn_v:       return "jne_nn_v";
         default:             return "UNKNOWN_OPCODE";
     }
 }
 
+// the opcode a specialized one does the work of for any operands
+static vmopcode
+generic_opcode(vmopcode op) {
+    switch (op) {
+        case add_nn_v:  return add_v;
+        case sub_nn_v:  return sub_v;
+        case mul_nn_v:  return mul_v;
+        case div_nn_v:  return div_v;
+        case mod_nn_v:  return mod_v;
+        case jle_nn_v:  return jle_v;
+        case jge_nn_v:  return jge_v;
+        case jlt_nn_v:  return jlt_v;
+        case jgt_nn_v:  return jgt_v;
+        case jeq_nn_v:
+        case jeq_ss_v:  return jeq_v;
+        case jne_nn_v:
+        case jne_ss_v:  return jne_v;
+        default:        return op;
+    }
+}
+
 static const char*
 vmarg_type_to_string(vmarg_t type) {
     switch (type) {
@@ -1093,6 +1284,7 @@ vmarg_type_to_string(vmarg_t type) {
         case userfunc_a:   return "userfunc";
         case libfunc_a:    return "libfunc";
         case retval_a:     return "retval";
+        case immnumber_a:  return "immnumber";
         case notype_a:     return "";
         default:           return "unknown";
     }
@@ -1125,11 +1317,12 @@ writeStringArray(FILE* file) {
 
 static void
 writeNumberArray(FILE* file) {
-    double num;
+    // shortest round trip, the avm reads back the exact constants
+    char num[DTOA_BUFFER_SIZE];
     fprintf(file, "%d ", totalNumConsts);
     for (int i = 0; i < totalNumConsts; i++) {
-        num = numConsts[i];
-        fprintf(file, "%f ", num);
+        dtoa_format(num, numConsts[i]);
+        fprintf(file, "%s ", num);
     }
     fprintf(file, "\n");
 }
@@ -1186,4 +1379,273 @@ writeTotalGlobals(FILE* file) {
     unsigned int total;
     total = parserUtil_getTotalGlobals();
     fprintf(file, "%u", total);
-}
\ No newline at end of file
+}
+
+static void
+writeBinary(FILE* file) {
+    writeMagicNumber(file);
+    writeArrays(file);
+    writeCode(file);
+    writeTotalGlobals(file);
+}
+
+// the binary as a string literal, escaping anything that is not printable
+static void
+aot_writeImage(FILE* file) {
+    char* image;
+    size_t size;
+    FILE* stream = open_memstream(&image, &size);
+
+    if (!stream) {
+        printf("Error writing the binary to memory.\n");
+        exit(1);
+    }
+
+    writeBinary(stream);
+    fclose(stream);
+
+    fprintf(file, "const char aotImage[] =\n    \"");
+    for (size_t i = 0; i < size; i++) {
+        unsigned char c = image[i];
+        if (c == '\n') {
+            fprintf(file, "\\n\"\n    \"");
+        }
+        else if (c == '"' || c == '\\' || c == '?') {
+            fprintf(file, "\\%c", c);
+        }
+        else if (isprint(c)) {
+            fputc(c, file);
+        }
+        else {
+            fprintf(file, "\\%03o", c);
+        }
+    }
+    fprintf(file, "\";\n\n");
+    fprintf(file, "const unsigned aotImageSize = sizeof(aotImage) - 1;\n\n");
+
+    free(image);
+}
+
+static void
+aot_writeFunction(FILE* file, unsigned owner, unsigned* owners, unsigned char* targets) {
+    if (owner == currInstruction) {
+        fprintf(file, "void\naot_main(avm_vm* vm) {\n");
+    }
+    else {
+        fprintf(file, "static void\naot_func%u(avm_vm* vm) {\n", owner);
+    }
+
+    for (unsigned i = 0; i < currInstruction; i++) {
+        if (owners[i] != owner) {
+            continue;
+        }
+        if (targets[i]) {
+            fprintf(file, "L%u:\n", i);
+        }
+        aot_writeInstruction(file, i, owner, owners);
+    }
+
+    fprintf(file, "}\n\n");
+}
+
+static void
+aot_writeInstruction(FILE* file, unsigned i, unsigned owner, unsigned* owners) {
+    instruction* instr = instructions + i;
+    char lv[64], rv[64], test1[64], value1[64], test2[64], value2[64];
+    vmopcode op = generic_opcode(instr->opcode);
+    unsigned char numbers = aot_numberOperand(&instr->arg1, test1, value1) &&
+                            aot_numberOperand(&instr->arg2, test2, value2);
+
+    // operands of a specialized opcode are numbers, so their fast path needs no test
+    if (numbers && op != instr->opcode) {
+        sprintf(test1, "1");
+        sprintf(test2, "1");
+    }
+
+    fprintf(file, "    // %u: %s\n", i, vmopcode_to_string(instr->opcode));
+
+    switch (op) {
+        case add_v:
+        case sub_v:
+        case mul_v:
+        case div_v: {
+            static const char* operators[] = { "+", "-", "*", "/" };
+            if (!numbers || !aot_memoryOperand(&instr->result, lv)) {
+                aot_writeExecutor(file, "execute_arithmetic", i);
+                break;
+            }
+            fprintf(file, "    if (%s && %s && AOT_ISPLAIN(%s)) {\n", test1, test2, lv);
+            fprintf(file, "        AOT_SETNUMBER(%s, %s %s %s);\n", lv, value1, operators[op - add_v], value2);
+            fprintf(file, "    }\n    else {\n    ");
+            aot_writeExecutor(file, "execute_arithmetic", i);
+            fprintf(file, "    }\n");
+            break;
+        }
+        case mod_v: {
+            aot_writeExecutor(file, "execute_arithmetic", i);
+            break;
+        }
+        case assign_v: {
+            if (!aot_memoryOperand(&instr->result, lv)) {
+                aot_writeExecutor(file, "execute_assign", i);
+                break;
+            }
+            if (aot_memoryOperand(&instr->arg1, rv)) {
+                fprintf(file, "    if (AOT_ISCOPYABLE(%s) && AOT_ISPLAIN(%s)) {\n", rv, lv);
+                fprintf(file, "        *%s = *%s;\n", lv, rv);
+            }
+            else if (aot_numberOperand(&instr->arg1, test1, value1)) {
+                fprintf(file, "    if (AOT_ISPLAIN(%s)) {\n", lv);
+                fprintf(file, "        AOT_SETNUMBER(%s, %s);\n", lv, value1);
+            }
+            else if (instr->arg1.type == bool_a) {
+                fprintf(file, "    if (AOT_ISPLAIN(%s)) {\n", lv);
+                fprintf(file, "        AOT_SETBOOL(%s, %u);\n", lv, instr->arg1.val != 0);
+            }
+            else if (instr->arg1.type == nil_a) {
+                fprintf(file, "    if (AOT_ISPLAIN(%s)) {\n", lv);
+                fprintf(file, "        AOT_SETNIL(%s);\n", lv);
+            }
+            else {
+                aot_writeExecutor(file, "execute_assign", i);
+                break;
+            }
+            fprintf(file, "    }\n    else {\n    ");
+            aot_writeExecutor(file, "execute_assign", i);
+            fprintf(file, "    }\n");
+            break;
+        }
+        case jump_v: {
+            aot_writeJump(file, instr->result.val, owner, owners);
+            break;
+        }
+        case jeq_v:
+        case jne_v: {
+            const char* negate = op == jne_v ? "!" : "";
+            if (numbers) {
+                fprintf(file, "    if ((%s && %s) ? (%s %s %s) : %sequal_eval(vm, AOT_CODE(%u))) {\n",
+                    test1, test2, value1, op == jne_v ? "!=" : "==", value2, negate, i);
+            }
+            else if (instr->arg2.type == bool_a && aot_memoryOperand(&instr->arg1, rv)) {
+                fprintf(file, "    if ((%s->type == bool_m) ? ((%s->data.boolVal != 0) %s %u) : %sequal_eval(vm, AOT_CODE(%u))) {\n",
+                    rv, rv, op == jne_v ? "!=" : "==", instr->arg2.val != 0, negate, i);
+            }
+            else {
+                fprintf(file, "    if (%sequal_eval(vm, AOT_CODE(%u))) {\n", negate, i);
+            }
+            fprintf(file, "    ");
+            aot_writeJump(file, instr->result.val, owner, owners);
+            fprintf(file, "    }\n");
+            break;
+        }
+        case jle_v:
+        case jge_v:
+        case jlt_v:
+        case jgt_v: {
+            static const char* operators[] = { "<=", ">=", "<", ">" };
+            if (numbers) {
+                fprintf(file, "    if ((%s && %s) ? (%s %s %s) : relational_eval(vm, AOT_CODE(%u), AOT_CODE(%u)->origOpcode)) {\n",
+                    test1, test2, value1, operators[op - jle_v], value2, i, i);
+            }
+            else {
+                fprintf(file, "    if (relational_eval(vm, AOT_CODE(%u), AOT_CODE(%u)->origOpcode)) {\n", i, i);
+            }
+            fprintf(file, "    ");
+            aot_writeJump(file, instr->result.val, owner, owners);
+            fprintf(file, "    }\n");
+            break;
+        }
+        case call_v: {
+            fprintf(file, "    AOT_CALL(%u)\n", i);
+            break;
+        }
+        case pusharg_v: {
+            aot_writeExecutor(file, "execute_pusharg", i);
+            break;
+        }
+        case funcenter_v: {
+            aot_writeExecutor(file, "execute_funcenter", i);
+            break;
+        }
+        case funcexit_v: {
+            aot_writeExecutor(file, "execute_funcexit", i);
+            fprintf(file, "    return;\n");
+            break;
+        }
+        case newtable_v: {
+            aot_writeExecutor(file, "execute_newtable", i);
+            break;
+        }
+        case tablegetelem_v: {
+            aot_writeExecutor(file, "execute_tablegetelem", i);
+            break;
+        }
+        case tablesetelem_v: {
+            aot_writeExecutor(file, "execute_tablesetelem", i);
+            break;
+        }
+        default: {
+            // the avm does nothing for these either
+            fprintf(file, "    ;\n");
+            break;
+        }
+    }
+}
+
+// a jump past the end of the code ends the program
+static void
+aot_writeJump(FILE* file, unsigned target, unsigned owner, unsigned* owners) {
+    if (target == currInstruction) {
+        fprintf(file, "    return;\n");
+    }
+    else {
+        assert(owners[target] == owner);
+        fprintf(file, "    goto L%u;\n", target);
+    }
+}
+
+static void
+aot_writeExecutor(FILE* file, const char* executor, unsigned i) {
+    fprintf(file, "    %s(vm, AOT_CODE(%u));\n", executor, i);
+}
+
+static unsigned char
+aot_memoryOperand(vmarg* arg, char* cell) {
+    switch (arg->type) {
+        case global_a: sprintf(cell, "AOT_GLOBAL(%u)", arg->val); return 1;
+        case local_a:  sprintf(cell, "AOT_LOCAL(%u)", arg->val);  return 1;
+        case formal_a: sprintf(cell, "AOT_FORMAL(%u)", arg->val); return 1;
+        case retval_a: sprintf(cell, "AOT_RETVAL");               return 1;
+        default:       return 0;
+    }
+}
+
+/*
+ * A test that the operand is a number and an expression of its value.
+ * Constants are printed as the binary has them, so that the avm and the
+ * translation agree on their value.
+ */
+static unsigned char
+aot_numberOperand(vmarg* arg, char* test, char* value) {
+    char cell[64];
+
+    if (aot_memoryOperand(arg, cell)) {
+        sprintf(test, "AOT_ISNUMBER(%s)", cell);
+        sprintf(value, "%s->data.numVal", cell);
+        return 1;
+    }
+    else if (arg->type == number_a) {
+        char num[DTOA_BUFFER_SIZE];
+        dtoa_format(num, numConsts[arg->val]);
+        sprintf(test, "1");
+        // a double literal even for integers, so that constant operands divide as doubles
+        sprintf(value, strpbrk(num, ".en") ? "(%s)" : "(%s.0)", num);
+        return 1;
+    }
+    else if (arg->type == immnumber_a) {
+        sprintf(test, "1");
+        sprintf(value, "((double) %d)", (int) arg->val);
+        return 1;
+    }
+    return 0;
+}
@@ -13,6 +13,18 @@ typedef enum {
     jgt_v,          call_v,         pusharg_v,
     funcenter_v,    funcexit_v,     newtable_v,
     tablegetelem_v, tablesetelem_v, nop_v,
+
+    // superinstructions, only created by the avm's load-time fusion pass
+    arithassign_v,  assignarith_v,  assignassign_v,
+    assignjump_v,   jcondjump_v,    pushargcall_v,
+    tablegetelemcall_v,
+
+    // specialized for operands known to be numbers (_nn) or strings (_ss)
+    add_nn_v,       sub_nn_v,       mul_nn_v,
+    div_nn_v,       mod_nn_v,       jle_nn_v,
+    jge_nn_v,       jlt_nn_v,       jgt_nn_v,
+    jeq_nn_v,       jne_nn_v,       jeq_ss_v,
+    jne_ss_v,
 } vmopcode;
 
 typedef enum {
@@ -27,6 +39,7 @@ typedef enum {
     userfunc_a,
     libfunc_a,
     retval_a,
+    immnumber_a,
     notype_a,
 } vmarg_t;
 
@@ -61,4 +74,7 @@ tcode_printNumConsts();
 void
 tcode_createBinaryFile(char* filename);
 
+void
+tcode_createCFile(char* filename);
+
 #endif
\ No newline at end of file